@@ -0,0 +1,129 @@
+#include "backends/fake/AllocatorTraceReplay.h"
+
+#include <chrono>
+#include <cstdlib>
+
+#include <c10/util/Exception.h>
+#include <c10/util/flat_hash_map.h>
+
+namespace c10::backend::fake {
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+using CachingAllocator::TraceEntry;
+using CachingAllocator::TraceRecord;
+
+constexpr size_t kAggregate =
+    static_cast<size_t>(CachingAllocator::StatType::AGGREGATE);
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedNs(Clock::time_point begin) {
+  return std::chrono::duration<double, std::nano>(Clock::now() - begin)
+      .count();
+}
+
+} // namespace
+
+ReplayResult replayTrace(
+    HostCachingAllocatorHelper& helper,
+    const std::vector<TraceRecord>& trace,
+    const ReplayOptions& options) {
+  int device_count = helper.deviceCount();
+  CachingAllocator::registerHelper(&helper);
+  CachingAllocator::init(device_count);
+  CachingAllocator::emptyCache();
+  CachingAllocator::setAllocatorSettings(options.settings);
+  for (c10::DeviceIndex device = 0; device < device_count; device++) {
+    if (options.memory_fraction.has_value()) {
+      CachingAllocator::setMemoryFraction(*options.memory_fraction, device);
+    }
+    CachingAllocator::resetAccumulatedStats(device);
+    CachingAllocator::resetPeakStats(device);
+  }
+
+  // Trace addresses of live blocks and their replayed pointers, per device.
+  std::vector<ska::flat_hash_map<int64_t, void*>> live(device_count);
+  std::vector<HostStream*> streams;
+  std::vector<int64_t> ooms(device_count, 0);
+  ReplayResult result;
+  auto begin = Clock::now();
+
+  for (size_t i = 0; i < trace.size(); i++) {
+    const TraceRecord& record = trace[i];
+    if (record.action != TraceEntry::ALLOC &&
+        record.action != TraceEntry::FREE_REQUESTED) {
+      continue;
+    }
+    c10::DeviceIndex device = record.device;
+    TORCH_CHECK(
+        0 <= device && device < device_count,
+        "Trace record ",
+        i,
+        " is on device ",
+        static_cast<int>(device),
+        ", but the helper has ",
+        device_count,
+        " devices");
+    auto& blocks = live[device];
+
+    if (record.action == TraceEntry::FREE_REQUESTED) {
+      auto it = blocks.find(record.addr);
+      if (it == blocks.end()) {
+        continue;
+      }
+      auto start = Clock::now();
+      CachingAllocator::raw_delete(it->second);
+      result.free_ns += elapsedNs(start);
+      result.frees++;
+      blocks.erase(it);
+      continue;
+    }
+
+    if (record.stream >= streams.size()) {
+      streams.resize(record.stream + 1, nullptr);
+    }
+    if (streams[record.stream] == nullptr) {
+      streams[record.stream] = helper.createStream(device);
+    }
+    helper.setDevice(device);
+    auto start = Clock::now();
+    try {
+      void* ptr = CachingAllocator::raw_alloc_with_stream(
+          record.size, streams[record.stream]);
+      result.alloc_ns += elapsedNs(start);
+      result.allocs++;
+      blocks[record.addr] = ptr;
+    } catch (const c10::Error&) {
+      auto stats = CachingAllocator::getDeviceStats(device);
+      if (stats.num_ooms == ooms[device]) {
+        throw;
+      }
+      ooms[device] = stats.num_ooms;
+      result.ooms.push_back(
+          {i,
+           device,
+           record.size,
+           stats.allocated_bytes[kAggregate].current,
+           stats.reserved_bytes[kAggregate].current});
+    }
+  }
+  result.elapsed_ms = elapsedNs(begin) / 1e6;
+
+  for (c10::DeviceIndex device = 0; device < device_count; device++) {
+    auto stats = CachingAllocator::getDeviceStats(device);
+    result.segment_allocs += stats.segment[kAggregate].allocated;
+    result.peak_allocated_bytes += stats.allocated_bytes[kAggregate].peak;
+    result.peak_reserved_bytes += stats.reserved_bytes[kAggregate].peak;
+    for (const auto& block : live[device]) {
+      CachingAllocator::raw_delete(block.second);
+    }
+  }
+  CachingAllocator::emptyCache();
+  const char* env = getenv("PYTORCH_ALLOC_CONF");
+  CachingAllocator::setAllocatorSettings(env != nullptr ? env : "");
+  return result;
+}
+
+} // namespace c10::backend::fake
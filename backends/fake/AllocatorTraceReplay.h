@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <c10/util/Optional.h>
+#include "backends/fake/HostCachingAllocatorHelper.h"
+#include "csrc/core/allocator/AllocatorTrace.h"
+
+namespace c10::backend::fake {
+
+struct ReplayOptions {
+  // PYTORCH_ALLOC_CONF style settings of the run, empty for the defaults.
+  std::string settings;
+  // Fraction of the helper's device memory the allocator may use, as set by
+  // set_per_process_memory_fraction. garbage_collection_threshold only takes
+  // effect once a fraction is set. The fraction stays set after the replay.
+  c10::optional<double> memory_fraction;
+};
+
+// An allocation of the trace that failed during replay.
+struct ReplayOOM {
+  size_t record; // index into the trace
+  c10::DeviceIndex device;
+  int64_t size;
+  int64_t allocated_bytes;
+  int64_t reserved_bytes;
+};
+
+struct ReplayResult {
+  // COUNT: allocations and frees of the trace that were replayed
+  int64_t allocs = 0;
+  int64_t frees = 0;
+  // COUNT: segments taken from the device
+  int64_t segment_allocs = 0;
+  // SUM: peak bytes, summed over devices
+  int64_t peak_allocated_bytes = 0;
+  int64_t peak_reserved_bytes = 0;
+  // TIME: spent in alloc and free calls of the allocator, and in total
+  double alloc_ns = 0;
+  double free_ns = 0;
+  double elapsed_ms = 0;
+  std::vector<ReplayOOM> ooms;
+};
+
+// Feeds the ALLOC and FREE_REQUESTED records of trace to the caching
+// allocator on top of helper, after emptying its cache and applying options.
+// Frees of blocks allocated before the trace starts, or whose allocation ran
+// out of memory, are skipped. Blocks still alive at the end are freed, the
+// cache is emptied again and the settings of PYTORCH_ALLOC_CONF are restored.
+ReplayResult replayTrace(
+    HostCachingAllocatorHelper& helper,
+    const std::vector<c10::backend::CachingAllocator::TraceRecord>& trace,
+    const ReplayOptions& options = {});
+
+} // namespace c10::backend::fake
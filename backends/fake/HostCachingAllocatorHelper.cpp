@@ -0,0 +1,378 @@
+#include "backends/fake/HostCachingAllocatorHelper.h"
+
+#include <sys/mman.h>
+
+#include <algorithm>
+#include <iterator>
+
+#include <c10/util/Exception.h>
+
+namespace c10::backend::fake {
+
+namespace {
+
+using c10::backend::CachingAllocator::MEM_ALLOCATION_ERROR;
+using c10::backend::CachingAllocator::MEM_SUCCESS;
+
+// Physical memory of memCreate, it only has a size.
+struct HostMemHandle {
+  size_t size;
+};
+
+struct ThreadState {
+  const HostCachingAllocatorHelper* owner = nullptr;
+  c10::DeviceIndex device = 0;
+  std::vector<HostStream*> streams;
+};
+
+thread_local ThreadState thread_state;
+
+// Completes once the work enqueued on its stream before it was recorded has.
+class HostEvent : public c10::backend::CachingAllocator::AllocatorEvent {
+ public:
+  explicit HostEvent(HostCachingAllocatorHelper* helper) : helper_(helper) {}
+
+  void record(const c10::Stream& stream) override {
+    stream_ = helper_->hostStream(stream);
+    auto done = std::make_shared<std::atomic<bool>>(false);
+    done_ = done;
+    stream_->enqueue([done]() { done->store(true); });
+  }
+
+  bool query() override {
+    return done_ == nullptr || done_->load();
+  }
+
+  void synchronize() override {
+    if (!query()) {
+      stream_->synchronize();
+    }
+  }
+
+ private:
+  HostCachingAllocatorHelper* helper_;
+  HostStream* stream_ = nullptr;
+  std::shared_ptr<std::atomic<bool>> done_;
+};
+
+ThreadState& getThreadState(
+    const HostCachingAllocatorHelper* helper,
+    int device_count) {
+  if (thread_state.owner != helper) {
+    thread_state.owner = helper;
+    thread_state.device = 0;
+    thread_state.streams.assign(device_count, nullptr);
+  }
+  return thread_state;
+}
+
+} // namespace
+
+void HostStream::enqueue(std::function<void()> work) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_.push_back(std::move(work));
+}
+
+bool HostStream::query() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.empty();
+}
+
+void HostStream::complete(size_t count) {
+  std::deque<std::function<void()>> done;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    count = std::min(count, pending_.size());
+    done.assign(
+        std::make_move_iterator(pending_.begin()),
+        std::make_move_iterator(pending_.begin() + count));
+    pending_.erase(pending_.begin(), pending_.begin() + count);
+  }
+  for (auto& work : done) {
+    work();
+  }
+}
+
+void HostStream::synchronize() {
+  std::deque<std::function<void()>> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending.swap(pending_);
+  }
+  for (auto& work : pending) {
+    work();
+  }
+}
+
+HostCachingAllocatorHelper::HostCachingAllocatorHelper(
+    size_t device_total,
+    int device_count)
+    : device_total_(device_total), device_count_(device_count) {
+  TORCH_CHECK(device_count > 0, "device_count must be positive");
+  for (int device = 0; device < device_count; device++) {
+    default_streams_.push_back(createStream(device));
+  }
+}
+
+HostCachingAllocatorHelper::~HostCachingAllocatorHelper() {
+  for (auto& allocation : allocations_) {
+    munmap(allocation.first, allocation.second);
+  }
+}
+
+HostStream* HostCachingAllocatorHelper::getDefaultStream(
+    c10::DeviceIndex device) {
+  return default_streams_.at(device);
+}
+
+HostStream* HostCachingAllocatorHelper::createStream(c10::DeviceIndex device) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  streams_.push_back(std::make_unique<HostStream>(
+      device, static_cast<c10::StreamId>(streams_.size())));
+  return streams_.back().get();
+}
+
+HostStream* HostCachingAllocatorHelper::hostStream(const c10::Stream& stream) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      0 <= stream.id() && static_cast<size_t>(stream.id()) < streams_.size(),
+      "not a stream of the helper: ",
+      stream);
+  return streams_[stream.id()].get();
+}
+
+void HostCachingAllocatorHelper::setCurrentStream(HostStream* stream) {
+  auto& state = getThreadState(this, device_count_);
+  state.streams.at(stream->device()) = stream;
+}
+
+HostMemoryStats HostCachingAllocatorHelper::getStats() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+void HostCachingAllocatorHelper::setDeviceTotal(size_t device_total) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  TORCH_CHECK(
+      static_cast<size_t>(stats_.used_bytes) <= device_total,
+      "device_total is below the ",
+      stats_.used_bytes,
+      " bytes in use");
+  device_total_ = device_total;
+}
+
+void HostCachingAllocatorHelper::insertEventWrapper(
+    c10::DeviceIndex device,
+    std::function<void()> insertEventFn) {
+  insertEventFn();
+}
+
+void* HostCachingAllocatorHelper::getCurrentStream(c10::DeviceIndex device) {
+  auto& state = getThreadState(this, device_count_);
+  HostStream* stream = state.streams.at(device);
+  return stream != nullptr ? stream : default_streams_.at(device);
+}
+
+int HostCachingAllocatorHelper::synchronizeStream(
+    c10::DeviceIndex device,
+    void* stream) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.stream_synchronize++;
+  }
+  static_cast<HostStream*>(stream)->synchronize();
+  return MEM_SUCCESS;
+}
+
+void HostCachingAllocatorHelper::deviceSynchronize() {
+  std::vector<HostStream*> streams;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.device_synchronize++;
+    for (auto& stream : streams_) {
+      streams.push_back(stream.get());
+    }
+  }
+  for (auto* stream : streams) {
+    stream->synchronize();
+  }
+}
+
+c10::DeviceIndex HostCachingAllocatorHelper::getDevice() {
+  return getThreadState(this, device_count_).device;
+}
+
+void HostCachingAllocatorHelper::setDevice(c10::DeviceIndex device) {
+  TORCH_CHECK(
+      0 <= device && device < device_count_, "invalid device ", device);
+  getThreadState(this, device_count_).device = device;
+}
+
+c10::DeviceIndex HostCachingAllocatorHelper::deviceCount() {
+  return static_cast<c10::DeviceIndex>(device_count_);
+}
+
+std::unique_ptr<c10::backend::CachingAllocator::AllocatorEvent>
+HostCachingAllocatorHelper::createEvent() {
+  return std::make_unique<HostEvent>(this);
+}
+
+bool HostCachingAllocatorHelper::reserve(size_t size) {
+  if (static_cast<size_t>(stats_.used_bytes) + size > device_total_) {
+    return false;
+  }
+  stats_.used_bytes += static_cast<int64_t>(size);
+  stats_.peak_used_bytes = std::max(stats_.peak_used_bytes, stats_.used_bytes);
+  device_allocations_.fetch_add(1, std::memory_order_relaxed);
+  return true;
+}
+
+void HostCachingAllocatorHelper::unreserve(size_t size) {
+  stats_.used_bytes -= static_cast<int64_t>(size);
+}
+
+int HostCachingAllocatorHelper::memFree(void* devPtr) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = allocations_.find(devPtr);
+  if (it == allocations_.end()) {
+    return MEM_ALLOCATION_ERROR;
+  }
+  munmap(it->first, it->second);
+  unreserve(it->second);
+  allocations_.erase(it);
+  stats_.mem_free++;
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memAlloc(void** devPtr, size_t size) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!reserve(size)) {
+    return MEM_ALLOCATION_ERROR;
+  }
+  void* ptr = mmap(
+      nullptr,
+      size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+      -1,
+      0);
+  if (ptr == MAP_FAILED) {
+    unreserve(size);
+    return MEM_ALLOCATION_ERROR;
+  }
+  allocations_.emplace(ptr, size);
+  stats_.mem_alloc++;
+  *devPtr = ptr;
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memGetInfo(size_t* free, size_t* total) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  *free = device_total_ - stats_.used_bytes;
+  *total = device_total_;
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memAddressFree(void* ptr, size_t size) {
+  return munmap(ptr, size) == 0 ? MEM_SUCCESS : MEM_ALLOCATION_ERROR;
+}
+
+int HostCachingAllocatorHelper::memAddressReserve(
+    void** virPtr,
+    size_t size,
+    size_t alignment,
+    void* expectPtr,
+    uint64_t flags) {
+  void* ptr = mmap(
+      expectPtr,
+      size,
+      PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+      -1,
+      0);
+  if (ptr == MAP_FAILED) {
+    return MEM_ALLOCATION_ERROR;
+  }
+  *virPtr = ptr;
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memAddressReserve(
+    void** ptr,
+    size_t size,
+    size_t alignment,
+    void* addr) {
+  return memAddressReserve(ptr, size, alignment, addr, 1);
+}
+
+int HostCachingAllocatorHelper::memCreate(
+    void** handle,
+    size_t size,
+    int device,
+    uint64_t flags) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!reserve(size)) {
+    return MEM_ALLOCATION_ERROR;
+  }
+  *handle = new HostMemHandle{size};
+  stats_.mem_create++;
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memRelease(void* handle) {
+  auto* mem = static_cast<HostMemHandle*>(handle);
+  std::lock_guard<std::mutex> lock(mutex_);
+  unreserve(mem->size);
+  delete mem;
+  stats_.mem_release++;
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memMap(
+    void* ptr,
+    size_t size,
+    size_t offset,
+    void* handle,
+    uint64_t flags) {
+  // Fresh pages over the reservation, they only take host memory once the
+  // caller touches them.
+  void* mapped = mmap(
+      ptr,
+      size,
+      PROT_READ | PROT_WRITE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+      -1,
+      0);
+  if (mapped == MAP_FAILED) {
+    return MEM_ALLOCATION_ERROR;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.mem_map++;
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memSetAccess(
+    void* ptr,
+    size_t size,
+    int device) {
+  return MEM_SUCCESS;
+}
+
+int HostCachingAllocatorHelper::memUnmap(void* ptr, size_t size) {
+  // Keep the range reserved, like unmapping a device address range does.
+  void* reserved = mmap(
+      ptr,
+      size,
+      PROT_NONE,
+      MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED,
+      -1,
+      0);
+  if (reserved == MAP_FAILED) {
+    return MEM_ALLOCATION_ERROR;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_.mem_unmap++;
+  return MEM_SUCCESS;
+}
+
+} // namespace c10::backend::fake
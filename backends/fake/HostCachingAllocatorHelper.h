@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <c10/util/flat_hash_map.h>
+#include "csrc/core/allocator/CachingAllocator.h"
+
+namespace c10::backend::fake {
+
+// A stream of the host helper. Work enqueued on it completes in order, when
+// the stream is synchronized or completes it.
+class HostStream {
+ public:
+  HostStream(c10::DeviceIndex device, c10::StreamId id)
+      : device_(device), id_(id) {}
+
+  c10::DeviceIndex device() const {
+    return device_;
+  }
+
+  // The stream as passed to recordStream.
+  c10::Stream stream() const {
+    return c10::Stream(
+        c10::Stream::UNSAFE, c10::Device(c10::kPrivateUse1, device_), id_);
+  }
+
+  void enqueue(std::function<void()> work);
+  bool query();
+  void synchronize();
+  // Runs the count oldest pieces of work, or all of them if fewer.
+  void complete(size_t count);
+
+ private:
+  c10::DeviceIndex device_;
+  c10::StreamId id_;
+  std::mutex mutex_;
+  std::deque<std::function<void()>> pending_;
+};
+
+struct HostMemoryStats {
+  // COUNT: calls into the helper that hand out or take back device memory
+  int64_t mem_alloc = 0;
+  int64_t mem_free = 0;
+  int64_t mem_create = 0;
+  int64_t mem_release = 0;
+  int64_t mem_map = 0;
+  int64_t mem_unmap = 0;
+  int64_t stream_synchronize = 0;
+  int64_t device_synchronize = 0;
+  // SUM: bytes of device memory currently handed out and its peak
+  int64_t used_bytes = 0;
+  int64_t peak_used_bytes = 0;
+};
+
+// CachingAllocatorHelper backed by host memory, so that DefaultCachingAllocator
+// runs without a device. Device memory is anonymous mmap that is never
+// touched by the allocator, virtual reservations are PROT_NONE mappings that
+// memMap turns into accessible pages, so expandable segments work as well.
+// Events complete once the work enqueued on their stream before them does.
+class HostCachingAllocatorHelper
+    : public c10::backend::CachingAllocator::CachingAllocatorHelper {
+ public:
+  HostCachingAllocatorHelper(size_t device_total, int device_count = 1);
+  ~HostCachingAllocatorHelper();
+
+  // Streams are owned by the helper and live as long as it does.
+  HostStream* getDefaultStream(c10::DeviceIndex device);
+  HostStream* createStream(c10::DeviceIndex device);
+  void setCurrentStream(HostStream* stream);
+  // The stream of a c10::Stream returned by HostStream::stream.
+  HostStream* hostStream(const c10::Stream& stream);
+
+  HostMemoryStats getStats();
+  // Changes the memory shared by the devices, which must not be below what
+  // is currently in use.
+  void setDeviceTotal(size_t device_total);
+  // Number of calls that took memory from the device so far.
+  int64_t deviceAllocations() const {
+    return device_allocations_.load(std::memory_order_relaxed);
+  }
+
+  void insertEventWrapper(
+      c10::DeviceIndex device,
+      std::function<void()> insertEventFn) override;
+  void* getCurrentStream(c10::DeviceIndex device) override;
+  int synchronizeStream(c10::DeviceIndex device, void* stream) override;
+  void deviceSynchronize() override;
+
+  c10::DeviceIndex getDevice() override;
+  void setDevice(c10::DeviceIndex device) override;
+  c10::DeviceIndex deviceCount() override;
+
+  std::unique_ptr<c10::backend::CachingAllocator::AllocatorEvent> createEvent()
+      override;
+
+  int memFree(void* devPtr) override;
+  int memAlloc(void** devPtr, size_t size) override;
+  int memGetInfo(size_t* free, size_t* total) override;
+  int memAddressFree(void* ptr, size_t size) override;
+  int memAddressReserve(
+      void** virPtr,
+      size_t size,
+      size_t alignment,
+      void* expectPtr,
+      uint64_t flags) override;
+  int memAddressReserve(void** ptr, size_t size, size_t alignment, void* addr)
+      override;
+  int memCreate(void** handle, size_t size, int device, uint64_t flags)
+      override;
+  int memRelease(void* handle) override;
+  int memMap(
+      void* ptr,
+      size_t size,
+      size_t offset,
+      void* handle,
+      uint64_t flags) override;
+  int memSetAccess(void* ptr, size_t size, int device) override;
+  int memUnmap(void* ptr, size_t size) override;
+
+ private:
+  bool reserve(size_t size);
+  void unreserve(size_t size);
+
+  size_t device_total_;
+  int device_count_;
+  std::atomic<int64_t> device_allocations_{0};
+
+  std::mutex mutex_;
+  HostMemoryStats stats_;
+  ska::flat_hash_map<void*, size_t> allocations_;
+  std::vector<std::unique_ptr<HostStream>> streams_;
+  std::vector<HostStream*> default_streams_;
+};
+
+} // namespace c10::backend::fake
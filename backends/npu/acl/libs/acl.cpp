@@ -216,6 +216,12 @@ aclDataBuffer* aclCreateDataBuffer(void* data, size_t size) {
 aclError aclDestroyDataBuffer(const aclDataBuffer* dataBuffer) {
   return 0;
 }
+aclError aclUpdateDataBuffer(
+    aclDataBuffer* dataBuffer,
+    void* data,
+    size_t size) {
+  return 0;
+}
 void aclSetTensorDescName(aclTensorDesc* desc, const char* name) {
   return;
 }
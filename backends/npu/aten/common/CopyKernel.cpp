@@ -9,6 +9,7 @@
 #include "csrc/aten/generated/CustomFunctions.h"
 #include "csrc/aten/generated/NPUNativeFunctions.h"
 #include "csrc/backend/NPUCachingHostAllocator.h"
+#include "csrc/backend/NPUEvent.h"
 #include "framework/FormatHelper.h"
 #include "framework/StorageDescHelper.h"
 #include "framework/contiguous/ContiguousOpt.h"
@@ -84,34 +85,20 @@ void copy_d2d_dtype_format(
 
 void copy_d2d(at::Tensor& self, const at::Tensor& src, bool non_blocking) {
   c10::DeviceGuard guard(src.device());
-  // p2p enable and synchronize self stream
-  if (self.device().index() != src.device().index()) {
-    bool warning_flag = false;
-    NpuP2pCtrl::get_instance().get_p2p_access(
-        src.device().index(), self.device().index(), warning_flag);
-    // In the same 'os', tensor can copy even if the enable fails
-    if (warning_flag) {
-      ASCEND_LOGW(
-          "p2p enable from %d to %d is fails",
-          src.device().index(),
-          self.device().index());
-    }
-    guard.reset_device(self.device());
-    c10::backend::NPUStream dst_stream =
-        c10::backend::getCurrentNPUStream(self.device().index());
-    NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(dst_stream, -1));
-    guard.reset_device(src.device());
+  bool cross_device = self.device().index() != src.device().index();
+  if (cross_device) {
+    begin_peer_copy(self, src);
   }
   if (self.dtype() != src.dtype()) {
     custom_ops::npu_dtype_cast_(
         self, src); // npu_dtype_cast_ will call copy function.
-    return;
+  } else {
+    copy_d2d_dtype(self, src, non_blocking);
   }
-  copy_d2d_dtype(self, src, non_blocking);
-  // synchronize src stream for different devices copy
-  if (self.device().index() != src.device().index()) {
-    c10::backend::NPUStream copy_stream = c10::backend::getCurrentNPUStream();
-    NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(copy_stream, -1));
+  // Both paths run on the source stream, which the destination has to wait
+  // for.
+  if (cross_device) {
+    end_peer_copy(self, src, non_blocking);
   }
 }
 
@@ -136,6 +123,7 @@ void copy_between_host_and_device(
     void* ctx = host_tensor.storage().data_ptr().get_context();
     c10::backend::HostAllocator::recordEvent(ptr, ctx, stream);
   } else {
+    c10::npu::DrainTaskQueue(stream.device_index());
     aclError error = aclrtSynchronizeStreamWithTimeout(stream, -1);
     auto ret = CalcuOpUtil::AclrtMemcpyWithModeSwitch(
         std::make_pair(
@@ -291,6 +279,47 @@ bool can_use_memcpy(at::Tensor& dst, const at::Tensor& src) {
   return false;
 }
 
+void begin_peer_copy(const at::Tensor& dst, const at::Tensor& src) {
+  bool warning_flag = false;
+  NpuP2pCtrl::get_instance().get_p2p_access(
+      src.device().index(), dst.device().index(), warning_flag);
+  // In the same 'os', tensor can copy even if the enable fails
+  if (warning_flag) {
+    ASCEND_LOGW(
+        "p2p enable from %d to %d is fails",
+        src.device().index(),
+        dst.device().index());
+  }
+  // The copy runs on the current stream of the source device, after the work
+  // already queued on the destination stream.
+  c10::backend::NPUEvent dst_ready;
+  {
+    c10::DeviceGuard guard(dst.device());
+    dst_ready.record(c10::backend::getCurrentNPUStream(dst.device().index()));
+  }
+  c10::DeviceGuard guard(src.device());
+  dst_ready.block(c10::backend::getCurrentNPUStream(src.device().index()));
+}
+
+void end_peer_copy(
+    const at::Tensor& dst,
+    const at::Tensor& src,
+    bool non_blocking) {
+  // Later work on the destination stream waits for the copy. Both tensors
+  // are only used on the current streams of their devices, so the caching
+  // allocator needs no recordStream for them.
+  c10::backend::NPUEvent copy_done;
+  {
+    c10::DeviceGuard guard(src.device());
+    copy_done.record(c10::backend::getCurrentNPUStream(src.device().index()));
+  }
+  c10::DeviceGuard guard(dst.device());
+  copy_done.block(c10::backend::getCurrentNPUStream(dst.device().index()));
+  if (!non_blocking) {
+    copy_done.synchronize();
+  }
+}
+
 at::Tensor copy_d2d_format_cast(at::Tensor& dst, const at::Tensor& src) {
   string srcFormat = FormatHelper::GetFormatName(src);
   string dstFormat = FormatHelper::GetFormatName(dst);
@@ -68,6 +68,7 @@ at::Tensor& NPUNativeFunctions::copy_memory_(
 
   if (!non_blocking) {
     c10::backend::NPUStream stream = c10::backend::getCurrentNPUStream();
+    c10::npu::DrainTaskQueue(stream.device_index());
     NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(stream, -1));
   }
   return self;
@@ -16,6 +16,16 @@ void copy_d2d_dtype_baseformat(
     at::Tensor& self,
     const at::Tensor& src,
     bool non_blocking);
+// Orders a copy between two devices, issued on the current stream of the
+// source device, after the work queued on the current stream of the
+// destination device, and that stream's later work after the copy, with
+// events instead of host synchronizations. Blocking copies wait for the copy
+// to complete.
+void begin_peer_copy(const at::Tensor& dst, const at::Tensor& src);
+void end_peer_copy(
+    const at::Tensor& dst,
+    const at::Tensor& src,
+    bool non_blocking);
 bool try_to_optimize_copy_with_any_format(
     at::Tensor& self,
     const at::Tensor& src);
@@ -1,51 +1,18 @@
 #include <ATen/ATen.h>
 #include <ATen/NativeFunctions.h>
 
+#include "aten/common/ScalarReadback.h"
 #include "csrc/aten/generated/NPUNativeFunctions.h"
-#include "csrc/backend/NPUStream.h"
-#include "acl/include/acl/acl_base.h"
-#include "acl/include/acl/acl_rt.h"
-#include "framework/utils/CalcuOpUtil.h"
 
 namespace at_npu {
 namespace native {
 
 c10::Scalar NPUNativeFunctions::_local_scalar_dense(const at::Tensor& self) {
-  c10::Scalar r;
-  AT_DISPATCH_ALL_TYPES_AND3(
-      at::ScalarType::Half,
-      at::ScalarType::Bool,
-      at::ScalarType::BFloat16,
-      self.scalar_type(),
-      "_local_scalar_dense_npu",
-      [&] {
-        scalar_t value = 0;
-        c10::backend::NPUStream copy_stream =
-            c10::backend::getCurrentNPUStream();
-        // Synchronous copy after stream synchronization
-        aclError error = aclrtSynchronizeStreamWithTimeout(copy_stream, -1);
-        if (error != ACL_ERROR_NONE) {
-          C10_NPU_SHOW_ERR_MSG();
-          AT_ERROR("ACL stream synchronize failed.");
-          return;
-        }
-
-        error = CalcuOpUtil::AclrtMemcpyWithModeSwitch(
-            &value,
-            sizeof(scalar_t),
-            std::make_pair(
-                self.storage().unsafeGetStorageImpl(),
-                self.storage_offset() * self.itemsize()),
-            sizeof(scalar_t),
-            ACL_MEMCPY_DEVICE_TO_HOST);
-        if (error != ACL_ERROR_NONE) {
-          C10_NPU_SHOW_ERR_MSG();
-          AT_ERROR("aclrtMemcpy device to host error.");
-          return;
-        }
-        r = c10::Scalar(value);
-      });
-  return r;
+  // Waits on an event recorded after the copy of the value into pinned
+  // memory, rather than synchronizing the stream and copying synchronously.
+  ScalarReadback readback;
+  readback.add(self);
+  return readback.wait()[0];
 }
 
 } // namespace native
@@ -0,0 +1,111 @@
+#include "aten/common/ScalarReadback.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <c10/core/DeviceGuard.h>
+
+#include "core/NPUException.h"
+#include "core/interface/AsyncTaskQueueInterface.h"
+#include "csrc/backend/NPUEvent.h"
+#include "csrc/backend/NPUFunctions.h"
+#include "csrc/core/allocator/EventPool.h"
+
+namespace at_npu {
+namespace native {
+
+namespace {
+
+using EventPool =
+    c10::backend::CachingAllocator::EventPool<c10::backend::NPUEvent>;
+
+EventPool::Event get_event(c10::DeviceIndex device) {
+  // Leak the event pool to avoid shutdown issue.
+  static auto* event_pool =
+      new EventPool(c10::backend::device_count(), []() {
+        return std::make_unique<c10::backend::NPUEvent>();
+      });
+  return event_pool->get(device);
+}
+
+} // namespace
+
+ScalarReadback::~ScalarReadback() {
+  try {
+    // The copies must be done before their slots are handed out again.
+    synchronize();
+  } catch (...) { /* No throw */
+  }
+  for (auto& entry : entries_) {
+    c10::backend::HostAllocator::releaseStagingSlot(entry.slot);
+  }
+}
+
+void ScalarReadback::add(const at::Tensor& tensor) {
+  TORCH_CHECK(
+      tensor.numel() == 1,
+      "a Tensor with ",
+      tensor.numel(),
+      " elements cannot be converted to Scalar",
+      OPS_ERROR(ErrCode::PARAM));
+  TORCH_CHECK(
+      tensor.element_size() <= c10::backend::HostAllocator::kStagingSlotSize,
+      "Cannot read back scalars of type ",
+      tensor.scalar_type(),
+      OPS_ERROR(ErrCode::TYPE));
+  c10::DeviceGuard guard(tensor.device());
+  c10::backend::NPUStream stream = c10::backend::getCurrentNPUStream();
+
+  Entry entry{
+      tensor.scalar_type(), c10::backend::HostAllocator::acquireStagingSlot()};
+  aclError error = c10::npu::queue::LaunchAsyncCopyTask(
+      entry.slot.ptr,
+      c10::backend::HostAllocator::kStagingSlotSize,
+      tensor.data_ptr(),
+      tensor.element_size(),
+      ACL_MEMCPY_DEVICE_TO_HOST);
+  if (error != ACL_ERROR_NONE) {
+    c10::backend::HostAllocator::releaseStagingSlot(entry.slot);
+    C10_NPU_SHOW_ERR_MSG();
+    AT_ERROR("aclrtMemcpyAsync device to host error.");
+  }
+  entries_.push_back(std::move(entry));
+  if (std::find(streams_.begin(), streams_.end(), stream) == streams_.end()) {
+    streams_.push_back(stream);
+  }
+}
+
+void ScalarReadback::synchronize() {
+  for (const auto& stream : streams_) {
+    c10::DeviceGuard guard(stream.device());
+    auto event = get_event(stream.device_index());
+    event->record(stream);
+    event->synchronize();
+  }
+  streams_.clear();
+}
+
+std::vector<c10::Scalar> ScalarReadback::wait() {
+  synchronize();
+  std::vector<c10::Scalar> values;
+  values.reserve(entries_.size());
+  for (auto& entry : entries_) {
+    AT_DISPATCH_ALL_TYPES_AND3(
+        at::ScalarType::Half,
+        at::ScalarType::Bool,
+        at::ScalarType::BFloat16,
+        entry.type,
+        "scalar_readback_npu",
+        [&] {
+          scalar_t value;
+          std::memcpy(&value, entry.slot.ptr, sizeof(scalar_t));
+          values.emplace_back(value);
+        });
+    c10::backend::HostAllocator::releaseStagingSlot(entry.slot);
+  }
+  entries_.clear();
+  return values;
+}
+
+} // namespace native
+} // namespace at_npu
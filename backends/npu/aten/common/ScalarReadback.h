@@ -0,0 +1,46 @@
+#ifndef __PLUGIN_NATIVE_NPU_COMMON_SCALAR_READBACK__
+#define __PLUGIN_NATIVE_NPU_COMMON_SCALAR_READBACK__
+
+#include <vector>
+
+#include <ATen/ATen.h>
+#include <c10/util/SmallVector.h>
+
+#include "csrc/backend/NPUCachingHostAllocator.h"
+#include "csrc/backend/NPUStream.h"
+
+namespace at_npu {
+namespace native {
+
+// Reads back the values of single element NPU tensors, e.g. losses and
+// gradient norms logged every step. Each tensor is copied into a pinned
+// staging slot on the current stream of its device as soon as it is added.
+// wait() then blocks on one event per stream instead of synchronizing the
+// streams, so work queued on them afterwards does not hold up the readback.
+class ScalarReadback {
+ public:
+  ScalarReadback() = default;
+  ScalarReadback(const ScalarReadback&) = delete;
+  ScalarReadback& operator=(const ScalarReadback&) = delete;
+  ~ScalarReadback();
+
+  void add(const at::Tensor& tensor);
+  // Returns the values of the tensors added since the last wait, in order.
+  std::vector<c10::Scalar> wait();
+
+ private:
+  struct Entry {
+    at::ScalarType type;
+    c10::backend::HostAllocator::StagingSlot slot;
+  };
+
+  void synchronize();
+
+  std::vector<Entry> entries_;
+  c10::SmallVector<c10::backend::NPUStream, 1> streams_;
+};
+
+} // namespace native
+} // namespace at_npu
+
+#endif
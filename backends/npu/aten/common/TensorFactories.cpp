@@ -688,7 +688,8 @@ at::Tensor NPUNativeFunctions::clone(
     const at::Tensor& src,
     c10::optional<c10::MemoryFormat> format) {
   c10::DeviceGuard guard(src.device());
-  OptimizationCases opt_cases{"reshape", "slice"};
+  OptimizationCases opt_cases{
+      OptimizationCase::RESHAPE, OptimizationCase::SLICE};
   if (TransContiguous::CanOptimize(src, opt_cases)) {
     // clone with any npu formats
     auto formatTempTensor =
@@ -65,6 +65,8 @@ static bool amp_foreach_non_finite_check(at::TensorList& scaled_grads) {
   NON_FINITE_CHECK_RESULT_ESTIMATE(
       err, host_mem_out, device_mem_out, "malloc host memory failed!");
 
+  // Overflow status is read on the stream directly, queued ops go first.
+  c10::npu::DrainTaskQueue();
   err = aclrtGetOverflowStatus(device_mem_out, buff_size, aclStream);
   NON_FINITE_CHECK_RESULT_ESTIMATE(
       err, host_mem_out, device_mem_out, "get overflow status failed!");
@@ -18,14 +18,45 @@
 namespace op_api {
 using npu_preparation = at_npu::native::OpPreparation;
 
+namespace {
+// The scalar list kernel takes the scalars as one tensor on device, e.g. the
+// per-parameter step sizes of foreach optimizers, uploaded in a single copy.
+bool can_use_addcdiv_scalar_list(const at::TensorList input,
+    const at::TensorList tensors1,
+    const at::TensorList tensors2,
+    const at::ArrayRef<at::Scalar> scalars)
+{
+    if (!at::native::can_use_fast_route({input, tensors1, tensors2}, scalars, true) ||
+        at::native::has_integral_tensor(input, true)) {
+        return false;
+    }
+    auto scalar_type = input[0].scalar_type();
+    return scalar_type == at::ScalarType::Half || scalar_type == at::ScalarType::Float;
+}
+} // namespace
+
 std::vector<at::Tensor> _foreach_addcdiv(const at::TensorList input,
     const at::TensorList tensors1,
     const at::TensorList tensors2,
     const at::ArrayRef<at::Scalar> scalars)
 {
     at::native::check_foreach_api_restrictions(input, tensors1, tensors2, scalars);
-    // 暂不支持对scalarlist的处理，暂时走cuda原生路径
-    return at::native::foreach_tensor_addcdiv_scalarlist_slow(input, tensors1, tensors2, scalars);
+    if (!can_use_addcdiv_scalar_list(input, tensors1, tensors2, scalars)) {
+        return at::native::foreach_tensor_addcdiv_scalarlist_slow(input, tensors1, tensors2, scalars);
+    }
+
+    auto scalar_type = input[0].scalar_type();
+    std::vector<at::Tensor> result;
+    result.reserve(input.size());
+    for (const at::Tensor &tensor : input) {
+        auto output_size = op_infer::input_same_output_size(tensor);
+        result.push_back(npu_preparation::apply_tensor_without_format(output_size, tensor.options().dtype(scalar_type)));
+    }
+    at::TensorList result_ = at::TensorList(result);
+    auto scalar_tensor = npu_preparation::copy_scalars_to_device(scalars, scalar_type, input[0].device());
+    EXEC_NPU_CMD(aclnnForeachAddcdivScalarList, input, tensors1, tensors2, scalar_tensor, result_);
+
+    return result;
 }
 
 void _foreach_addcdiv_(const at::TensorList input,
@@ -34,7 +65,12 @@ void _foreach_addcdiv_(const at::TensorList input,
     const at::ArrayRef<at::Scalar> scalars)
 {
     at::native::check_foreach_api_restrictions(input, tensors1, tensors2, scalars);
-    // 暂不支持对scalarlist的处理，暂时走cuda原生路径
-    return at::native::foreach_tensor_addcdiv_scalarlist_slow_(input, tensors1, tensors2, scalars);
-}
+    if (!can_use_addcdiv_scalar_list(input, tensors1, tensors2, scalars)) {
+        return at::native::foreach_tensor_addcdiv_scalarlist_slow_(input, tensors1, tensors2, scalars);
+    }
+
+    auto scalar_type = input[0].scalar_type();
+    auto scalar_tensor = npu_preparation::copy_scalars_to_device(scalars, scalar_type, input[0].device());
+    EXEC_NPU_CMD(aclnnForeachAddcdivScalarList, input, tensors1, tensors2, scalar_tensor, input);
 }
+} // namespace op_api
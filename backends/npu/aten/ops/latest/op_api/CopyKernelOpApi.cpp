@@ -16,7 +16,6 @@
 
 #include "aten/common/InnerNpuNativeFunction.h"
 #include "aten/utils/op_api_common.h"
-#include "core/NPUPeerToPeerAccess.h"
 #include "csrc/aten/generated/NPUNativeFunctions.h"
 #include "csrc/aten/generated/NPUOpApiNativeFunctions.h"
 #include "csrc/backend/NPUCachingHostAllocator.h"
@@ -47,6 +46,7 @@ void copy_between_host_and_device_opapi(
     void* ctx = host_tensor.storage().data_ptr().get_context();
     c10::backend::HostAllocator::recordEvent(ptr, ctx, stream);
   } else {
+    c10::npu::DrainTaskQueue(stream.device_index());
     aclError error = aclrtSynchronizeStream(stream);
     auto ret = CalcuOpUtil::AclrtMemcpyWithModeSwitch(
         std::make_pair(
@@ -173,31 +173,17 @@ void copy_d2d_baseformat_opapi(
     const at::Tensor& src,
     bool non_blocking) {
   c10::DeviceGuard guard(src.device());
-  if (dst.device().index() != src.device().index()) {
-    bool warning_flag = false;
-    NpuP2pCtrl::get_instance().get_p2p_access(
-        src.device().index(), dst.device().index(), warning_flag);
-    // In the same 'os', tensor can copy even if the enable fails
-    if (warning_flag) {
-      ASCEND_LOGW(
-          "p2p enable from %d to %d is fails",
-          src.device().index(),
-          dst.device().index());
-    }
-    guard.reset_device(dst.device());
-    c10::backend::NPUStream dst_stream =
-        c10::backend::getCurrentNPUStream(dst.device().index());
-    NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(dst_stream, -1));
-    guard.reset_device(src.device());
+  bool cross_device = dst.device().index() != src.device().index();
+  if (cross_device) {
+    begin_peer_copy(dst, src);
   } else {
     c10::SmallVector<at::Tensor, N> inputs = {src};
     c10::SmallVector<at::Tensor, N> outputs = {dst};
     CalcuOpUtil::CheckMemoryOverLaps(inputs, outputs);
   }
   EXEC_NPU_CMD(aclnnInplaceCopy, dst, src);
-  if (dst.device().index() != src.device().index()) {
-    c10::backend::NPUStream copy_stream = c10::backend::getCurrentNPUStream();
-    NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(copy_stream, -1));
+  if (cross_device) {
+    end_peer_copy(dst, src, non_blocking);
   }
 }
 
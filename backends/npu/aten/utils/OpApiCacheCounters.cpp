@@ -0,0 +1,95 @@
+#include "aten/utils/OpApiCacheCounters.h"
+
+#include <map>
+
+namespace at_npu {
+namespace native {
+
+OpApiCacheCounters& OpApiCacheCounters::GetInstance() {
+  static OpApiCacheCounters instance;
+  return instance;
+}
+
+OpApiCacheCounters::OpApiCacheCounters()
+    : id_([]() {
+        static std::atomic<uint64_t> next_id{0};
+        return next_id++;
+      }()) {}
+
+OpApiCacheCounters::Counters& OpApiCacheCounters::GetCounters(const char* api) {
+  thread_local std::
+      unordered_map<uint64_t, std::unordered_map<const char*, Counters*>>
+          local_counters;
+  auto& local = local_counters[id_];
+  auto it = local.find(api);
+  if (it != local.end()) {
+    return *it->second;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto& counters = counters_[api];
+  if (counters == nullptr) {
+    counters = std::make_unique<Counters>();
+  }
+  local.emplace(api, counters.get());
+  return *counters;
+}
+
+void OpApiCacheCounters::Count(const char* api, Outcome outcome) {
+  Counters& counters = GetCounters(api);
+  switch (outcome) {
+    case Outcome::HIT:
+      counters.hits.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case Outcome::MISS:
+      counters.misses.fetch_add(1, std::memory_order_relaxed);
+      break;
+    case Outcome::BYPASS:
+      counters.bypasses.fetch_add(1, std::memory_order_relaxed);
+      break;
+  }
+}
+
+void OpApiCacheCounters::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& item : counters_) {
+    item.second->hits = 0;
+    item.second->misses = 0;
+    item.second->bypasses = 0;
+  }
+}
+
+OpApiCacheStats OpApiCacheCounters::GetStats(const std::string& api) const {
+  OpApiCacheStats total;
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const auto& item : counters_) {
+    if (api == item.first) {
+      total.hits += item.second->hits;
+      total.misses += item.second->misses;
+      total.bypasses += item.second->bypasses;
+    }
+  }
+  return total;
+}
+
+std::vector<std::pair<std::string, OpApiCacheStats>> OpApiCacheCounters::GetAllStats()
+    const {
+  std::map<std::string, OpApiCacheStats> merged;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto& item : counters_) {
+      const auto& counters = *item.second;
+      if (counters.hits == 0 && counters.misses == 0 &&
+          counters.bypasses == 0) {
+        continue;
+      }
+      auto& stats = merged[item.first];
+      stats.hits += counters.hits;
+      stats.misses += counters.misses;
+      stats.bypasses += counters.bypasses;
+    }
+  }
+  return {merged.begin(), merged.end()};
+}
+
+} // namespace native
+} // namespace at_npu
@@ -0,0 +1,66 @@
+#ifndef OP_PULGIN_UTILS_OP_API_CACHE_COUNTERS
+#define OP_PULGIN_UTILS_OP_API_CACHE_COUNTERS
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace at_npu {
+namespace native {
+
+struct OpApiCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  // Calls whose params can not be keyed, e.g. scalars wrapped to tensors.
+  uint64_t bypasses = 0;
+};
+
+// Per-api hit counters of the executor cache of the op-api library, the one
+// reached through its PTA hooks. Nothing is cached here: executors are built
+// by aclnnXxxGetWorkspaceSize and only the op-api library can rebind a cached
+// one to new tensor addresses, so a miss, or a library without the hooks,
+// always calls GetWorkspaceSize.
+//
+// Counting takes no lock once a thread has seen an api, the counters of each
+// api are atomics found through a thread local map.
+class OpApiCacheCounters {
+ public:
+  enum class Outcome { HIT, MISS, BYPASS };
+
+  static OpApiCacheCounters& GetInstance();
+
+  OpApiCacheCounters();
+
+  // api must be a string literal, the counters are looked up by address.
+  void Count(const char* api, Outcome outcome);
+  void Clear();
+
+  OpApiCacheStats GetStats(const std::string& api) const;
+  std::vector<std::pair<std::string, OpApiCacheStats>> GetAllStats() const;
+
+ private:
+  struct Counters {
+    std::atomic<uint64_t> hits{0};
+    std::atomic<uint64_t> misses{0};
+    std::atomic<uint64_t> bypasses{0};
+  };
+
+  Counters& GetCounters(const char* api);
+
+  // Tells instances apart in the thread local maps, addresses can be reused.
+  const uint64_t id_;
+  mutable std::mutex mutex_;
+  // Keyed by the api literal of each call site, merged by name when read.
+  // Counters are never removed, Clear() only zeroes them.
+  std::unordered_map<const char*, std::unique_ptr<Counters>> counters_;
+};
+
+} // namespace native
+} // namespace at_npu
+
+#endif
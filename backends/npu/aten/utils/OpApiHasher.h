@@ -0,0 +1,134 @@
+#ifndef OP_PULGIN_UTILS_OP_API_HASHER
+#define OP_PULGIN_UTILS_OP_API_HASHER
+
+#include <cstdint>
+#include <cstring>
+
+namespace at_npu {
+namespace native {
+
+// Streaming hash of the params of an aclnn call, see add_param_to_buf.
+// Params are fed as 64-bit words spread over four lanes, so runs of sizes and
+// strides hash four independent multiply chains at a time and there is no
+// limit on how many params a call may have.
+class OpApiHasher {
+ public:
+  void Reset() {
+    lanes_[0] = kSeed + kPrime1 + kPrime2;
+    lanes_[1] = kSeed + kPrime2;
+    lanes_[2] = kSeed;
+    lanes_[3] = kSeed - kPrime1;
+    count_ = 0;
+    disabled_ = false;
+  }
+
+  // The call can not be keyed, e.g. a scalar is wrapped to a tensor.
+  void Disable() {
+    disabled_ = true;
+  }
+
+  bool IsDisabled() const {
+    return disabled_;
+  }
+
+  void AddWord(uint64_t word) {
+    uint64_t& lane = lanes_[count_ & 3];
+    lane = Round(lane, word);
+    count_++;
+  }
+
+  // Words followed by their count, so adjacent runs can not trade values.
+  void AddRun(const int64_t* data, size_t size) {
+    size_t i = 0;
+    for (; i < size && (count_ & 3) != 0; i++) {
+      AddWord(static_cast<uint64_t>(data[i]));
+    }
+    uint64_t v0 = lanes_[0];
+    uint64_t v1 = lanes_[1];
+    uint64_t v2 = lanes_[2];
+    uint64_t v3 = lanes_[3];
+    size_t blocks = (size - i) / 4;
+    for (size_t b = 0; b < blocks; b++, i += 4) {
+      v0 = Round(v0, static_cast<uint64_t>(data[i]));
+      v1 = Round(v1, static_cast<uint64_t>(data[i + 1]));
+      v2 = Round(v2, static_cast<uint64_t>(data[i + 2]));
+      v3 = Round(v3, static_cast<uint64_t>(data[i + 3]));
+    }
+    lanes_[0] = v0;
+    lanes_[1] = v1;
+    lanes_[2] = v2;
+    lanes_[3] = v3;
+    count_ += blocks * 4;
+    for (; i < size; i++) {
+      AddWord(static_cast<uint64_t>(data[i]));
+    }
+    AddWord(size);
+  }
+
+  // Bytes packed into words, followed by the byte count.
+  void AddBytes(const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+      uint64_t word;
+      memcpy(&word, bytes + i, sizeof(word));
+      AddWord(word);
+    }
+    if (i < size) {
+      uint64_t word = 0;
+      memcpy(&word, bytes + i, size - i);
+      AddWord(word);
+    }
+    AddWord(size);
+  }
+
+  // 0 means the call can not be keyed.
+  uint64_t Digest() const {
+    if (disabled_) {
+      return 0;
+    }
+    uint64_t hash = Rotl(lanes_[0], 1) + Rotl(lanes_[1], 7) +
+        Rotl(lanes_[2], 12) + Rotl(lanes_[3], 18);
+    for (uint64_t lane : lanes_) {
+      hash ^= Round(0, lane);
+      hash = hash * kPrime1 + kPrime4;
+    }
+    hash += count_;
+    // murmur3 fmix64
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash == 0 ? 1 : hash;
+  }
+
+ private:
+  static constexpr uint64_t kPrime1 = 0x9e3779b185ebca87ULL;
+  static constexpr uint64_t kPrime2 = 0xc2b2ae3d27d4eb4fULL;
+  static constexpr uint64_t kPrime4 = 0x85ebca77c2b2ae63ULL;
+  static constexpr uint64_t kSeed = 0xdeadb0d7ULL;
+
+  static uint64_t Rotl(uint64_t x, int bits) {
+    return (x << bits) | (x >> (64 - bits));
+  }
+
+  static uint64_t Round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = Rotl(acc, 31);
+    return acc * kPrime1;
+  }
+
+  uint64_t lanes_[4] = {
+      kSeed + kPrime1 + kPrime2,
+      kSeed + kPrime2,
+      kSeed,
+      kSeed - kPrime1};
+  uint64_t count_ = 0;
+  bool disabled_ = false;
+};
+
+} // namespace native
+} // namespace at_npu
+
+#endif
@@ -15,11 +15,11 @@
 
 #include "op_api_common.h"
 
-thread_local char g_hash_buf[g_hash_buf_size];
-thread_local int g_hash_offset = 0;
-constexpr int g_rShift33Bits = 33;
-constexpr uint64_t MIX_STEP1 = 18397679294719823053LLU;
-constexpr uint64_t MIX_STEP2 = 14181476777654086739LLU;
+thread_local at_npu::native::OpApiHasher g_param_hasher;
+// Tensor addresses only go to the PTA cache of the op-api library.
+thread_local bool g_cache_tensor_addr = false;
+// Stands for an absent optional param.
+constexpr uint64_t g_none_param = ',';
 
 
 typedef void(*AddTensorAddrToCachedList) (void *addr);
@@ -131,30 +131,31 @@ const std::vector<std::string> g_default_custom_lib_path = get_default_custom_li
 void add_param_to_buf(const at::Tensor &at_tensor)
 {
     static const auto addTensorAddrToCachedListAddr = GetOpApiFuncAddr("AddTensorAddrToCachedList");
-    TORCH_CHECK(addTensorAddrToCachedListAddr != nullptr, "GetOpApiFuncAddr failed.", OPS_ERROR(ErrCode::PTR));
+    TORCH_CHECK(!g_cache_tensor_addr || addTensorAddrToCachedListAddr != nullptr, "GetOpApiFuncAddr failed.",
+        OPS_ERROR(ErrCode::PTR));
     AddTensorAddrToCachedList addTensorAddrToCachedListFunc =
         reinterpret_cast<AddTensorAddrToCachedList>(addTensorAddrToCachedListAddr);
+    if (g_param_hasher.IsDisabled()) {
+        return;
+    }
     if (!at_tensor.defined()) {
-        MEMCPY_TO_BUF(",", 1);
+        g_param_hasher.AddWord(g_none_param);
         return;
     }
     TORCH_CHECK(torch_backend::utils::is_npu(at_tensor), "only npu tensor is supported", OPS_ERROR(ErrCode::PARAM));
     if (at_npu::native::OpPreparation::is_scalar_wrapped_to_tensor(at_tensor)) {
-        g_hash_offset = g_hash_buf_max_size;
+        g_param_hasher.Disable();
         return;
     }
     // view shape
-    MEMCPY_TO_BUF(at_tensor.sizes().data(), static_cast<int64_t>(at_tensor.sizes().size() * sizeof(int64_t)));
+    g_param_hasher.AddRun(at_tensor.sizes().data(), at_tensor.sizes().size());
     // data type
     auto st = at_tensor.scalar_type();
-    MEMCPY_TO_BUF(&st, sizeof(st));
-    // seperator
-    MEMCPY_TO_BUF(",", 1);
+    g_param_hasher.AddWord(static_cast<uint64_t>(st));
     // strides
-    MEMCPY_TO_BUF(at_tensor.strides().data(), static_cast<int64_t>(at_tensor.sizes().size() * sizeof(int64_t)));
+    g_param_hasher.AddRun(at_tensor.strides().data(), at_tensor.strides().size());
     // offset
-    auto so = at_tensor.storage_offset();
-    MEMCPY_TO_BUF(&so, sizeof(so));
+    g_param_hasher.AddWord(static_cast<uint64_t>(at_tensor.storage_offset()));
     // storage shape
     aclDataType acl_data_type = at_npu::native::OpPreparation::convert_to_acl_data_type(st);
     c10::SmallVector<int64_t, 5> storageDims;
@@ -163,9 +164,11 @@ void add_param_to_buf(const at::Tensor &at_tensor)
             OPS_ERROR(ErrCode::PARAM));
         storageDims.push_back(at_tensor.storage().nbytes() / at_tensor.itemsize());
     }
-    MEMCPY_TO_BUF(storageDims.data(), static_cast<int64_t>(storageDims.size() * sizeof(int64_t)));
+    g_param_hasher.AddRun(storageDims.data(), storageDims.size());
 
-    addTensorAddrToCachedListFunc(const_cast<void*>(at_tensor.storage().data()));
+    if (g_cache_tensor_addr) {
+        addTensorAddrToCachedListFunc(const_cast<void*>(at_tensor.storage().data()));
+    }
 }
 
 void add_param_to_buf(const at::Scalar &at_scalar)
@@ -174,22 +177,22 @@ void add_param_to_buf(const at::Scalar &at_scalar)
     switch (scalar_data_type) {
         case at::ScalarType::Double: {
             double value = at_scalar.toDouble();
-            MEMCPY_TO_BUF(&value, sizeof(double));
+            g_param_hasher.AddBytes(&value, sizeof(double));
             break;
         }
         case at::ScalarType::Long: {
             int64_t value = at_scalar.toLong();
-            MEMCPY_TO_BUF(&value, sizeof(int64_t));
+            g_param_hasher.AddBytes(&value, sizeof(int64_t));
             break;
         }
         case at::ScalarType::Bool: {
             bool value = at_scalar.toBool();
-            MEMCPY_TO_BUF(&value, sizeof(bool));
+            g_param_hasher.AddBytes(&value, sizeof(bool));
             break;
         }
         case at::ScalarType::ComplexDouble: {
             auto value = at_scalar.toComplexDouble();
-            MEMCPY_TO_BUF(&value, sizeof(value));
+            g_param_hasher.AddBytes(&value, sizeof(value));
             break;
         }
         default: {
@@ -200,16 +203,12 @@ void add_param_to_buf(const at::Scalar &at_scalar)
 
 void add_param_to_buf(const at::IntArrayRef &at_array)
 {
-    MEMCPY_TO_BUF(at_array.data(), static_cast<int64_t>(at_array.size() * sizeof(int64_t)));
-    auto counter = at_array.size();
-    MEMCPY_TO_BUF(&counter, sizeof(counter));
+    g_param_hasher.AddRun(at_array.data(), at_array.size());
 }
 
 void add_param_to_buf(const at::ArrayRef<bool> &at_array)
 {
-    MEMCPY_TO_BUF(at_array.data(), static_cast<int64_t>(at_array.size() * sizeof(bool)));
-    auto counter = at_array.size();
-    MEMCPY_TO_BUF(&counter, sizeof(counter));
+    g_param_hasher.AddBytes(at_array.data(), at_array.size() * sizeof(bool));
 }
 
 void add_param_to_buf(const at::TensorList &at_tensor_list)
@@ -217,8 +216,7 @@ void add_param_to_buf(const at::TensorList &at_tensor_list)
     for (size_t i = 0; i < at_tensor_list.size(); i++) {
         add_param_to_buf(at_tensor_list[i]);
     }
-    auto counter = at_tensor_list.size();
-    MEMCPY_TO_BUF(&counter, sizeof(counter));
+    g_param_hasher.AddWord(at_tensor_list.size());
 }
 
 void add_param_to_buf(const at::ArrayRef<at::Scalar> &at_scalar_list)
@@ -226,9 +224,7 @@ void add_param_to_buf(const at::ArrayRef<at::Scalar> &at_scalar_list)
     for (size_t i = 0; i < at_scalar_list.size(); i++) {
         add_param_to_buf(at_scalar_list[i]);
     }
-    auto counter = at_scalar_list.size();
-    MEMCPY_TO_BUF(&counter, sizeof(counter));
-    MEMCPY_TO_BUF(",", 1);
+    g_param_hasher.AddWord(at_scalar_list.size());
 }
 
 void add_param_to_buf(const c10::optional<at::Tensor> &opt_tensor)
@@ -236,7 +232,7 @@ void add_param_to_buf(const c10::optional<at::Tensor> &opt_tensor)
     if (opt_tensor.has_value() && opt_tensor.value().defined()) {
         add_param_to_buf(opt_tensor.value());
     } else {
-        MEMCPY_TO_BUF(",", 1);
+        g_param_hasher.AddWord(g_none_param);
     }
 }
 
@@ -245,7 +241,7 @@ void add_param_to_buf(const c10::optional<at::IntArrayRef> &opt_array)
     if (opt_array.has_value()) {
         add_param_to_buf(opt_array.value());
     } else {
-        MEMCPY_TO_BUF(",", 1);
+        g_param_hasher.AddWord(g_none_param);
     }
 }
 
@@ -254,185 +250,41 @@ void add_param_to_buf(const c10::optional<at::Scalar> &opt_scalar)
     if (opt_scalar.has_value()) {
         add_param_to_buf(opt_scalar.value());
     } else {
-        MEMCPY_TO_BUF(",", 1);
+        g_param_hasher.AddWord(g_none_param);
     }
 }
 
 void add_param_to_buf(const at::ScalarType scalar_type)
 {
-    MEMCPY_TO_BUF(&scalar_type, sizeof(scalar_type));
+    g_param_hasher.AddWord(static_cast<uint64_t>(scalar_type));
 }
 
 void add_param_to_buf(const string& s)
 {
-    MEMCPY_TO_BUF(s.c_str(), static_cast<int64_t>(s.size()));
+    g_param_hasher.AddBytes(s.c_str(), s.size());
 }
 
 void add_param_to_buf(char *c)
 {
-    MEMCPY_TO_BUF(c, strlen(c));
-    auto counter = strlen(c);
-    MEMCPY_TO_BUF(&counter, sizeof(counter));
+    g_param_hasher.AddBytes(c, strlen(c));
 }
 
 void add_param_to_buf(const char *c)
 {
-    MEMCPY_TO_BUF(c, strlen(c));
-    auto counter = strlen(c);
-    MEMCPY_TO_BUF(&counter, sizeof(counter));
+    g_param_hasher.AddBytes(c, strlen(c));
 }
 
 void add_param_to_buf() {}
 
-inline uint64_t rotating_left(uint64_t x, uint8_t n)
-{
-    return (x << n) | (x >> (64 - n));
-}
-
-inline uint64_t mixture(uint64_t x)
+void init_hash_buf(bool cache_tensor_addr)
 {
-    // constants step1(18397679294719823053) and step2(14181476777654086739) are used to allow
-    // hash values to be more evenly distributed after multiplication.
-    x ^= x >> g_rShift33Bits;
-    x *= MIX_STEP1;
-    x ^= x >> g_rShift33Bits;
-    x *= MIX_STEP2;
-    x ^= x >> g_rShift33Bits;
-
-    return x;
-}
-
-// MurmurHash3 was written by Austin Appleby, and is placed in the public
-// domain. The author hereby disclaims copyright to this source code.
-uint64_t gen_hash(const void *key, const int len, const uint32_t seed = 0xdeadb0d7)
-{
-    const uint8_t *data = (const uint8_t *)key;
-    // the length of each block is 16 bytes
-    const int block_num = len / 16;
-    // has and hax are literal appromix to hash, and hax is the return value of this function.
-    uint64_t has = seed;
-    uint64_t hax = seed;
-
-    // use 9782798678568883157 and 5545529020109919103 for blocking and obfuscation of input data
-    const uint64_t c1 = 9782798678568883157LLU;
-    const uint64_t c2 = 5545529020109919103LLU;
-
-    const uint64_t *blocks = (const uint64_t *)(data);
-
-    for (int i = 0; i < block_num; i++) {
-        int even_num = 2;
-        uint64_t tmp1 = blocks[i * even_num];
-        uint64_t tmp2 = blocks[i * even_num + 1];
-
-        int8_t bits_31 = 31;
-        tmp1 *= c1;
-        tmp1  = rotating_left(tmp1, bits_31);
-        tmp1 *= c2;
-        has ^= tmp1;
-
-        int8_t bits_27 = 27;
-        has = rotating_left(has, bits_27);
-        has += hax;
-        // increase randomness by mul by 5 and adding a constant
-        has = has * 5 + 1390208809;
-
-        int8_t bits_33 = 33;
-        tmp2 *= c2;
-        tmp2  = rotating_left(tmp2, bits_33);
-        tmp2 *= c1;
-        hax ^= tmp2;
-
-        hax = rotating_left(hax, bits_31);
-        hax += has;
-        // increase randomness by mul by 5 and adding a constant
-        hax = hax * 5 + 944331445;
-    }
-
-    // the length of each block is 16 bytes
-    const uint8_t *tail = (const uint8_t*)(data + block_num * 16);
-    uint64_t t1 = 0;
-    uint64_t t2 = 0;
-    // because the size of a block is 16, different offsets are calculated for tail blocks
-    // for different sizes
-    switch (static_cast<uint64_t>(len) & 15) {
-        case 15:
-            t2 ^= ((uint64_t)tail[14]) << 48;
-            [[fallthrough]];;
-        case 14:
-            t2 ^= ((uint64_t)tail[13]) << 40;
-            [[fallthrough]];;
-        case 13:
-            t2 ^= ((uint64_t)tail[12]) << 32;
-            [[fallthrough]];;
-        case 12:
-            t2 ^= ((uint64_t)tail[11]) << 24;
-            [[fallthrough]];;
-        case 11:
-            t2 ^= ((uint64_t)tail[10]) << 16;
-            [[fallthrough]];;
-        case 10:
-            t2 ^= ((uint64_t)tail[9]) << 8;
-            [[fallthrough]];;
-        case 9:
-            t2 ^= ((uint64_t)tail[8]) << 0;
-            t2 *= c2;
-            t2 = rotating_left(t2, 33);
-            t2 *= c1;
-            hax ^= t2;
-            [[fallthrough]];;
-        case 8:
-            t1 ^= ((uint64_t)tail[7]) << 56;
-            [[fallthrough]];;
-        case 7:
-            t1 ^= ((uint64_t)tail[6]) << 48;
-            [[fallthrough]];;
-        case 6:
-            t1 ^= ((uint64_t)tail[5]) << 40;
-            [[fallthrough]];;
-        case 5:
-            t1 ^= ((uint64_t)tail[4]) << 32;
-            [[fallthrough]];;
-        case 4:
-            t1 ^= ((uint64_t)tail[3]) << 24;
-            [[fallthrough]];;
-        case 3:
-            t1 ^= ((uint64_t)tail[2]) << 16;
-            [[fallthrough]];;
-        case 2:
-            t1 ^= ((uint64_t)tail[1]) << 8;
-            [[fallthrough]];;
-        case 1:
-            t1 ^= ((uint64_t)tail[0]) << 0;
-            t1 *= c1;
-            t1 = rotating_left(t1, 31);
-            t1 *= c2;
-            has ^= t1;
-            [[fallthrough]];;
-        default:
-            [[fallthrough]];;
-    };
-
-    has ^= static_cast<uint64_t>(len);
-    hax ^= static_cast<uint64_t>(len);
-
-    has += hax;
-    hax += has;
-
-    has = mixture(has);
-    hax = mixture(hax);
-
-    has += hax;
-    hax += has;
-    return hax;
+    g_param_hasher.Reset();
+    g_cache_tensor_addr = cache_tensor_addr;
 }
 
 uint64_t calc_hash_id()
 {
-    if (g_hash_offset == g_hash_buf_max_size) {
-        return 0;
-    }
-    uint64_t hash_id = gen_hash(g_hash_buf, g_hash_offset);
-    return hash_id;
+    return g_param_hasher.Digest();
 }
 
 void *GetOpApiFuncAddrFromFeatureLib(const char *api_name)
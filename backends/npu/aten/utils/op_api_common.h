@@ -27,6 +27,8 @@
 #include "csrc/aten/generated/NPUNativeFunctions.h"
 #include "csrc/backend/NPUStream.h"
 #include "aten/utils/KernelNpuOutputSize.h"
+#include "aten/utils/OpApiCacheCounters.h"
+#include "aten/utils/OpApiHasher.h"
 #include "aten/utils/OpConstants.h"
 #include "aten/utils/OpUtils.h"
 #include "framework/OpCommand.h"
@@ -72,10 +74,7 @@ typedef int (*_aclDestroyScalarList)(const aclScalarList* array);
 
 using OpApiFunc = int (*)(void*, uint64_t, aclOpExecutor*, const aclrtStream);
 
-constexpr int g_hash_buf_size = 8192;
-constexpr int g_hash_buf_max_size = g_hash_buf_size + 1024;
-extern thread_local char g_hash_buf[g_hash_buf_size];
-extern thread_local int g_hash_offset;
+extern thread_local at_npu::native::OpApiHasher g_param_hasher;
 extern const std::vector<std::string> g_custom_lib_path;
 extern const std::vector<std::string> g_default_custom_lib_path;
 
@@ -84,14 +83,6 @@ std::string real_path(const std::string& path);
 #define GET_OP_API_FUNC(apiName) \
   reinterpret_cast<_##apiName>(GetOpApiFuncAddr(#apiName))
 
-#define MEMCPY_TO_BUF(data_expression, size_expression)                 \
-  if (g_hash_offset + (size_expression) > g_hash_buf_size) {            \
-    g_hash_offset = g_hash_buf_max_size;                                \
-    return;                                                             \
-  }                                                                     \
-  memcpy(g_hash_buf + g_hash_offset, data_expression, size_expression); \
-  g_hash_offset += size_expression;
-
 inline const char* GetOpApiLibName(void) {
   return "libopapi.so";
 }
@@ -494,13 +485,12 @@ auto ConvertToOpApiFunc(const Tuple& params, void* opApiAddr) {
 
 template <std::size_t N>
 void add_param_to_buf(const std::array<bool, N>& value) {
-  MEMCPY_TO_BUF(
-      value.data(), static_cast<int64_t>(value.size() * sizeof(bool)));
+  g_param_hasher.AddBytes(value.data(), value.size() * sizeof(bool));
 }
 
 template <typename T>
 void add_param_to_buf(const T& value) {
-  MEMCPY_TO_BUF(&value, sizeof(T));
+  g_param_hasher.AddBytes(&value, sizeof(T));
 }
 
 void add_param_to_buf(const at::Tensor&);
@@ -524,6 +514,7 @@ void add_param_to_buf(const T& arg, Args&... args) {
   add_param_to_buf(args...);
 }
 
+void init_hash_buf(bool cache_tensor_addr);
 uint64_t calc_hash_id();
 
 #define DO_COMPATIBILITY(aclnn_api, originCallExpression)                      \
@@ -588,14 +579,22 @@ bool hit_cache(
   if (!has_func || !can_use) {
     return false;
   }
+  using Outcome = at_npu::native::OpApiCacheCounters::Outcome;
+  auto& op_api_cache = at_npu::native::OpApiCacheCounters::GetInstance();
   uint64_t workspace_size = 0;
   uint64_t* workspace_size_addr = &workspace_size;
   initPTACacheThreadLocalFunc();
-  g_hash_offset = 0;
+  init_hash_buf(true);
   add_param_to_buf(std::string(aclnn_api), args...);
   uint64_t hashId = calc_hash_id();
   setPTAHashKeyFunc(hashId);
   aclOpExecutor* executor = ptaGetExecCacheFunc(hashId, workspace_size_addr);
+  if (hashId == 0) {
+    op_api_cache.Count(aclnn_api, Outcome::BYPASS);
+  } else {
+    op_api_cache.Count(
+        aclnn_api, executor != nullptr ? Outcome::HIT : Outcome::MISS);
+  }
   if (executor == nullptr) {
     return false;
   }
@@ -1,5 +1,7 @@
 #include "core/NPUQueue.h"
+#include "core/interface/AsyncTaskQueueInterface.h"
 #include "core/npu_log.h"
+#include "core/register/OptionsManager.h"
 #include "csrc/backend/NPUFunctions.h"
 #include "csrc/backend/NPUStream.h"
 #include "framework/OpParamMaker.h"
@@ -8,15 +10,12 @@
 #include <ATen/record_function.h>
 #include <sys/eventfd.h>
 #include <sys/prctl.h>
-#include <sys/time.h>
 #include <unistd.h>
 #include <sstream>
 #include "acl/include/acl/acl_rt.h"
 
 namespace c10::npu {
 
-struct timeval delay = {0, 1};
-
 namespace {
 
 class CallBackManager {
@@ -167,6 +166,15 @@ NPUCallBackRegisterBuilder::NPUCallBackRegisterBuilder(
 static constexpr size_t kQueueCapacity = 4096;
 static std::string repo_error;
 
+// One task queue slot per device, sized for the devices found like the
+// stream pools. Queues are created on first use. The slots are leaked, since
+// ReleaseTaskQueues may run after static destruction.
+static std::once_flag task_queues_init;
+static std::atomic<NPUQueueBase*>* task_queues = nullptr;
+static std::atomic<c10::DeviceIndex> num_task_queues{0};
+static std::mutex task_queues_mutex;
+static thread_local bool is_task_queue_thread = false;
+
 std::string get_func_error_msg(void* error_paras) {
   auto queueParam = static_cast<c10::npu::queue::QueueParas*>(error_paras);
   auto type = queueParam->paramType;
@@ -234,93 +242,119 @@ NPUStatus Repository::MakeSureQueueEmpty() {
   if (consumer.joinable()) {
     ssize_t s;
     uint64_t u = 1;
+    std::lock_guard<std::mutex> lock(mu_empty);
     while (!IsEmptyQueue()) {
-      std::lock_guard<std::mutex> lock(mu_empty);
-      need_empty = true;
-      __sync_synchronize();
-      if (!IsEmptyQueue()) { // double-check, very important idea
+      need_empty.store(true);
+      // The consumer publishes read_idx before it looks at need_empty, so
+      // either it sees the flag or this check sees the queue empty.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (!IsEmptyQueue()) {
         s = eventfd_read(efd_empty, &u);
         if (s != 0) {
           if (errno == EINTR) {
             continue;
           }
+          need_empty.store(false);
           ASCEND_LOGE(
               "eventfd_read failed. s=%zd, errno=%s.", s, strerror(errno));
           return INTERNEL_ERROR;
         }
       }
-      need_empty = false;
+      need_empty.store(false);
     }
   }
 
   if (GetStatus() == RepoStatus::ERROR_EXIT) {
-    // Avoid repeatedly throwing exceptions
-    SetStatus(CAN_EXIT);
-    read_idx.idx = write_idx.idx;
-    throw std::runtime_error(
-        "The Inner error is reported as above. "
-        "The process exits for this inner error, and " +
-        repo_error + ".\n" +
-        "Since the operator is called asynchronously, the stacktrace may be inaccurate. "
-        "If you want to get the accurate stacktrace, "
-        "pleace set the environment variable ASCEND_LAUNCH_BLOCKING=1." +
-        PTA_ERROR(ErrCode::ACL));
+    ThrowErrorExit();
   }
 
   return SUCCESS;
 }
 
 bool Repository::WriteQueue(void* cur_paras) {
-  std::lock_guard<std::mutex> lock(mu_enqueue);
-  if (IsFullQueue()) {
+  auto idx = write_idx.load(std::memory_order_relaxed);
+  auto next_idx = (idx + 1) & (kQueueCapacity - 1);
+  // Acquire pairs with the consumer's release of read_idx, the slot is no
+  // longer touched by the consumer once it is observed as free.
+  if (next_idx == read_idx.load(std::memory_order_acquire)) {
     return false;
   }
 
-  __sync_synchronize();
-  manager().Copy(datas, write_idx.idx, cur_paras);
-  __sync_synchronize();
-
-  write_idx.idx = (write_idx.idx + 1) & (kQueueCapacity - 1);
+  manager().Copy(datas, idx, cur_paras);
+  write_idx.store(next_idx, std::memory_order_release);
   return true;
 }
 
-bool Repository::ReadQueue() {
-  if (IsEmptyQueue()) {
-    return false;
-  }
-
-  __sync_synchronize();
-  auto ret = manager().Call(datas, read_idx.idx);
+bool Repository::ReadQueue(unsigned int idx) {
+  auto ret = manager().Call(datas, idx);
   if (ret != 0) {
-    repo_error =
-        get_func_error_msg(manager().getCurrentParams(datas, read_idx.idx));
+    repo_error = get_func_error_msg(manager().getCurrentParams(datas, idx));
     ASCEND_LOGE(
         "---Thread---%llu: device = %d, write_idx = %u, read_idx = %u, status = %d, ret = %d",
         std::this_thread::get_id(),
         device_idx,
-        write_idx.idx,
-        read_idx.idx,
+        write_idx.load(),
+        idx,
         GetStatus(),
         ret);
-    while (!IsEmptyQueue()) { // ignore other tasks
-      manager().Release(datas, read_idx.idx, releaseQueue);
-      read_idx.idx = (read_idx.idx + 1) & (kQueueCapacity - 1);
+    auto end_idx = write_idx.load(std::memory_order_acquire);
+    while (idx != end_idx) { // ignore other tasks
+      manager().Release(datas, idx, releaseQueue);
+      idx = (idx + 1) & (kQueueCapacity - 1);
     }
-
+    // Dropped record tasks will never reach the device, don't let queries
+    // on their events wait for them.
+    c10::npu::queue::ClearPendingEventRecords(device_idx);
     SetStatus(ERROR_EXIT);
-    read_idx.idx = write_idx.idx;
-    __sync_synchronize();
+    read_idx.store(end_idx);
     eventfd_write(efd_empty, 1);
     eventfd_write(efd_write, 1);
     return false;
   }
 
-  manager().Release(datas, read_idx.idx, releaseQueue);
-  __sync_synchronize();
+  manager().Release(datas, idx, releaseQueue);
+  return true;
+}
 
-  read_idx.idx = (read_idx.idx + 1) & (kQueueCapacity - 1);
+void Repository::NotifyConsumer() {
+  while (eventfd_write(efd_read, 1) != 0) {
+    if (errno != EINTR) {
+      ASCEND_LOGE("notify consumer failed!! errno=%s", strerror(errno));
+      return;
+    }
+  }
+}
 
-  return true;
+void Repository::NotifyProducer() {
+  while (eventfd_write(efd_write, 1) != 0) {
+    if (errno != EINTR) {
+      ASCEND_LOGE("notify producer failed. errno=%s.", strerror(errno));
+      return;
+    }
+  }
+}
+
+void Repository::NotifyEmpty() {
+  while (eventfd_write(efd_empty, 1) != 0) {
+    if (errno != EINTR) {
+      ASCEND_LOGE("notify make_sure failed. errno=%s.", strerror(errno));
+      return;
+    }
+  }
+}
+
+void Repository::ThrowErrorExit() {
+  // Avoid repeatedly throwing exceptions
+  SetStatus(CAN_EXIT);
+  read_idx.store(write_idx.load());
+  throw std::runtime_error(
+      "The Inner error is reported as above. "
+      "The process exits for this inner error, and " +
+      repo_error + ".\n" +
+      "Since the operator is called asynchronously, the stacktrace may be inaccurate. "
+      "If you want to get the accurate stacktrace, "
+      "pleace set the environment variable ASCEND_LAUNCH_BLOCKING=1." +
+      PTA_ERROR(ErrCode::ACL));
 }
 
 void Repository::Enqueue(void* cur_paras) {
@@ -330,62 +364,47 @@ void Repository::Enqueue(void* cur_paras) {
   }
 
   if (GetStatus() == RepoStatus::ERROR_EXIT) {
-    // Avoid repeatedly throwing exceptions
-    SetStatus(CAN_EXIT);
-    read_idx.idx = write_idx.idx;
-    throw std::runtime_error(
-        "The Inner error is reported as above. "
-        "The process exits for this inner error, and " +
-        repo_error + ".\n" +
-        "Since the operator is called asynchronously, the stacktrace may be inaccurate. "
-        "If you want to get the accurate stacktrace, "
-        "pleace set the environment variable ASCEND_LAUNCH_BLOCKING=1." +
-        PTA_ERROR(ErrCode::ACL));
+    ThrowErrorExit();
   }
 
   if (GetStatus() != RUN && GetStatus() != INIT) {
     ASCEND_LOGE("Task queue thread is exit, cann't call Enqueue(). !!");
     return;
   }
-  bool ret = false;
+
+  while (producer_lock.test_and_set(std::memory_order_acquire)) {
+    std::this_thread::yield();
+  }
   ssize_t s;
   uint64_t u = 1;
-
-  SetWriteWorking(true);
-  while (ret == false) {
-    ret = WriteQueue(cur_paras);
-    if (ret == false) {
-      SetWriteWorking(false);
-      __sync_synchronize();
-      if (IsFullQueue()) {
-        s = eventfd_read(efd_write, &u);
-        if (s != 0) {
-          if (errno == EINTR) {
-            continue;
-          }
-          ASCEND_LOGE(
-              "waiting dequeue failed. s=%zd, errno=%s.", s, strerror(errno));
-          return;
-        }
-        SetWriteWorking(true);
-      }
-      continue;
+  while (!WriteQueue(cur_paras)) {
+    if (GetStatus() == RepoStatus::ERROR_EXIT) {
+      // The consumer failed while the ring was full, the task is dropped.
+      producer_lock.clear(std::memory_order_release);
+      ThrowErrorExit();
     }
-    __sync_synchronize();
-    while (!IsReadWorking()) {
-      s = eventfd_write(efd_read, u);
-      if (s != 0) {
-        if (errno == EINTR) {
-          continue;
-        }
+    producer_parked.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (IsFullQueue()) {
+      s = eventfd_read(efd_write, &u);
+      if (s != 0 && errno != EINTR) {
+        producer_parked.store(false);
+        producer_lock.clear(std::memory_order_release);
         ASCEND_LOGE(
-            "notify consumer failed!! s=%zd, errno=%s", s, strerror(errno));
+            "waiting dequeue failed. s=%zd, errno=%s.", s, strerror(errno));
         return;
       }
-      break;
     }
+    producer_parked.store(false);
+  }
+  producer_lock.clear(std::memory_order_release);
+
+  // Pairs with the fence in Dequeue(), a consumer that parks after this
+  // point sees the new write_idx, otherwise it is woken up here.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_parked.load(std::memory_order_relaxed)) {
+    NotifyConsumer();
   }
-  SetWriteWorking(false);
 }
 
 void Repository::Dequeue() {
@@ -394,70 +413,46 @@ void Repository::Dequeue() {
     return;
   }
 
-  bool ret = false;
-  bool notify_empty = false;
-  ssize_t s;
-  uint64_t u = 1;
-
-  SetReadWorking(true);
-  while (ret == false && GetStatus() != RepoStatus::CAN_EXIT) {
-    ret = ReadQueue();
-    if (ret == false) {
-      if (GetStatus() == RepoStatus::NEED_EXIT) {
-        ChangeStatus(NEED_EXIT, CAN_EXIT);
-        break;
-      }
-
-      if (GetStatus() == RepoStatus::ERROR_EXIT) {
-        break;
-      }
-
-      SetReadWorking(false);
-      __sync_synchronize();
-      if (IsEmptyQueue()) {
-        s = eventfd_read(efd_read, &u);
-        if (s != 0) {
-          if (errno == EINTR) {
-            continue;
-          }
-          ASCEND_LOGE(
-              "waiting enqueue failed. s=%zd, errno=%s.", s, strerror(errno));
-          return;
-        }
-        SetReadWorking(true);
-      }
-      continue;
+  auto idx = read_idx.load(std::memory_order_relaxed);
+  auto end_idx = write_idx.load(std::memory_order_acquire);
+  if (idx == end_idx) {
+    if (GetStatus() == RepoStatus::NEED_EXIT) {
+      ChangeStatus(NEED_EXIT, CAN_EXIT);
+      return;
     }
-    __sync_synchronize();
-    notify_empty = need_empty &&
-        IsEmptyQueue(); // need_empty && (ret == false || IsEmptyQueue());
-    while (notify_empty) {
-      s = eventfd_write(efd_empty, u);
-      if (s != 0) {
-        if (errno == EINTR) {
-          continue;
-        }
+    consumer_parked.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (IsEmptyQueue() && GetStatus() != RepoStatus::NEED_EXIT) {
+      uint64_t u = 1;
+      ssize_t s = eventfd_read(efd_read, &u);
+      if (s != 0 && errno != EINTR) {
         ASCEND_LOGE(
-            "notify make_sure failed. s=%zd, errno=%s.", s, strerror(errno));
-        return;
+            "waiting enqueue failed. s=%zd, errno=%s.", s, strerror(errno));
       }
-      break;
     }
-    __sync_synchronize();
-    while (!IsWriteWorking()) {
-      s = eventfd_write(efd_write, u);
-      if (s != 0) {
-        if (errno == EINTR) {
-          continue;
-        }
-        ASCEND_LOGE(
-            "notify producer failed. s=%zd, errno=%s.", s, strerror(errno));
-        return;
-      }
-      break;
+    consumer_parked.store(false, std::memory_order_relaxed);
+    return;
+  }
+
+  // Launch everything published so far in one pass, refreshing the end
+  // whenever it is reached so a busy producer never lets the consumer park.
+  while (idx != end_idx) {
+    if (!ReadQueue(idx)) {
+      return;
+    }
+    idx = (idx + 1) & (kQueueCapacity - 1);
+    read_idx.store(idx, std::memory_order_release);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (producer_parked.load(std::memory_order_relaxed)) {
+      NotifyProducer();
+    }
+    if (idx == end_idx) {
+      end_idx = write_idx.load(std::memory_order_acquire);
     }
   }
-  SetReadWorking(false);
+  if (need_empty.load(std::memory_order_relaxed)) {
+    NotifyEmpty();
+  }
 }
 
 void Repository::ReleaseResource() {
@@ -489,7 +484,7 @@ Repository::~Repository() {
 }
 
 bool Repository::IsFullQueue() const {
-  return ((write_idx.idx + 1) & (kQueueCapacity - 1)) == read_idx.idx;
+  return ((write_idx.load() + 1) & (kQueueCapacity - 1)) == read_idx.load();
 }
 
 bool Repository::CheckInit() const {
@@ -500,6 +495,7 @@ void StartConsume(Repository* repo, c10::DeviceIndex device_id) {
   if (prctl(PR_SET_NAME, ("ACL_thread")) != 0) {
     ASCEND_LOGE("set thread name failed!");
   }
+  is_task_queue_thread = true;
 
   aclError ret = c10::backend::SetDevice(device_id);
   if (ret != 0) {
@@ -541,23 +537,126 @@ std::string Repository::GetPara() {
   if (IsEmptyQueue()) {
     return "EmptyQueue";
   }
-  __sync_synchronize();
-  std::string repo_para =
-      get_func_error_msg(manager().getCurrentParams(datas, read_idx.idx));
-  __sync_synchronize();
+  std::string repo_para = get_func_error_msg(manager().getCurrentParams(
+      datas, read_idx.load(std::memory_order_acquire)));
   return repo_para;
 }
 
+std::string Repository::GetReleasePara() {
+  return releaseQueue.GetPara();
+}
+
+static c10::DeviceIndex GetTaskQueueDevice(c10::DeviceIndex device_index) {
+  std::call_once(task_queues_init, [] {
+    c10::DeviceIndex count = c10::backend::device_count();
+    task_queues = new std::atomic<NPUQueueBase*>[count]();
+    num_task_queues.store(count, std::memory_order_release);
+  });
+  if (device_index == -1) {
+    NPU_CHECK_ERROR(c10::backend::GetDevice(&device_index));
+  }
+  TORCH_CHECK(
+      device_index >= 0 &&
+          device_index < num_task_queues.load(std::memory_order_relaxed),
+      "Invalid device index ",
+      device_index,
+      " for task queue.",
+      PTA_ERROR(ErrCode::VALUE));
+  return device_index;
+}
+
+NPUQueueBase* GetTaskQueue(c10::DeviceIndex device_index) {
+  if (!c10::npu::option::OptionsManager::CheckQueueEnable()) {
+    return nullptr;
+  }
+  device_index = GetTaskQueueDevice(device_index);
+  auto queue = task_queues[device_index].load(std::memory_order_acquire);
+  if (C10_LIKELY(queue != nullptr)) {
+    return queue;
+  }
+
+  std::lock_guard<std::mutex> lock(task_queues_mutex);
+  queue = task_queues[device_index].load(std::memory_order_relaxed);
+  if (queue == nullptr) {
+    queue = new Repository();
+    queue->InitRepo(device_index);
+    task_queues[device_index].store(queue, std::memory_order_release);
+  }
+  return queue;
+}
+
+void DrainTaskQueue(c10::DeviceIndex device_index) {
+  if (!c10::npu::option::OptionsManager::CheckQueueEnable() ||
+      is_task_queue_thread) {
+    return;
+  }
+  device_index = GetTaskQueueDevice(device_index);
+  auto queue = task_queues[device_index].load(std::memory_order_acquire);
+  if (queue == nullptr) {
+    return;
+  }
+  NPUStatus ret = queue->MakeSureQueueEmpty();
+  TORCH_CHECK(
+      ret == SUCCESS,
+      "MakeSureQueueEmpty fail on device ",
+      device_index,
+      ", ret: ",
+      ret,
+      PTA_ERROR(ErrCode::INTERNAL));
+}
+
+void DrainAllTaskQueues() {
+  if (!c10::npu::option::OptionsManager::CheckQueueEnable() ||
+      is_task_queue_thread) {
+    return;
+  }
+  // No queue exists before the slots are sized.
+  c10::DeviceIndex count = num_task_queues.load(std::memory_order_acquire);
+  for (c10::DeviceIndex i = 0; i < count; i++) {
+    if (task_queues[i].load(std::memory_order_acquire) != nullptr) {
+      DrainTaskQueue(i);
+    }
+  }
+}
+
+void ReleaseTaskQueues() {
+  std::lock_guard<std::mutex> lock(task_queues_mutex);
+  c10::DeviceIndex count = num_task_queues.load(std::memory_order_acquire);
+  for (c10::DeviceIndex i = 0; i < count; i++) {
+    auto queue = task_queues[i].exchange(nullptr, std::memory_order_acq_rel);
+    if (queue == nullptr) {
+      continue;
+    }
+    try {
+      queue->MakeSureQueueEmpty();
+    } catch (std::exception& e) {
+      ASCEND_LOGE("Drain task queue on exit failed: %s", e.what());
+    }
+    delete queue;
+  }
+}
+
+bool IsTaskQueueThread() {
+  return is_task_queue_thread;
+}
+
 static constexpr size_t kReleaseQueueCapacity = 8192;
 bool ReleaseQueue::WriteToReleaseQueue(void* cur_paras) {
-  if (IsFullQueue()) {
+  auto idx = write_idx.load(std::memory_order_relaxed);
+  auto next_idx = (idx + 1) & (kReleaseQueueCapacity - 1);
+  auto cur_read_idx = read_idx.load(std::memory_order_acquire);
+  if (next_idx == cur_read_idx) {
     return false;
   }
-  __sync_synchronize();
-  releaseManager().CopyRealseParam(datas, write_idx.idx, cur_paras);
 
-  __sync_synchronize();
-  write_idx.idx = (write_idx.idx + 1) & (kReleaseQueueCapacity - 1);
+  releaseManager().CopyRealseParam(datas, idx, cur_paras);
+  write_idx.store(next_idx, std::memory_order_release);
+
+  queued_count.fetch_add(1, std::memory_order_relaxed);
+  uint64_t depth = (next_idx - cur_read_idx) & (kReleaseQueueCapacity - 1);
+  if (depth > max_depth.load(std::memory_order_relaxed)) {
+    max_depth.store(depth, std::memory_order_relaxed);
+  }
   return true;
 }
 
@@ -568,27 +667,33 @@ void ReleaseQueue::PushToReleaseQueue(void* cur_paras) {
     return;
   }
 
-  bool ret = false;
-  while (ret == false) {
-    ret = WriteToReleaseQueue(cur_paras);
-    if (ret == true) {
-      break;
+  uint64_t u = 1;
+  bool stalled = false;
+  while (!WriteToReleaseQueue(cur_paras)) {
+    if (!stalled) {
+      producer_stalls.fetch_add(1, std::memory_order_relaxed);
+      stalled = true;
     }
+    producer_parked.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (IsFullQueue()) {
+      ssize_t s = eventfd_read(efd_write, &u);
+      if (s != 0 && errno != EINTR) {
+        producer_parked.store(false);
+        ASCEND_LOGE(
+            "waiting release failed. s=%zd, errno=%s.", s, strerror(errno));
+        return;
+      }
+    }
+    producer_parked.store(false);
   }
-}
 
-bool ReleaseQueue::ReadFromReleaseQueue() {
-  if (IsEmptyQueue()) {
-    return false;
+  // Pairs with the fence in PopFromReleaseQueue().
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (consumer_parked.load(std::memory_order_relaxed)) {
+    while (eventfd_write(efd_read, u) != 0 && errno == EINTR) {
+    }
   }
-
-  __sync_synchronize();
-  releaseManager().ReleaseParam(datas, read_idx.idx);
-
-  __sync_synchronize();
-  read_idx.idx = (read_idx.idx + 1) & (kReleaseQueueCapacity - 1);
-
-  return true;
 }
 
 void ReleaseQueue::PopFromReleaseQueue() {
@@ -598,16 +703,43 @@ void ReleaseQueue::PopFromReleaseQueue() {
     return;
   }
 
-  bool ret = false;
-  while ((ret == false) && (GetStatus() != RepoStatus::CAN_EXIT)) {
-    ret = ReadFromReleaseQueue();
-    if (ret == false) {
-      if (GetStatus() == RepoStatus::NEED_EXIT) {
-        ChangeStatus(NEED_EXIT, CAN_EXIT);
-        break;
+  uint64_t u = 1;
+  auto idx = read_idx.load(std::memory_order_relaxed);
+  auto end_idx = write_idx.load(std::memory_order_acquire);
+  if (idx == end_idx) {
+    if (GetStatus() == RepoStatus::NEED_EXIT) {
+      ChangeStatus(NEED_EXIT, CAN_EXIT);
+      return;
+    }
+    consumer_parked.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (IsEmptyQueue() && GetStatus() != RepoStatus::NEED_EXIT) {
+      ssize_t s = eventfd_read(efd_read, &u);
+      if (s != 0 && errno != EINTR) {
+        ASCEND_LOGE(
+            "waiting release task failed. s=%zd, errno=%s.",
+            s,
+            strerror(errno));
       }
-      delay.tv_usec = 1;
-      select(0, nullptr, nullptr, nullptr, &delay);
+    }
+    consumer_parked.store(false, std::memory_order_relaxed);
+    return;
+  }
+
+  // Free the whole batch before handing the slots back, the producer is
+  // woken at most once per batch.
+  uint64_t freed = 0;
+  while (idx != end_idx) {
+    releaseManager().ReleaseParam(datas, idx);
+    idx = (idx + 1) & (kReleaseQueueCapacity - 1);
+    freed++;
+  }
+  read_idx.store(idx, std::memory_order_release);
+  freed_count.fetch_add(freed, std::memory_order_relaxed);
+
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (producer_parked.load(std::memory_order_relaxed)) {
+    while (eventfd_write(efd_write, u) != 0 && errno == EINTR) {
     }
   }
 }
@@ -628,6 +760,9 @@ void ReleaseQueue::InitReleaseQueue() {
     datas = releaseManager().Init(kReleaseQueueCapacity);
   }
 
+  efd_read = eventfd(0, 0);
+  efd_write = eventfd(0, 0);
+
   initialized = true;
   SetStatus(INIT);
   std::thread cur_releaser(StartRelease, this);
@@ -638,14 +773,33 @@ ReleaseQueue::~ReleaseQueue() {
   if (initialized) {
     if (releaser.joinable()) {
       SetStatus(NEED_EXIT);
+      (void)eventfd_write(efd_read, 1); // escape wait
       releaser.join();
     }
+    if (efd_read > 0) {
+      close(efd_read);
+      efd_read = -1;
+    }
+    if (efd_write > 0) {
+      close(efd_write);
+      efd_write = -1;
+    }
   }
   releaseManager().DeInit(datas);
 }
 
 bool ReleaseQueue::IsFullQueue() const {
-  return ((write_idx.idx + 1) % kReleaseQueueCapacity) == read_idx.idx;
+  return ((write_idx.load() + 1) & (kReleaseQueueCapacity - 1)) ==
+      read_idx.load();
+}
+
+std::string ReleaseQueue::GetPara() const {
+  std::stringstream result;
+  result << "release queue: queued=" << queued_count.load()
+         << ", freed=" << freed_count.load()
+         << ", max_depth=" << max_depth.load()
+         << ", producer_stalls=" << producer_stalls.load();
+  return result.str();
 }
 
 RepoStatus ReleaseQueue::GetStatus() const {
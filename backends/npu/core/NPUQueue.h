@@ -11,10 +11,8 @@
 
 namespace c10::npu {
 
-struct sring_idx {
-  bool working = false;
-  volatile unsigned int idx = 0;
-};
+// Keeps indexes written by different threads off each other's cache line.
+constexpr size_t kCacheLineSize = 64;
 
 enum RepoStatus {
   INIT = 0,
@@ -27,6 +25,9 @@ enum RepoStatus {
 // c10::SmallVector max size
 const int N = 32;
 
+// Hands launched task parameters to a worker thread that frees them, so the
+// ACL thread doesn't pay for destroying descriptors and host tensors. Both
+// sides park on an eventfd instead of polling.
 class ReleaseQueue {
  public:
   ReleaseQueue() = default;
@@ -35,25 +36,37 @@ class ReleaseQueue {
   void PopFromReleaseQueue();
   void InitReleaseQueue();
   RepoStatus GetStatus() const;
+  // Worker counters: queued, freed, max depth and producer stalls.
+  std::string GetPara() const;
 
  private:
-  inline bool IsEmptyQueue() {
-    return read_idx.idx == write_idx.idx;
+  inline bool IsEmptyQueue() const {
+    return read_idx.load(std::memory_order_acquire) ==
+        write_idx.load(std::memory_order_acquire);
   };
   bool IsFullQueue() const;
   bool WriteToReleaseQueue(void* cur_paras);
-  bool ReadFromReleaseQueue();
   void SetStatus(RepoStatus desired);
   void ChangeStatus(RepoStatus expected, RepoStatus desired);
 
  private:
   void* datas = nullptr;
   std::thread releaser;
+  int efd_read = -1;
+  int efd_write = -1;
 
  private:
-  sring_idx read_idx;
-  sring_idx write_idx;
-  std::atomic<RepoStatus> repo_status;
+  // Written by the producer (the ACL thread) only.
+  alignas(kCacheLineSize) std::atomic<unsigned int> write_idx{0};
+  std::atomic<bool> producer_parked{false};
+  std::atomic<uint64_t> queued_count{0};
+  std::atomic<uint64_t> max_depth{0};
+  std::atomic<uint64_t> producer_stalls{0};
+  // Written by the release worker only.
+  alignas(kCacheLineSize) std::atomic<unsigned int> read_idx{0};
+  std::atomic<bool> consumer_parked{false};
+  std::atomic<uint64_t> freed_count{0};
+  alignas(kCacheLineSize) std::atomic<RepoStatus> repo_status;
   bool initialized = false;
 };
 
@@ -69,6 +82,7 @@ class NPUQueueBase {
   virtual void InitRepo(c10::DeviceIndex device_id) = 0;
   virtual bool CheckInit() const = 0;
   virtual std::string GetPara() = 0;
+  virtual std::string GetReleasePara() = 0;
 };
 
 class NPUQueueFactoryBase {
@@ -77,6 +91,9 @@ class NPUQueueFactoryBase {
   virtual ~NPUQueueFactoryBase() {}
 };
 
+// Single-consumer ring of launch tasks. Indexes are published with
+// acquire/release ordering, the consumer launches everything available in
+// one pass and eventfds are only touched when the other side is parked.
 class Repository : public NPUQueueBase {
  public:
   Repository() = default;
@@ -90,27 +107,22 @@ class Repository : public NPUQueueBase {
   void InitRepo(c10::DeviceIndex device_id) override;
   bool CheckInit() const override;
   std::string GetPara() override;
+  std::string GetReleasePara() override;
 
  private:
   void ReleaseResource();
-  inline bool IsEmptyQueue() {
-    return read_idx.idx == write_idx.idx;
+  inline bool IsEmptyQueue() const {
+    return read_idx.load(std::memory_order_acquire) ==
+        write_idx.load(std::memory_order_acquire);
   };
   bool IsFullQueue() const;
-  void SetWriteWorking(bool isWorking) {
-    write_idx.working = isWorking;
-  };
-  void SetReadWorking(bool isWorking) {
-    read_idx.working = isWorking;
-  };
-  bool IsWriteWorking() const {
-    return write_idx.working;
-  };
-  bool IsReadWorking() const {
-    return read_idx.working;
-  };
   bool WriteQueue(void* cur_paras);
-  bool ReadQueue();
+  bool ReadQueue(unsigned int idx);
+  void NotifyConsumer();
+  void NotifyProducer();
+  void NotifyEmpty();
+  // Reports the error the consumer stopped on and lets the queue exit.
+  [[noreturn]] void ThrowErrorExit();
 
  private:
   void* datas = nullptr;
@@ -121,19 +133,38 @@ class Repository : public NPUQueueBase {
   c10::DeviceIndex device_idx;
 
  private:
-  sring_idx read_idx;
-  sring_idx write_idx;
-  std::atomic<RepoStatus> repo_status;
-  bool need_empty = false;
+  // Written by producers only.
+  alignas(kCacheLineSize) std::atomic<unsigned int> write_idx{0};
+  std::atomic<bool> producer_parked{false};
+  // Written by the consumer only.
+  alignas(kCacheLineSize) std::atomic<unsigned int> read_idx{0};
+  std::atomic<bool> consumer_parked{false};
+  alignas(kCacheLineSize) std::atomic<RepoStatus> repo_status;
+  std::atomic<bool> need_empty{false};
   bool initialized = false;
   std::mutex mu_empty;
-  // In theory, this is not necessary.
-  // The logic is ensured by original pytorch, but this is added here just in
-  // case.
-  std::mutex mu_enqueue;
+  // Producers are normally a single thread per device, this keeps the ring
+  // single-producer for the rare case they are not without a blocking lock.
+  std::atomic_flag producer_lock = ATOMIC_FLAG_INIT;
   ReleaseQueue releaseQueue;
 };
 
+// Returns the task queue of the given device (the current device when -1),
+// creating it and starting its ACL thread on first use. Returns nullptr when
+// TASK_QUEUE_ENABLE is off.
+NPUQueueBase* GetTaskQueue(c10::DeviceIndex device_index = -1);
+
+// Blocks until every task enqueued so far on the device has been launched to
+// its stream. Does nothing if the queue of the device was never created, or
+// when called from an ACL thread itself.
+void DrainTaskQueue(c10::DeviceIndex device_index = -1);
+void DrainAllTaskQueues();
+
+// Drains and stops all task queues, must run before streams are destroyed.
+void ReleaseTaskQueues();
+
+bool IsTaskQueueThread();
+
 using ACL_EXEC_FUNC = std::function<int(void*)>;
 using ACL_COPY_FUNC = std::function<void(void*, void*)>;
 using ACL_RELEASE_FUNC = std::function<void(void*, ReleaseQueue&)>;
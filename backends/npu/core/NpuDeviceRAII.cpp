@@ -1,6 +1,7 @@
 #include "core/NpuDeviceRAII.h"
 #include "acl/include/acl/acl_op_compiler.h"
 #include "adapter/acl_device_adapter.h"
+#include "core/NPUQueue.h"
 #include "core/NpuVariables.h"
 #include "core/register/OptionRegister.h"
 #include "csrc/backend/NPUCachingAllocator.h"
@@ -48,6 +49,8 @@ NPUDeviceRAII::NPUDeviceRAII() : need_finalize_(true) {
 NPUDeviceRAII::~NPUDeviceRAII() {
   c10::backend::HostAllocator::emptyCache();
   c10::backend::Allocator::emptyCache();
+  // ACL threads launch onto the used streams, stop them first.
+  c10::npu::ReleaseTaskQueues();
 
   NPU_CHECK_WARN(c10::backend::DestroyUsedStreams());
   NPU_CHECK_WARN(acl_adapter::ResetUsedDevices());
@@ -1,7 +1,15 @@
 #include "AsyncTaskQueueInterface.h"
 #include <ATen/record_function.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "acl/include/acl/acl_rt.h"
+#include "core/NPUQueue.h"
 #include "core/register/OptionsManager.h"
+#include "csrc/backend/NPUFunctions.h"
+#include "csrc/backend/NPUGuard.h"
 
 namespace c10::npu {
 namespace queue {
@@ -28,6 +36,7 @@ void CopyParas::Copy(CopyParas& other) {
 void EventParas::Copy(EventParas& other) {
   this->event = other.event;
   this->eventAllocatorType = other.eventAllocatorType;
+  this->device_index = other.device_index;
 }
 
 class AsyncCopyTask {
@@ -62,6 +71,11 @@ void AsyncCopyTask::LaunchCopyTask() {
   RECORD_FUNCTION(
       CopyParas::COPY_PARAS_MAP[copyParam_.kind], std::vector<c10::IValue>({}));
   c10::backend::NPUStream stream = c10::backend::getCurrentNPUStream();
+  if (c10::npu::option::OptionsManager::CheckQueueEnable()) {
+    QueueParas params(ASYNC_MEMCPY, sizeof(CopyParas), &copyParam_);
+    EnqueueTask(params, stream);
+    return;
+  }
   NPU_CHECK_ERROR(aclrtMemcpyAsync(
       copyParam_.dst,
       copyParam_.dstLen,
@@ -82,5 +96,167 @@ aclError LaunchAsyncCopyTask(
   return ACL_ERROR_NONE;
 }
 
+namespace {
+struct PendingRecords {
+  // Record tasks of the device still queued, lets queries skip the lock
+  // when there are none.
+  std::atomic<int64_t> count{0};
+  std::mutex mutex;
+  std::unordered_map<aclrtEvent, int> records;
+};
+
+std::vector<std::unique_ptr<PendingRecords>>& allPendingRecords() {
+  static std::vector<std::unique_ptr<PendingRecords>> pending = []() {
+    std::vector<std::unique_ptr<PendingRecords>> per_device(
+        c10::backend::device_count());
+    for (auto& records : per_device) {
+      records = std::make_unique<PendingRecords>();
+    }
+    return per_device;
+  }();
+  return pending;
+}
+
+PendingRecords* pendingRecords(c10::DeviceIndex device_index) {
+  auto& pending = allPendingRecords();
+  if (device_index < 0 ||
+      static_cast<size_t>(device_index) >= pending.size()) {
+    return nullptr;
+  }
+  return pending[device_index].get();
+}
+
+bool IsPendingIn(PendingRecords& pending, aclrtEvent event) {
+  if (pending.count.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(pending.mutex);
+  return pending.records.find(event) != pending.records.end();
+}
+} // namespace
+
+bool IsEventRecordPending(aclrtEvent event, c10::DeviceIndex device_index) {
+  PendingRecords* pending = pendingRecords(device_index);
+  return pending != nullptr && IsPendingIn(*pending, event);
+}
+
+bool IsEventRecordPending(aclrtEvent event) {
+  for (auto& pending : allPendingRecords()) {
+    if (IsPendingIn(*pending, event)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+void MarkEventRecordLaunched(aclrtEvent event, c10::DeviceIndex device_index) {
+  PendingRecords* pending = pendingRecords(device_index);
+  if (pending == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(pending->mutex);
+  auto it = pending->records.find(event);
+  if (it == pending->records.end()) {
+    return;
+  }
+  pending->count.fetch_sub(1, std::memory_order_release);
+  if (--it->second <= 0) {
+    pending->records.erase(it);
+  }
+}
+
+void ClearPendingEventRecords(c10::DeviceIndex device_index) {
+  PendingRecords* pending = pendingRecords(device_index);
+  if (pending == nullptr) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(pending->mutex);
+  pending->records.clear();
+  pending->count.store(0, std::memory_order_release);
+}
+
+void EnqueueTask(QueueParas& paras, const c10::backend::NPUStream& stream) {
+  auto queue = c10::npu::GetTaskQueue(stream.device_index());
+  TORCH_CHECK(
+      queue != nullptr,
+      "Task queue is disabled, tasks should be launched directly.",
+      PTA_ERROR(ErrCode::INTERNAL));
+  paras.paramStream = stream.stream();
+  paras.correlation_id = QueueParas::g_correlation_id++;
+  queue->Enqueue(&paras);
+}
+
+aclError LaunchRecordEventTask(
+    aclrtEvent event,
+    const c10::backend::NPUStream& stream,
+    EventAllocatorType allocatorType) {
+  if (!c10::npu::option::OptionsManager::CheckQueueEnable()) {
+    c10::backend::NPUGuard guard(stream.device_index());
+    return aclrtRecordEvent(event, stream);
+  }
+  RECORD_FUNCTION(
+      EventParas::EVENT_PARAS_MAP[RECORD_EVENT], std::vector<c10::IValue>({}));
+  const c10::DeviceIndex device_index = stream.device_index();
+  PendingRecords* pending = pendingRecords(device_index);
+  TORCH_CHECK(
+      pending != nullptr,
+      "Invalid device index ",
+      device_index,
+      " for an event record task",
+      PTA_ERROR(ErrCode::VALUE));
+  {
+    std::lock_guard<std::mutex> lock(pending->mutex);
+    pending->records[event]++;
+    pending->count.fetch_add(1, std::memory_order_release);
+  }
+  EventParas eventParam(event, allocatorType);
+  eventParam.device_index = device_index;
+  QueueParas params(RECORD_EVENT, sizeof(EventParas), &eventParam);
+  try {
+    EnqueueTask(params, stream);
+  } catch (...) {
+    MarkEventRecordLaunched(event, device_index);
+    throw;
+  }
+  return ACL_ERROR_NONE;
+}
+
+aclError LaunchWaitEventTask(
+    aclrtEvent event,
+    const c10::backend::NPUStream& stream,
+    EventAllocatorType allocatorType) {
+  if (!c10::npu::option::OptionsManager::CheckQueueEnable()) {
+    c10::backend::NPUGuard guard(stream.device_index());
+    return aclrtStreamWaitEvent(stream, event);
+  }
+  RECORD_FUNCTION(
+      EventParas::EVENT_PARAS_MAP[WAIT_EVENT], std::vector<c10::IValue>({}));
+  EventParas eventParam(event, allocatorType);
+  QueueParas params(WAIT_EVENT, sizeof(EventParas), &eventParam);
+  EnqueueTask(params, stream);
+  return ACL_ERROR_NONE;
+}
+
+aclError LaunchLazyDestroyEventTask(
+    aclrtEvent event,
+    c10::DeviceIndex device_index,
+    EventAllocatorType allocatorType) {
+  if (c10::npu::option::OptionsManager::CheckQueueEnable()) {
+    // Destroying must wait for the record and wait tasks of the event that
+    // are still queued, so it is queued behind them as well. Callers are
+    // destructors, a failed queue falls back to destroying right away.
+    try {
+      EventParas eventParam(event, allocatorType);
+      QueueParas params(LAZY_DESTROY_EVENT, sizeof(EventParas), &eventParam);
+      EnqueueTask(params, c10::backend::getCurrentNPUStream(device_index));
+      return ACL_ERROR_NONE;
+    } catch (std::exception& e) {
+      ASCEND_LOGE("Enqueue lazy destroy event failed: %s", e.what());
+    }
+  }
+  c10::backend::NPUGuard guard(device_index);
+  return aclrtDestroyEvent(event);
+}
+
 } // namespace queue
 } // namespace c10::npu
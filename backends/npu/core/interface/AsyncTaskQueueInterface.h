@@ -29,6 +29,8 @@ struct EventParas {
   aclrtEvent event = nullptr;
   void Copy(EventParas& other);
   EventAllocatorType eventAllocatorType = RESERVED;
+  // Device whose queue the task went through, set for record tasks.
+  c10::DeviceIndex device_index = -1;
   static std::map<int64_t, std::string> EVENT_PARAS_MAP;
 };
 
@@ -52,6 +54,12 @@ struct QueueParas {
   uint64_t correlation_id = 0;
 };
 
+// Pushes |paras| to the task queue of the stream's device, the ACL thread
+// launches it on |stream| in submission order.
+void EnqueueTask(QueueParas& paras, const c10::backend::NPUStream& stream);
+
+// The launch functions below go through the task queue when
+// TASK_QUEUE_ENABLE is set, otherwise they call ACL directly.
 aclError LaunchAsyncCopyTask(
     void* dst,
     size_t dstLen,
@@ -59,5 +67,31 @@ aclError LaunchAsyncCopyTask(
     size_t srcLen,
     aclrtMemcpyKind kind);
 
+aclError LaunchRecordEventTask(
+    aclrtEvent event,
+    const c10::backend::NPUStream& stream,
+    EventAllocatorType allocatorType = RESERVED);
+
+aclError LaunchWaitEventTask(
+    aclrtEvent event,
+    const c10::backend::NPUStream& stream,
+    EventAllocatorType allocatorType = RESERVED);
+
+aclError LaunchLazyDestroyEventTask(
+    aclrtEvent event,
+    c10::DeviceIndex device_index,
+    EventAllocatorType allocatorType = RESERVED);
+
+// An event whose record task is still in the task queue has not been
+// recorded on the device yet, so querying it through ACL would report it as
+// complete. Event queries must check here first. Pending records are kept
+// per device, queries on devices without any of them take no lock.
+bool IsEventRecordPending(aclrtEvent event, c10::DeviceIndex device_index);
+// Checks every device, for callers that don't know where event was recorded.
+bool IsEventRecordPending(aclrtEvent event);
+void MarkEventRecordLaunched(aclrtEvent event, c10::DeviceIndex device_index);
+// Drops the pending records of a device whose queue failed.
+void ClearPendingEventRecords(c10::DeviceIndex device_index);
+
 } // namespace queue
 } // namespace c10::npu
@@ -35,6 +35,29 @@ bool OptionsManager::CheckBlockingEnable() {
   return checkBlockingEnable;
 }
 
+bool OptionsManager::CheckQueueEnable() {
+  // ASCEND_LAUNCH_BLOCKING requires every launch to return with the stream
+  // drained, so the task queue is turned off whenever blocking is requested.
+  const static bool checkQueueEnable = []() -> bool {
+    if (OptionsManager::CheckBlockingEnable()) {
+      return false;
+    }
+    int32_t queue_enable =
+        OptionsManager::GetBoolTypeOption("TASK_QUEUE_ENABLE", 0);
+    return queue_enable != 0;
+  }();
+  return checkQueueEnable;
+}
+
+bool OptionsManager::CheckAclResourceCacheEnable() {
+  const static bool checkAclResourceCacheEnable = []() -> bool {
+    int32_t enable =
+        OptionsManager::GetBoolTypeOption("ACL_RESOURCE_CACHE_ENABLE", 1);
+    return enable != 0;
+  }();
+  return checkAclResourceCacheEnable;
+}
+
 bool OptionsManager::CheckCombinedOptimizerEnable() {
   const static bool checkCombinedOptimizerEnable = []() -> bool {
     int32_t combined_optimize =
@@ -70,6 +93,37 @@ int32_t OptionsManager::GetACLExecTimeout() {
   return static_cast<int32_t>(envFlag);
 }
 
+size_t OptionsManager::GetContiguousCacheMaxBytes() {
+  // Budget of the view-to-contiguous optimization cache, 0 disables it.
+  const static size_t maxBytes = []() -> size_t {
+    char* env_val = std::getenv("CONTIGUOUS_CACHE_MAX_MB");
+    int64_t maxMB = (env_val != nullptr) ? strtol(env_val, nullptr, 10) : 64;
+    return maxMB > 0 ? static_cast<size_t>(maxMB) << 20 : 0;
+  }();
+  return maxBytes;
+}
+
+size_t OptionsManager::GetScalarCacheCapacity() {
+  // Number of scalar tensors kept by ScalarConstantCache, 0 disables it.
+  const static size_t capacity = []() -> size_t {
+    char* env_val = std::getenv("SCALAR_CACHE_CAPACITY");
+    int64_t entries =
+        (env_val != nullptr) ? strtol(env_val, nullptr, 10) : 256;
+    return entries > 0 ? static_cast<size_t>(entries) : 0;
+  }();
+  return capacity;
+}
+
+size_t OptionsManager::GetStreamsPerPool() {
+  // Streams in each of the low and high priority stream pools of a device.
+  const static size_t count = []() -> size_t {
+    char* env_val = std::getenv("NPU_STREAMS_PER_POOL");
+    int64_t streams = (env_val != nullptr) ? strtol(env_val, nullptr, 10) : 32;
+    return streams > 0 ? static_cast<size_t>(streams) : 0;
+  }();
+  return count;
+}
+
 bool OptionsManager::isACLGlobalLogOn(aclLogLevel level) {
   const static int getACLGlobalLogLevel = []() -> int {
     char* env_val = std::getenv("ASCEND_GLOBAL_LOG_LEVEL");
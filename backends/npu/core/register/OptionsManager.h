@@ -15,9 +15,14 @@ class OptionsManager {
   static bool IsResumeModeEnable();
   static bool CheckInfNanModeEnable();
   static bool CheckBlockingEnable();
+  static bool CheckQueueEnable();
+  static bool CheckAclResourceCacheEnable();
   static bool CheckCombinedOptimizerEnable();
   static bool CheckAclDumpDateEnable();
   static int32_t GetACLExecTimeout();
+  static size_t GetContiguousCacheMaxBytes();
+  static size_t GetScalarCacheCapacity();
+  static size_t GetStreamsPerPool();
   C10_BACKEND_API static bool isACLGlobalLogOn(aclLogLevel level);
   static int64_t GetRankId();
   static bool CheckGeInitDisable();
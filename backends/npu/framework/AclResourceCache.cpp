@@ -0,0 +1,237 @@
+#include "framework/AclResourceCache.h"
+
+#include <c10/util/hash.h>
+#include "core/npu_log.h"
+#include "core/register/OptionsManager.h"
+#include "framework/OpParamMaker.h"
+
+namespace at_npu {
+namespace native {
+
+namespace {
+constexpr size_t kMaxCachedTensorDescs = 8192;
+constexpr size_t kMaxPooledDataBuffers = 16384;
+constexpr size_t kMaxCachedOpAttrs = 4096;
+
+bool IsCacheEnable() {
+  return c10::npu::option::OptionsManager::CheckAclResourceCacheEnable();
+}
+} // namespace
+
+bool AclTensorDescKey::operator==(const AclTensorDescKey& other) const {
+  return dataType == other.dataType && originFormat == other.originFormat &&
+      dims == other.dims && hasFormat == other.hasFormat &&
+      format == other.format && hasStorageDims == other.hasStorageDims &&
+      storageDims == other.storageDims && name == other.name;
+}
+
+size_t AclTensorDescKeyHash::operator()(const AclTensorDescKey& key) const {
+  size_t seed = c10::hash_combine(
+      static_cast<size_t>(key.dataType), static_cast<size_t>(key.originFormat));
+  seed = c10::hash_combine(seed, key.hasFormat ? key.format + 1 : 0);
+  for (auto dim : key.dims) {
+    seed = c10::hash_combine(seed, std::hash<int64_t>()(dim));
+  }
+  seed = c10::hash_combine(
+      seed, key.hasStorageDims ? key.storageDims.size() + 1 : 0);
+  for (auto dim : key.storageDims) {
+    seed = c10::hash_combine(seed, std::hash<int64_t>()(dim));
+  }
+  return c10::hash_combine(seed, std::hash<std::string>()(key.name));
+}
+
+AclTensorDescCache& AclTensorDescCache::GetInstance() {
+  static AclTensorDescCache instance;
+  return instance;
+}
+
+aclTensorDesc* AclTensorDescCache::Create(const AclTensorDescKey& key) {
+  aclTensorDesc* desc = aclCreateTensorDesc(
+      key.dataType, key.dims.size(), key.dims.data(), key.originFormat);
+  if (desc == nullptr) {
+    return nullptr;
+  }
+  if (key.hasFormat) {
+    aclSetTensorFormat(desc, key.format);
+  }
+  if (key.hasStorageDims) {
+    aclSetTensorShape(desc, key.storageDims.size(), key.storageDims.data());
+  }
+  if (!key.name.empty()) {
+    aclSetTensorDescName(desc, key.name.c_str());
+  }
+  return desc;
+}
+
+aclTensorDesc* AclTensorDescCache::Get(const AclTensorDescKey& key) {
+  if (!IsCacheEnable()) {
+    return Create(key);
+  }
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = descs_.find(key);
+    if (it != descs_.end()) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return it->second;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  aclTensorDesc* desc = Create(key);
+  if (desc == nullptr) {
+    return nullptr;
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (descs_.size() >= kMaxCachedTensorDescs) {
+    return desc;
+  }
+  auto result = descs_.emplace(key, desc);
+  if (!result.second) {
+    // Another thread cached the same key first.
+    lock.unlock();
+    aclDestroyTensorDesc(desc);
+    return result.first->second;
+  }
+  owned_.emplace(desc, &result.first->first);
+  return desc;
+}
+
+const aclTensorDesc* AclTensorDescCache::Detach(const aclTensorDesc* desc) {
+  const AclTensorDescKey* key = nullptr;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = owned_.find(desc);
+    if (it == owned_.end()) {
+      return desc;
+    }
+    key = it->second;
+  }
+  // Cached entries are never erased, so the key outlives the lock.
+  return Create(*key);
+}
+
+void AclTensorDescCache::Destroy(const aclTensorDesc* desc) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (owned_.count(desc) != 0) {
+      return;
+    }
+  }
+  aclDestroyTensorDesc(desc);
+}
+
+AclCacheStats AclTensorDescCache::GetStats() const {
+  AclCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  stats.size = descs_.size();
+  return stats;
+}
+
+AclDataBufferPool& AclDataBufferPool::GetInstance() {
+  static AclDataBufferPool instance;
+  return instance;
+}
+
+aclDataBuffer* AclDataBufferPool::Acquire(void* data, size_t size) {
+  aclDataBuffer* buffer = nullptr;
+  if (IsCacheEnable()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!free_.empty()) {
+      buffer = free_.back();
+      free_.pop_back();
+    }
+  }
+  if (buffer != nullptr) {
+    if (aclUpdateDataBuffer(buffer, data, size) == ACL_ERROR_NONE) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return buffer;
+    }
+    ASCEND_LOGW("aclUpdateDataBuffer failed, create a new data buffer.");
+    aclDestroyDataBuffer(buffer);
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  return aclCreateDataBuffer(data, size);
+}
+
+aclError AclDataBufferPool::Recycle(const aclDataBuffer* buffer) {
+  if (buffer == nullptr) {
+    return ACL_ERROR_NONE;
+  }
+  if (IsCacheEnable()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (free_.size() < kMaxPooledDataBuffers) {
+      free_.push_back(const_cast<aclDataBuffer*>(buffer));
+      return ACL_ERROR_NONE;
+    }
+  }
+  return aclDestroyDataBuffer(buffer);
+}
+
+AclCacheStats AclDataBufferPool::GetStats() const {
+  AclCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats.size = free_.size();
+  return stats;
+}
+
+AclOpAttrCache& AclOpAttrCache::GetInstance() {
+  static AclOpAttrCache instance;
+  return instance;
+}
+
+aclopAttr* AclOpAttrCache::Get(const std::string& key) {
+  if (IsCacheEnable()) {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = attrs_.find(key);
+    if (it != attrs_.end()) {
+      hits_.fetch_add(1, std::memory_order_relaxed);
+      return it->second;
+    }
+  }
+  misses_.fetch_add(1, std::memory_order_relaxed);
+  aclopAttr* attr = aclopCreateAttr();
+  if (attr == nullptr) {
+    return nullptr;
+  }
+  OpAttrMaker::Apply(attr, key);
+  if (!IsCacheEnable()) {
+    return attr;
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  if (attrs_.size() >= kMaxCachedOpAttrs) {
+    return attr;
+  }
+  auto result = attrs_.emplace(key, attr);
+  if (!result.second) {
+    lock.unlock();
+    aclopDestroyAttr(attr);
+    return result.first->second;
+  }
+  owned_.insert(attr);
+  return attr;
+}
+
+void AclOpAttrCache::Destroy(const aclopAttr* attr) {
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    if (owned_.count(attr) != 0) {
+      return;
+    }
+  }
+  aclopDestroyAttr(attr);
+}
+
+AclCacheStats AclOpAttrCache::GetStats() const {
+  AclCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  stats.size = attrs_.size();
+  return stats;
+}
+
+} // namespace native
+} // namespace at_npu
@@ -0,0 +1,113 @@
+#ifndef __PULGIN_NATIVE_UTILS_ACL_RESOURCE_CACHE__
+#define __PULGIN_NATIVE_UTILS_ACL_RESOURCE_CACHE__
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <c10/util/SmallVector.h>
+#include "acl/include/acl/acl_base.h"
+#include "acl/include/acl/acl_op.h"
+
+namespace at_npu {
+namespace native {
+
+struct AclCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  size_t size = 0;
+};
+
+// Everything OpCmdHelper sets on a device tensor desc. The data itself lives
+// in the data buffer, so ops on tensors of the same layout share one desc.
+struct AclTensorDescKey {
+  aclDataType dataType = ACL_DT_UNDEFINED;
+  aclFormat originFormat = ACL_FORMAT_UNDEFINED;
+  c10::SmallVector<int64_t, 5> dims;
+  bool hasFormat = false;
+  aclFormat format = ACL_FORMAT_UNDEFINED;
+  bool hasStorageDims = false;
+  c10::SmallVector<int64_t, 5> storageDims;
+  std::string name;
+
+  bool operator==(const AclTensorDescKey& other) const;
+};
+
+struct AclTensorDescKeyHash {
+  size_t operator()(const AclTensorDescKey& key) const;
+};
+
+// Cached descs are shared by every op launched with the same key and live
+// until exit. Destroy() is the counterpart of aclDestroyTensorDesc and leaves
+// cached descs alone.
+class AclTensorDescCache {
+ public:
+  static AclTensorDescCache& GetInstance();
+
+  // Returns a fresh desc owned by the caller once the cache is full or when
+  // ACL_RESOURCE_CACHE_ENABLE=0.
+  aclTensorDesc* Get(const AclTensorDescKey& key);
+  // Ops that read their output shape back from the desc need one of their
+  // own, returns a caller-owned copy if desc is cached.
+  const aclTensorDesc* Detach(const aclTensorDesc* desc);
+  void Destroy(const aclTensorDesc* desc);
+  AclCacheStats GetStats() const;
+
+ private:
+  AclTensorDescCache() = default;
+  static aclTensorDesc* Create(const AclTensorDescKey& key);
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<AclTensorDescKey, aclTensorDesc*, AclTensorDescKeyHash>
+      descs_;
+  std::unordered_map<const aclTensorDesc*, const AclTensorDescKey*> owned_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+// Free list of data buffers, a recycled buffer only has its address and size
+// updated.
+class AclDataBufferPool {
+ public:
+  static AclDataBufferPool& GetInstance();
+
+  aclDataBuffer* Acquire(void* data, size_t size);
+  aclError Recycle(const aclDataBuffer* buffer);
+  AclCacheStats GetStats() const;
+
+ private:
+  AclDataBufferPool() = default;
+
+  mutable std::mutex mutex_;
+  std::vector<aclDataBuffer*> free_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+// Op attrs keyed by op name and attribute values, see OpAttrMaker::AppendKey.
+class AclOpAttrCache {
+ public:
+  static AclOpAttrCache& GetInstance();
+
+  aclopAttr* Get(const std::string& key);
+  void Destroy(const aclopAttr* attr);
+  AclCacheStats GetStats() const;
+
+ private:
+  AclOpAttrCache() = default;
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, aclopAttr*> attrs_;
+  std::unordered_set<const aclopAttr*> owned_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+};
+
+} // namespace native
+} // namespace at_npu
+
+#endif
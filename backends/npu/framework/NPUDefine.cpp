@@ -1,5 +1,6 @@
 #include "framework/NPUDefine.h"
 #include "core/NPUException.h"
+#include "framework/AclResourceCache.h"
 
 namespace at_npu {
 namespace native {
@@ -7,10 +8,10 @@ std::atomic<uint64_t> ExecuteParas::g_pta_correlation_id{0};
 void ExecuteParas::Release() {
   // if useDynamicCompile, this attr will be freed in dynamic compile.
   if (attr != nullptr) {
-    aclopDestroyAttr(attr);
+    AclOpAttrCache::GetInstance().Destroy(attr);
   }
   DestroyConstParams(constParams);
-  NPUStatus ret = DestroyAclParams(paras);
+  NPUStatus ret = DestroyAclParams(paras, !IsInlineParams());
   if (ret != SUCCESS) {
     ASCEND_LOGE("DestroyAclParams fail, ret: %s", ret.c_str());
   }
@@ -21,7 +22,7 @@ void ExecuteParas::Release() {
 
 void ExecuteParas::Copy(ExecuteParas& other) {
   strncpy(this->opType, other.opType, sizeof(ExecuteParas::opType) - 1);
-  this->paras = other.paras;
+  CopyAclParams(other);
   this->attr = other.attr;
   this->constParams = other.constParams;
   this->hostMemory = other.hostMemory;
@@ -31,21 +32,56 @@ void ExecuteParas::Copy(ExecuteParas& other) {
 }
 
 void ExecuteParas::CopyEx(ExecuteParas& other) {
-  this->paras = other.paras;
+  CopyAclParams(other);
   this->attr = other.attr;
   this->constParams = other.constParams;
 }
 
-NPUStatus DestroyAclParams(ACL_PARAMS& params) {
+void* ExecuteParas::AllocParamArrays(size_t len) {
+  if (len <= sizeof(inlineParams)) {
+    return inlineParams;
+  }
+  return malloc(len);
+}
+
+bool ExecuteParas::IsInlineParams() const {
+  return static_cast<const void*>(paras.input_desc) ==
+      static_cast<const void*>(inlineParams);
+}
+
+void ExecuteParas::CopyAclParams(const ExecuteParas& other) {
+  paras = other.paras;
+  if (!other.IsInlineParams()) {
+    return;
+  }
+  // Inline arrays are laid out as ExportParams does: input descs, input
+  // buffers, output descs, output buffers. Point them at our own copy.
+  int inputNum = paras.input_num;
+  int outputNum = paras.output_num;
+  std::copy(
+      other.inlineParams,
+      other.inlineParams + 2 * (inputNum + outputNum),
+      inlineParams);
+  paras.input_desc = reinterpret_cast<const aclTensorDesc**>(inlineParams);
+  paras.input_data_buf =
+      reinterpret_cast<const aclDataBuffer**>(inlineParams + inputNum);
+  paras.output_desc =
+      reinterpret_cast<const aclTensorDesc**>(inlineParams + 2 * inputNum);
+  paras.output_data_buf = reinterpret_cast<aclDataBuffer**>(
+      inlineParams + 2 * inputNum + outputNum);
+}
+
+NPUStatus DestroyAclParams(ACL_PARAMS& params, bool freeArrays) {
   if (params.input_num != 0) {
     if (params.input_desc != nullptr) {
       for (int i = 0; i < params.input_num; ++i) {
-        aclDestroyTensorDesc(params.input_desc[i]);
+        AclTensorDescCache::GetInstance().Destroy(params.input_desc[i]);
       }
     }
     if (params.input_data_buf != nullptr) {
       for (int i = 0; i < params.input_num; ++i) {
-        NPU_CHECK_ERROR(aclDestroyDataBuffer(params.input_data_buf[i]));
+        NPU_CHECK_ERROR(
+            AclDataBufferPool::GetInstance().Recycle(params.input_data_buf[i]));
       }
     }
     params.input_num = 0;
@@ -53,17 +89,20 @@ NPUStatus DestroyAclParams(ACL_PARAMS& params) {
   if (params.output_num != 0) {
     if (params.output_desc != nullptr) {
       for (int i = 0; i < params.output_num; ++i) {
-        aclDestroyTensorDesc(params.output_desc[i]);
+        AclTensorDescCache::GetInstance().Destroy(params.output_desc[i]);
       }
     }
     if (params.output_data_buf != nullptr) {
       for (int i = 0; i < params.output_num; ++i) {
-        NPU_CHECK_ERROR(aclDestroyDataBuffer(params.output_data_buf[i]));
+        NPU_CHECK_ERROR(AclDataBufferPool::GetInstance().Recycle(
+            params.output_data_buf[i]));
       }
     }
     params.output_num = 0;
   }
-  free(params.input_desc);
+  if (freeArrays) {
+    free(params.input_desc);
+  }
   params.input_desc = nullptr;
   params.input_data_buf = nullptr;
   params.output_desc = nullptr;
@@ -79,9 +79,21 @@ struct ExecuteParas {
   void Copy(ExecuteParas& other);
   void CopyEx(ExecuteParas& other);
   PROCESS_FUNC customHandler;
+
+  // The desc/buffer pointer arrays of ops with at most kInlineTensorNum
+  // inputs and outputs are carved from inlineParams, which travels with the
+  // params through the task and release rings, instead of being malloc'd by
+  // the launching thread and freed by the release thread.
+  static constexpr int kInlineTensorNum = N;
+  void* AllocParamArrays(size_t len);
+  bool IsInlineParams() const;
+
+ private:
+  void CopyAclParams(const ExecuteParas& other);
+  const void* inlineParams[2 * kInlineTensorNum];
 };
 
-NPUStatus DestroyAclParams(ACL_PARAMS& params);
+NPUStatus DestroyAclParams(ACL_PARAMS& params, bool freeArrays = true);
 void DestroyConstParams(CONST_PARAMS& params);
 } // namespace native
 } // namespace at_npu
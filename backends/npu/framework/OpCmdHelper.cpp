@@ -1,6 +1,7 @@
 #include "framework/OpCmdHelper.h"
 #include "csrc/backend/NPUStorageImpl.h"
 #include "core/NPUBridge.h"
+#include "framework/AclResourceCache.h"
 #include "framework/FormatHelper.h"
 #include "framework/InferFormat.h"
 #include "framework/OpParamMaker.h"
@@ -17,17 +18,19 @@ std::tuple<aclTensorDesc*, aclDataBuffer*> OpCmdHelper::CovertTensorToAclInput(
   aclDataType aclDataType =
       CalcuOpUtil::ConvertToAclDataType(scalarDataType, forceDataType);
   const auto& npuDesc = c10::backend::NPUBridge::GetNpuStorageImplDesc(tensor);
-  c10::SmallVector<int64_t, 5> storageDims;
-  // if aclDataType is ACL_STRING, storageDims is empty.
+  AclTensorDescKey key;
+  key.dataType = aclDataType;
+  key.originFormat = npuDesc.origin_format_;
+  // if aclDataType is ACL_STRING, dims and storageDims are empty.
   if (aclDataType != ACL_STRING) {
-    storageDims = npuDesc.storage_sizes_;
+    key.dims = npuDesc.base_sizes_;
+    key.storageDims = npuDesc.storage_sizes_;
   }
-  AclTensorDescMaker desc;
-  auto aclDesc = desc.Create(aclDataType, npuDesc)
-                     .SetFormat(npuDesc.npu_format_)
-                     .SetShape(storageDims)
-                     .SetName(descName)
-                     .Get();
+  key.hasFormat = true;
+  key.format = npuDesc.npu_format_;
+  key.hasStorageDims = true;
+  key.name = descName;
+  auto aclDesc = AclTensorDescCache::GetInstance().Get(key);
 
   // if aclDataType != ACL_STRING, we use storageDims to calculate nums and use
   // nums * tensor element size to calculate buffer size. But if aclDataType =
@@ -54,8 +57,10 @@ std::tuple<aclTensorDesc*, aclDataBuffer*> OpCmdHelper::
   at::Tensor aclInput =
       CalcuOpUtil::CopyScalarToDevice(expScalar, scalarDataType);
 
-  AclTensorDescMaker desc;
-  auto aclDesc = desc.Create(aclDataType, ACL_FORMAT_ND).Get();
+  AclTensorDescKey key;
+  key.dataType = aclDataType;
+  key.originFormat = ACL_FORMAT_ND;
+  auto aclDesc = AclTensorDescCache::GetInstance().Get(key);
   AclTensorBufferMaker buffer(aclInput);
   auto aclBuff = buffer.Get();
   return std::tie(aclDesc, aclBuff);
@@ -67,9 +72,11 @@ std::tuple<aclTensorDesc*, aclDataBuffer*> OpCmdHelper::
         const string& descName) {
   aclDataType aclDataType =
       CalcuOpUtil::ConvertToAclDataType(tensor.scalar_type());
-  AclTensorDescMaker desc;
-  auto aclDesc =
-      desc.Create(aclDataType, ACL_FORMAT_ND).SetName(descName).Get();
+  AclTensorDescKey key;
+  key.dataType = aclDataType;
+  key.originFormat = ACL_FORMAT_ND;
+  key.name = descName;
+  auto aclDesc = AclTensorDescCache::GetInstance().Get(key);
   AclTensorBufferMaker buffer(tensor);
   auto aclBuff = buffer.Get();
   return std::tie(aclDesc, aclBuff);
@@ -80,8 +87,10 @@ std::tuple<aclTensorDesc*, aclDataBuffer*> OpCmdHelper::CovertScalarToAclInput(
     at::ScalarType type) {
   aclDataType aclDataType = CalcuOpUtil::ConvertToAclDataType(type);
 
-  AclTensorDescMaker desc;
-  auto aclDesc = desc.Create(aclDataType, ACL_FORMAT_ND).Get();
+  AclTensorDescKey key;
+  key.dataType = aclDataType;
+  key.originFormat = ACL_FORMAT_ND;
+  auto aclDesc = AclTensorDescCache::GetInstance().Get(key);
   AclTensorBufferMaker aclBuffer(aclInput);
   auto aclBuff = aclBuffer.Get();
   return std::tie(aclDesc, aclBuff);
@@ -117,11 +126,15 @@ std::tuple<aclTensorDesc*, aclDataBuffer*> OpCmdHelper::CovertToAclOutput(
   const auto& npuDesc = c10::backend::NPUBridge::GetNpuStorageImplDesc(tensor);
   const auto& dims = tensor.sizes();
   auto& storageDims = npuDesc.storage_sizes_;
-  AclTensorDescMaker desc;
-  auto aclDesc = desc.Create(aclDataType, dims, npuDesc.origin_format_)
-                     .SetFormat(npuDesc.npu_format_)
-                     .SetShape(storageDims)
-                     .Get();
+  AclTensorDescKey key;
+  key.dataType = aclDataType;
+  key.originFormat = npuDesc.origin_format_;
+  key.dims.assign(dims.begin(), dims.end());
+  key.hasFormat = true;
+  key.format = npuDesc.npu_format_;
+  key.hasStorageDims = true;
+  key.storageDims = storageDims;
+  auto aclDesc = AclTensorDescCache::GetInstance().Get(key);
   auto numel = c10::multiply_integers(storageDims);
   AclTensorBufferMaker aclBuffer(tensor, numel);
   auto aclBuff = aclBuffer.Get();
@@ -5,6 +5,7 @@
 #include "csrc/backend/NPUCachingHostAllocator.h"
 #include "csrc/backend/NPUFunctions.h"
 #include "core/NPUException.h"
+#include "core/NPUQueue.h"
 #include "core/interface/AsyncTaskQueueInterface.h"
 #include "core/register/OptionsManager.h"
 #include "framework/OpCmdHelper.h"
@@ -153,9 +154,24 @@ OpCommand& OpCommand::Output(
 void OpCommand::Run() {
   aclCmd->SetEnginePriority();
   const string& op_name = aclCmd->GetName();
-  aclCmd->Run(sync, sync_index, outputTensor);
-  if (c10::npu::option::OptionsManager::CheckBlockingEnable()) {
-    Sync();
+  // Ops that resize their outputs from the launch result can't be deferred.
+  if (c10::npu::option::OptionsManager::CheckQueueEnable() && !sync) {
+    RECORD_FUNCTION(op_name, std::vector<c10::IValue>({}));
+    ExecuteParas execParams;
+    aclCmd->ExportParams(execParams);
+    c10::npu::queue::QueueParas params(
+        c10::npu::queue::COMPILE_AND_EXECUTE,
+        sizeof(ExecuteParas),
+        &execParams);
+    c10::npu::queue::EnqueueTask(params, c10::backend::getCurrentNPUStream());
+    // Descriptors now belong to the queued task, the ACL thread destroys them.
+    aclCmd->releaseSource(false);
+  } else {
+    c10::npu::DrainTaskQueue();
+    aclCmd->Run(sync, sync_index, outputTensor);
+    if (c10::npu::option::OptionsManager::CheckBlockingEnable()) {
+      Sync();
+    }
     aclCmd->releaseSource();
   }
   aclCmds->Pop();
@@ -170,6 +186,7 @@ OpCommand& OpCommand::Sync(c10::SmallVector<int64_t, N>& index) {
 }
 
 OpCommand& OpCommand::Sync() {
+  c10::npu::DrainTaskQueue();
   c10::backend::NPUStream stream = c10::backend::getCurrentNPUStream();
   NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(stream, -1));
   return *this;
@@ -213,8 +230,8 @@ OpCommand& OpCommand::AddHostTensorInput(
 }
 
 OpCommand& OpCommand::AddNoneTensor() {
-  AclTensorDescMaker desc;
-  auto aclDesc = desc.Create(ACL_DT_UNDEFINED, ACL_FORMAT_UNDEFINED).Get();
+  AclTensorDescKey key;
+  auto aclDesc = AclTensorDescCache::GetInstance().Get(key);
   AclTensorBufferMaker buffer(nullptr, 0);
   aclCmd->AddInput(aclDesc, buffer.Get());
   return *this;
@@ -254,8 +271,8 @@ at::Tensor& OpCommand::Contiguous(const at::Tensor& input) {
 at::Tensor OpCommand::CopyHostToDevice(
     const c10::Scalar& scalar,
     at::ScalarType type) {
-  auto tensor = scalar_to_tensor(scalar).to(type);
-  return CopyHostToDevice(tensor);
+  storage.emplace_back(CalcuOpUtil::CopyScalarToDevice(scalar, type));
+  return storage.back();
 }
 
 at::Tensor OpCommand::CopyHostToDevice(const at::Tensor& cpuTensor) {
@@ -88,6 +88,210 @@ void OpAttrMaker::Set(
       attrValue.data());
 }
 
+namespace {
+enum class AttrKeyTag : uint8_t {
+  BOOL,
+  INT,
+  FLOAT,
+  STRING,
+  LIST_INT,
+  LIST_FLOAT,
+  LIST_BOOL,
+  DATA_TYPE,
+  LIST_LIST_INT,
+};
+
+template <typename T>
+void AppendPod(string& key, T value) {
+  key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void AppendArray(string& key, const T* data, size_t num) {
+  AppendPod<uint32_t>(key, static_cast<uint32_t>(num));
+  key.append(reinterpret_cast<const char*>(data), num * sizeof(T));
+}
+
+void AppendHeader(string& key, AttrKeyTag tag, const string& name) {
+  AppendPod(key, tag);
+  AppendArray(key, name.data(), name.size());
+}
+
+class AttrKeyReader {
+ public:
+  AttrKeyReader(const string& key, size_t pos) : key_(key), pos_(pos) {}
+
+  bool Done() const {
+    return pos_ >= key_.size();
+  }
+
+  template <typename T>
+  T Read() {
+    TORCH_CHECK(
+        pos_ + sizeof(T) <= key_.size(),
+        "Truncated op attr key",
+        OPS_ERROR(ErrCode::VALUE));
+    T value;
+    memcpy(&value, key_.data() + pos_, sizeof(T));
+    pos_ += sizeof(T);
+    return value;
+  }
+
+  template <typename T>
+  c10::SmallVector<T, N> ReadArray() {
+    auto num = Read<uint32_t>();
+    TORCH_CHECK(
+        pos_ + num * sizeof(T) <= key_.size(),
+        "Truncated op attr key",
+        OPS_ERROR(ErrCode::VALUE));
+    c10::SmallVector<T, N> values(num);
+    memcpy(values.data(), key_.data() + pos_, num * sizeof(T));
+    pos_ += num * sizeof(T);
+    return values;
+  }
+
+  string ReadString() {
+    auto chars = ReadArray<char>();
+    return string(chars.data(), chars.size());
+  }
+
+ private:
+  const string& key_;
+  size_t pos_;
+};
+} // namespace
+
+void OpAttrMaker::AppendKey(string& key, const string& name, bool value) {
+  AppendHeader(key, AttrKeyTag::BOOL, name);
+  AppendPod<uint8_t>(key, value);
+}
+
+void OpAttrMaker::AppendKey(string& key, const string& name, int64_t value) {
+  AppendHeader(key, AttrKeyTag::INT, name);
+  AppendPod(key, value);
+}
+
+void OpAttrMaker::AppendKey(string& key, const string& name, float value) {
+  AppendHeader(key, AttrKeyTag::FLOAT, name);
+  AppendPod(key, value);
+}
+
+void OpAttrMaker::AppendKey(string& key, const string& name, string value) {
+  AppendHeader(key, AttrKeyTag::STRING, name);
+  AppendArray(key, value.data(), value.size());
+}
+
+void OpAttrMaker::AppendKey(
+    string& key,
+    const string& name,
+    c10::IntArrayRef value) {
+  AppendHeader(key, AttrKeyTag::LIST_INT, name);
+  AppendArray(key, value.data(), value.size());
+}
+
+void OpAttrMaker::AppendKey(
+    string& key,
+    const string& name,
+    at::ArrayRef<float> value) {
+  AppendHeader(key, AttrKeyTag::LIST_FLOAT, name);
+  AppendArray(key, value.data(), value.size());
+}
+
+void OpAttrMaker::AppendKey(
+    string& key,
+    const string& name,
+    at::ArrayRef<uint8_t> value) {
+  AppendHeader(key, AttrKeyTag::LIST_BOOL, name);
+  AppendArray(key, value.data(), value.size());
+}
+
+void OpAttrMaker::AppendKey(
+    string& key,
+    const string& name,
+    c10::Scalar value) {
+  AppendKey(key, name, CalcuOpUtil::GetScalarFloatValue(value));
+}
+
+void OpAttrMaker::AppendKey(
+    string& key,
+    const string& name,
+    at::ScalarType value) {
+  AppendHeader(key, AttrKeyTag::DATA_TYPE, name);
+  AppendPod(key, CalcuOpUtil::ConvertToAclDataType(value));
+}
+
+void OpAttrMaker::AppendKey(
+    string& key,
+    const string& name,
+    at::ArrayRef<c10::IntArrayRef> value) {
+  AppendHeader(key, AttrKeyTag::LIST_LIST_INT, name);
+  AppendPod<uint32_t>(key, static_cast<uint32_t>(value.size()));
+  for (const auto& listInt : value) {
+    AppendArray(key, listInt.data(), listInt.size());
+  }
+}
+
+void OpAttrMaker::Apply(aclopAttr* attr, const string& key) {
+  // The key starts with the op name, attrs follow its terminator.
+  AttrKeyReader reader(key, key.find('\0') + 1);
+  while (!reader.Done()) {
+    auto tag = reader.Read<AttrKeyTag>();
+    string name = reader.ReadString();
+    switch (tag) {
+      case AttrKeyTag::BOOL:
+        aclopSetAttrBool(attr, name.c_str(), reader.Read<uint8_t>());
+        break;
+      case AttrKeyTag::INT:
+        aclopSetAttrInt(attr, name.c_str(), reader.Read<int64_t>());
+        break;
+      case AttrKeyTag::FLOAT:
+        aclopSetAttrFloat(attr, name.c_str(), reader.Read<float>());
+        break;
+      case AttrKeyTag::STRING:
+        aclopSetAttrString(attr, name.c_str(), reader.ReadString().c_str());
+        break;
+      case AttrKeyTag::LIST_INT: {
+        auto values = reader.ReadArray<int64_t>();
+        aclopSetAttrListInt(
+            attr, name.c_str(), values.size(), values.data());
+        break;
+      }
+      case AttrKeyTag::LIST_FLOAT: {
+        auto values = reader.ReadArray<float>();
+        aclopSetAttrListFloat(
+            attr, name.c_str(), values.size(), values.data());
+        break;
+      }
+      case AttrKeyTag::LIST_BOOL: {
+        auto values = reader.ReadArray<uint8_t>();
+        aclopSetAttrListBool(
+            attr, name.c_str(), values.size(), values.data());
+        break;
+      }
+      case AttrKeyTag::DATA_TYPE:
+        aclopSetAttrDataType(attr, name.c_str(), reader.Read<aclDataType>());
+        break;
+      case AttrKeyTag::LIST_LIST_INT: {
+        auto listNum = reader.Read<uint32_t>();
+        c10::SmallVector<c10::SmallVector<int64_t, N>, N> lists;
+        for (uint32_t i = 0; i < listNum; i++) {
+          lists.emplace_back(reader.ReadArray<int64_t>());
+        }
+        c10::SmallVector<c10::IntArrayRef, N> listRefs(
+            lists.begin(), lists.end());
+        Set(attr, name, listRefs);
+        break;
+      }
+      default:
+        TORCH_CHECK(
+            false,
+            "Unknown attr tag in key of op ",
+            key.c_str(),
+            OPS_ERROR(ErrCode::VALUE));
+    }
+  }
+}
+
 void OpCommandImpl::SetEnginePriority() {
   auto stream = c10::backend::getCurrentNPUStream();
   AddAttr("_performance_prior", true);
@@ -114,6 +318,14 @@ void OpCommandImpl::Run(
     c10::SmallVector<at::Tensor, N>& outputTensor) {
   ASCEND_LOGD("Op %s Run.", opName.c_str());
   RECORD_FUNCTION(opName, std::vector<c10::IValue>({}));
+  InitAttr();
+  if (sync) {
+    // Outputs are resized from their descs, which must not be shared.
+    for (auto index : sync_index) {
+      execParam.outDesc[index] =
+          AclTensorDescCache::GetInstance().Detach(execParam.outDesc[index]);
+    }
+  }
   ACL_REQUIRE_OK_OP(
       InnerRun(opName, execParam, sync, sync_index, outputTensor),
       opName.c_str());
@@ -249,7 +461,9 @@ int ExecFunc(c10::npu::queue::QueueParas* in, aclrtStream stream) {
     return ret;
   }
   bool reset_flag = false;
-  if (!cur_paras->isJitDisable) {
+  // Only ops forced into JIT while JIT is globally disabled need the option
+  // toggled around their launch.
+  if (!cur_paras->isJitDisable && env::CheckJitDisable()) {
     NPU_CHECK_ERROR(
         AclSetCompileopt(aclCompileOpt::ACL_OP_JIT_COMPILE, "enable"));
     reset_flag = true;
@@ -306,6 +520,8 @@ int RecordEventFunc(c10::npu::queue::QueueParas* in, aclrtStream stream) {
   auto cur_paras = static_cast<c10::npu::queue::EventParas*>(in->paramVal);
 
   aclError ret = aclrtRecordEvent(cur_paras->event, stream);
+  c10::npu::queue::MarkEventRecordLaunched(
+      cur_paras->event, cur_paras->device_index);
   if (ret != ACL_ERROR_NONE) {
     ASCEND_LOGE(
         "aclrtRecordEvent error! ret = %d, eventAllocatorType = %d",
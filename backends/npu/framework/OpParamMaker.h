@@ -9,6 +9,7 @@
 #include "acl/include/acl/acl_base.h"
 #include "core/interface/AsyncTaskQueueInterface.h"
 #include "core/register/OptionsManager.h"
+#include "framework/AclResourceCache.h"
 #include "framework/NPUDefine.h"
 #include "framework/interface/AclOpCompileInterface.h"
 #include "framework/interface/EnvVariables.h"
@@ -46,6 +47,32 @@ class TORCH_BACKEND_API OpAttrMaker {
       aclopAttr* attr,
       const string& name,
       at::ArrayRef<c10::IntArrayRef> value);
+
+  // Serializes an attr into the key AclOpAttrCache looks attrs up by. Apply
+  // replays the attrs encoded after the op name onto a fresh aclopAttr.
+  static void AppendKey(string& key, const string& name, bool value);
+  static void AppendKey(string& key, const string& name, int64_t value);
+  static void AppendKey(string& key, const string& name, float value);
+  static void AppendKey(string& key, const string& name, string value);
+  static void AppendKey(
+      string& key,
+      const string& name,
+      c10::IntArrayRef value);
+  static void AppendKey(
+      string& key,
+      const string& name,
+      at::ArrayRef<float> value);
+  static void AppendKey(
+      string& key,
+      const string& name,
+      at::ArrayRef<uint8_t> value);
+  static void AppendKey(string& key, const string& name, c10::Scalar value);
+  static void AppendKey(string& key, const string& name, at::ScalarType value);
+  static void AppendKey(
+      string& key,
+      const string& name,
+      at::ArrayRef<c10::IntArrayRef> value);
+  static void Apply(aclopAttr* attr, const string& key);
 }; // class OpAttrMaker
 
 class AclTensorDescMaker {
@@ -145,23 +172,23 @@ class AclTensorBufferMaker {
     uint8_t* header = reinterpret_cast<uint8_t*>(tensor->data_ptr()) -
         tensor->itemsize() * static_cast<uint8_t>(offset);
     size_t bufferSize = tensor->itemsize() * static_cast<size_t>(n);
-    ptr = aclCreateDataBuffer(header, bufferSize);
+    ptr = AclDataBufferPool::GetInstance().Acquire(header, bufferSize);
   }
 
   // offset = 0
   explicit AclTensorBufferMaker(const at::Tensor* tensor, int64_t n = 1) {
     if (tensor == nullptr || n == 0) {
-      ptr = aclCreateDataBuffer(nullptr, 0);
+      ptr = AclDataBufferPool::GetInstance().Acquire(nullptr, 0);
     } else {
-      ptr = aclCreateDataBuffer(
+      ptr = AclDataBufferPool::GetInstance().Acquire(
           (void*)(tensor->data_ptr()), tensor->itemsize() * n);
     }
   }
 
   // offset = 0
   explicit AclTensorBufferMaker(const at::Tensor& tensor, int64_t n = 1) {
-    ptr =
-        aclCreateDataBuffer((void*)(tensor.data_ptr()), tensor.itemsize() * n);
+    ptr = AclDataBufferPool::GetInstance().Acquire(
+        (void*)(tensor.data_ptr()), tensor.itemsize() * n);
   }
 
   ~AclTensorBufferMaker() = default;
@@ -176,10 +203,9 @@ class AclTensorBufferMaker {
 
 using PROC_FUNC = std::function<int()>;
 
-// the member in AclExecParam is create by :
-// aclCreateDataBuffer and aclCreateTensorDesc
-// so aclDestroyTensorDesc and aclDestroyDataBuffer should be called when dtr
-// aclopDestroyAttr
+// the member in AclExecParam is got from AclTensorDescCache, AclDataBufferPool
+// and AclOpAttrCache, so they should be handed back to the same caches when
+// dtr
 class OpCommandImpl {
  public:
   OpCommandImpl() {}
@@ -222,8 +248,11 @@ class OpCommandImpl {
 
   template <typename dataType>
   void AddAttr(const string& attrName, dataType value) {
-    InitAttr();
-    OpAttrMaker::Set(execParam.attr, attrName, value);
+    // The aclopAttr is looked up by the whole key once the op is launched.
+    if (attrKey.empty()) {
+      attrKey.append(opName).push_back('\0');
+    }
+    OpAttrMaker::AppendKey(attrKey, attrName, value);
   }
 
   // export op execute params
@@ -233,6 +262,7 @@ class OpCommandImpl {
         "Too long Ascend IR Name: ",
         opName,
         OPS_ERROR(ErrCode::PARAM));
+    InitAttr();
     memset(params.opType, '\0', sizeof(params.opType));
     opName.copy(params.opType, opName.length() + 1);
     params.attr = execParam.attr;
@@ -249,7 +279,7 @@ class OpCommandImpl {
     size_t totalMemLen = inputTensorDescArrLen + inputDataBuffArrLen +
         outputTensorDescArrLen + outputDataBuffArrLen;
 
-    char* basePtr = static_cast<char*>(malloc(totalMemLen));
+    char* basePtr = static_cast<char*>(params.AllocParamArrays(totalMemLen));
     AT_ASSERT(basePtr != nullptr, OPS_ERROR(ErrCode::PTR));
     const aclTensorDesc** aclTensorInputDescArr =
         reinterpret_cast<const aclTensorDesc**>(basePtr);
@@ -307,24 +337,22 @@ class OpCommandImpl {
 
   void releaseSource(bool no_blocking = true) {
     if (no_blocking) {
-      std::for_each(
-          execParam.inDesc.begin(),
-          execParam.inDesc.end(),
-          aclDestroyTensorDesc);
-      std::for_each(
-          execParam.outDesc.begin(),
-          execParam.outDesc.end(),
-          aclDestroyTensorDesc);
-      std::for_each(
-          execParam.inBuffer.begin(),
-          execParam.inBuffer.end(),
-          aclDestroyDataBuffer);
-      std::for_each(
-          execParam.outBuffer.begin(),
-          execParam.outBuffer.end(),
-          aclDestroyDataBuffer);
+      auto& descCache = AclTensorDescCache::GetInstance();
+      auto& bufferPool = AclDataBufferPool::GetInstance();
+      for (auto desc : execParam.inDesc) {
+        descCache.Destroy(desc);
+      }
+      for (auto desc : execParam.outDesc) {
+        descCache.Destroy(desc);
+      }
+      for (auto buffer : execParam.inBuffer) {
+        bufferPool.Recycle(buffer);
+      }
+      for (auto buffer : execParam.outBuffer) {
+        bufferPool.Recycle(buffer);
+      }
       if (execParam.attr != nullptr) {
-        aclopDestroyAttr(execParam.attr);
+        AclOpAttrCache::GetInstance().Destroy(execParam.attr);
         execParam.attr = nullptr;
       }
     }
@@ -341,6 +369,7 @@ class OpCommandImpl {
     execParam.attr = nullptr;
     execParam.customHandler = nullptr;
     opName = "";
+    attrKey.clear();
   }
 
  private:
@@ -355,8 +384,8 @@ class OpCommandImpl {
   };
 
   void InitAttr() {
-    if (execParam.attr == nullptr) {
-      execParam.attr = aclopCreateAttr();
+    if (execParam.attr == nullptr && !attrKey.empty()) {
+      execParam.attr = AclOpAttrCache::GetInstance().Get(attrKey);
     }
   }
 
@@ -369,6 +398,8 @@ class OpCommandImpl {
 
  private:
   string opName;
+  // op name and attrs encoded by OpAttrMaker::AppendKey
+  string attrKey;
   AclExecParam execParam;
 }; // class OpCommandImpl
 
@@ -6,9 +6,11 @@ namespace at_npu {
 namespace native {
 
 OptimizationCases TransContiguous::optCasesDefault = {};
-OptimizationCases TransContiguous::optCasesAnyFormat = {"reshape", "slice"};
-ska::flat_hash_map<size_t, CachedContiguousOpt>
-    TransContiguous::cached_contiguous_opt;
+OptimizationCases TransContiguous::optCasesAnyFormat = {
+    OptimizationCase::RESHAPE,
+    OptimizationCase::SLICE};
+ContiguousOptCache TransContiguous::cached_contiguous_opt(
+    c10::npu::option::OptionsManager::GetContiguousCacheMaxBytes());
 
 ContiguousTensorDesc TransContiguous::GetTensorDescInfo(
     const at::Tensor& src,
@@ -67,9 +69,12 @@ bool TransContiguous::can_optimize_(ContiguousTensorDesc& tensor_desc) {
     bool res = register_opt::CopyOptRegister::GetInstance()->CanOptimize(
         opt_case, tensor_desc);
     if (res) {
+      ASCEND_LOGD(
+          "Contiguous optimization %s matched.",
+          GetOptimizationCaseName(opt_case));
       // refresh patterns to only keep optimized pattern
       tensor_desc.opt_cases_.clear();
-      tensor_desc.opt_cases_.emplace_back(opt_case);
+      tensor_desc.opt_cases_.add(opt_case);
       return true;
     }
   }
@@ -94,7 +99,7 @@ bool TransContiguous::contiguous_optimize_with_anyformat_(
   if (!CheckClone(src, self)) {
     return false;
   }
-  for (auto& opt_case : src_desc.opt_cases_) {
+  for (auto opt_case : src_desc.opt_cases_) {
     bool res = register_opt::CopyOptRegister::GetInstance()->Run(
         opt_case, self, src, src_desc);
     if (res) {
@@ -104,22 +109,46 @@ bool TransContiguous::contiguous_optimize_with_anyformat_(
   return false;
 }
 
-size_t GetHash_(const c10::SmallVector<int64_t, MAX_DIM>& small_vector_size) {
-  size_t seed = 0;
-  for (size_t i = 0; i < small_vector_size.size(); i++) {
-    seed ^=
-        static_cast<size_t>(small_vector_size[i]) + (seed << 6) + (seed >> 2);
+namespace {
+constexpr uint64_t kHashPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kHashPrime2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t RotateLeft(uint64_t value, int bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+// xxh64 round, every input bit reaches the whole state.
+inline uint64_t HashRound(uint64_t state, uint64_t value) {
+  return RotateLeft(state ^ (value * kHashPrime2), 31) * kHashPrime1;
+}
+
+inline uint64_t HashDims(
+    uint64_t state,
+    const c10::SmallVector<int64_t, MAX_DIM>& dims) {
+  // The length keeps dims from sliding between neighbouring fields.
+  state = HashRound(state, dims.size());
+  for (auto dim : dims) {
+    state = HashRound(state, static_cast<uint64_t>(dim));
   }
-  return seed;
+  return state;
 }
+} // namespace
 
-size_t GetHash_(const ContiguousTensorDesc& src_desc) {
-  size_t hash_src_desc = (GetHash_(src_desc.sizes_) << 52) +
-      (GetHash_(src_desc.base_sizes_) << 40) +
-      (GetHash_(src_desc.strides_) << 28) +
-      (GetHash_(src_desc.base_strides_) << 16) +
-      (static_cast<size_t>(src_desc.offset_) << 4) + src_desc.npu_format_;
-  return hash_src_desc;
+size_t ContiguousOptCache::Hash(const ContiguousTensorDesc& desc) {
+  uint64_t state = kHashPrime1;
+  state = HashDims(state, desc.sizes_);
+  state = HashDims(state, desc.strides_);
+  state = HashDims(state, desc.base_sizes_);
+  state = HashDims(state, desc.base_strides_);
+  state = HashRound(state, static_cast<uint64_t>(desc.offset_));
+  state = HashRound(state, static_cast<uint64_t>(desc.npu_format_));
+  // murmur3 finalizer
+  state ^= state >> 33;
+  state *= 0xFF51AFD7ED558CCDULL;
+  state ^= state >> 33;
+  state *= 0xC4CEB9FE1A85EC53ULL;
+  state ^= state >> 33;
+  return static_cast<size_t>(state);
 }
 
 bool equalDesc(
@@ -136,6 +165,93 @@ bool equalDesc(
   return false;
 }
 
+namespace {
+// Rough footprint of an entry: the opt itself, its shared_ptr control block,
+// the lru node and the index node. Entries with more than MAX_DIM dims spill
+// to the heap and are undercounted.
+constexpr size_t kCachedOptBytes =
+    sizeof(CachedContiguousOpt) + 16 * sizeof(void*);
+} // namespace
+
+ContiguousOptCache::ContiguousOptCache(size_t max_bytes)
+    : max_shard_bytes_(max_bytes / kShardNum) {}
+
+size_t ContiguousOptCache::DescHash::operator()(
+    const ContiguousTensorDesc* desc) const {
+  return desc->hash_src_desc;
+}
+
+bool ContiguousOptCache::DescEqual::operator()(
+    const ContiguousTensorDesc* lhs,
+    const ContiguousTensorDesc* rhs) const {
+  return equalDesc(*lhs, *rhs);
+}
+
+ContiguousOptCache::Shard& ContiguousOptCache::GetShard(size_t hash) {
+  // The index buckets by the low bits, shard by the top ones.
+  return shards_[static_cast<uint64_t>(hash) >> 60];
+}
+
+ContiguousOptCache::OptPtr ContiguousOptCache::Find(
+    const ContiguousTensorDesc& desc) {
+  auto& shard = GetShard(desc.hash_src_desc);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto it = shard.index.find(&desc);
+  if (it == shard.index.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+  }
+  hits_.fetch_add(1, std::memory_order_relaxed);
+  shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+  return *it->second;
+}
+
+void ContiguousOptCache::Insert(
+    const ContiguousTensorDesc& desc,
+    CachedContiguousOpt opt) {
+  if (max_shard_bytes_ < kCachedOptBytes) {
+    return;
+  }
+  auto entry = std::make_shared<const CachedContiguousOpt>(std::move(opt));
+  auto& shard = GetShard(desc.hash_src_desc);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  if (shard.index.count(&desc) != 0) {
+    return;
+  }
+  shard.lru.push_front(std::move(entry));
+  shard.index.emplace(
+      &shard.lru.front()->contiguous_tensor_desc, shard.lru.begin());
+  shard.bytes += kCachedOptBytes;
+  while (shard.bytes > max_shard_bytes_) {
+    shard.index.erase(&shard.lru.back()->contiguous_tensor_desc);
+    shard.lru.pop_back();
+    shard.bytes -= kCachedOptBytes;
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void ContiguousOptCache::Clear() {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    shard.index.clear();
+    shard.lru.clear();
+    shard.bytes = 0;
+  }
+}
+
+ContiguousOptCacheStats ContiguousOptCache::GetStats() {
+  ContiguousOptCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    stats.entries += shard.lru.size();
+    stats.bytes += shard.bytes;
+  }
+  return stats;
+}
+
 bool TransContiguous::cached_contiguous_optimize_with_anyformat_(
     at::Tensor& self,
     const at::Tensor& src,
@@ -144,29 +260,19 @@ bool TransContiguous::cached_contiguous_optimize_with_anyformat_(
   if (!CheckClone(src, self)) {
     return false;
   }
-  src_desc.hash_src_desc = GetHash_(src_desc);
-  auto it = TransContiguous::cached_contiguous_opt.find(src_desc.hash_src_desc);
-  if (it != TransContiguous::cached_contiguous_opt.end()) {
-    // Cached
-    if (equalDesc(src_desc, it->second.contiguous_tensor_desc)) {
-      src_desc.cached_contiguous = true;
-      auto& opt_case = it->second.cached_opt_case;
-      return register_opt::CopyOptRegister::GetInstance()->CachedRun(
-          opt_case, self, src, src_desc);
-    }
-    return contiguous_optimize_with_anyformat_(self, src, src_desc);
-  }
-
-  for (auto& opt_case : src_desc.opt_cases_) {
-    bool res = false;
-    if (TransContiguous::cached_contiguous_opt.size() >= CachedMaxSize) {
-      res = register_opt::CopyOptRegister::GetInstance()->Run(
-          opt_case, self, src, src_desc);
-    } else {
-      src_desc.cached_contiguous = false;
-      res = register_opt::CopyOptRegister::GetInstance()->CachedRun(
-          opt_case, self, src, src_desc);
-    }
+  src_desc.hash_src_desc = ContiguousOptCache::Hash(src_desc);
+  auto cached_opt = TransContiguous::cached_contiguous_opt.Find(src_desc);
+  if (cached_opt != nullptr) {
+    src_desc.cached_contiguous = true;
+    src_desc.cached_opt = cached_opt;
+    return register_opt::CopyOptRegister::GetInstance()->CachedRun(
+        cached_opt->cached_opt_case, self, src, src_desc);
+  }
+
+  src_desc.cached_contiguous = false;
+  for (auto opt_case : src_desc.opt_cases_) {
+    bool res = register_opt::CopyOptRegister::GetInstance()->CachedRun(
+        opt_case, self, src, src_desc);
     if (res) {
       return true;
     }
@@ -217,7 +323,7 @@ bool TransContiguous::ContiguousOptimizeWithBaseFormat(
   ContiguousTensorDesc src_desc = GetTensorDescInfo(src, opt_cases);
   if (OpenCombined &&
       c10::npu::option::OptionsManager::CheckCombinedOptimizerEnable()) {
-    src_desc.add_optimization_case("combined");
+    src_desc.add_optimization_case(OptimizationCase::COMBINED);
   }
   return cached_contiguous_optimize_with_anyformat_(self, src, src_desc);
 }
@@ -1,8 +1,12 @@
 #ifndef __PULGIN_NATIVE_CONTIGUOUS_CONTIGUOUS_OPTIMIZE__
 #define __PULGIN_NATIVE_CONTIGUOUS_CONTIGUOUS_OPTIMIZE__
 
-#include <c10/util/flat_hash_map.h>
 #include <ATen/record_function.h>
+#include <array>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
 #include "core/register/OptionsManager.h"
 #include "framework/contiguous/contiguous_register.h"
 #include "framework/utils/OpPreparation.h"
@@ -17,10 +21,9 @@ using ShapeStrideStack = c10::SmallVector<
     MaxCombinedCasesNum>;
 using OffsetStack = c10::SmallVector<int64_t, MaxCombinedCasesNum>;
 
-constexpr int CachedMaxSize = 1000000;
 constexpr int CachedOptParaNum = 5;
 struct CachedContiguousOpt {
-  string cached_opt_case;
+  OptimizationCase cached_opt_case;
   c10::SmallVector<c10::SmallVector<int64_t, MAX_DIM>, CachedOptParaNum>
       cached_opt_parameters;
   ShapeStrideStack shape_stride_stack;
@@ -28,6 +31,66 @@ struct CachedContiguousOpt {
   ContiguousTensorDesc contiguous_tensor_desc;
 };
 
+struct ContiguousOptCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  size_t entries = 0;
+  size_t bytes = 0;
+};
+
+// LRU of the optimizations found for a view layout, sharded by the desc hash
+// and bounded by CONTIGUOUS_CACHE_MAX_MB. Entries are matched on the whole
+// layout, so a hash collision is a miss instead of a wrong optimization.
+class ContiguousOptCache {
+ public:
+  using OptPtr = std::shared_ptr<const CachedContiguousOpt>;
+
+  explicit ContiguousOptCache(size_t max_bytes);
+
+  // 64-bit hash of the layout fields equalDesc compares.
+  static size_t Hash(const ContiguousTensorDesc& desc);
+
+  // desc.hash_src_desc must be filled before lookups and inserts.
+  OptPtr Find(const ContiguousTensorDesc& desc);
+  void Insert(const ContiguousTensorDesc& desc, CachedContiguousOpt opt);
+  void Clear();
+  ContiguousOptCacheStats GetStats();
+
+ private:
+  static constexpr size_t kShardNum = 16;
+
+  struct DescHash {
+    size_t operator()(const ContiguousTensorDesc* desc) const;
+  };
+  struct DescEqual {
+    bool operator()(
+        const ContiguousTensorDesc* lhs,
+        const ContiguousTensorDesc* rhs) const;
+  };
+  struct Shard {
+    std::mutex mutex;
+    // most recently used first
+    std::list<OptPtr> lru;
+    // keys point into the entries in lru
+    std::unordered_map<
+        const ContiguousTensorDesc*,
+        std::list<OptPtr>::iterator,
+        DescHash,
+        DescEqual>
+        index;
+    size_t bytes = 0;
+  };
+
+  Shard& GetShard(size_t hash);
+
+  size_t max_shard_bytes_;
+  std::array<Shard, kShardNum> shards_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+};
+
 class TransContiguous {
  public:
   TransContiguous() {}
@@ -61,7 +124,7 @@ class TransContiguous {
       at::Tensor& self,
       const at::Tensor& src,
       ContiguousTensorDesc& src_desc);
-  static ska::flat_hash_map<size_t, CachedContiguousOpt> cached_contiguous_opt;
+  static ContiguousOptCache cached_contiguous_opt;
   static at::Tensor view_tensor(
       const at::Tensor& self,
       int64_t offset,
@@ -3,6 +3,23 @@
 namespace at_npu {
 namespace native {
 
+namespace {
+constexpr const char* kOptimizationCaseNames[MAX_CASES] = {
+    "reshape",
+    "reshapeV2",
+    "permute",
+    "slice",
+    "select",
+    "indexing",
+    "broadcast",
+    "combined"};
+} // namespace
+
+const char* GetOptimizationCaseName(OptimizationCase opt_case) {
+  auto index = static_cast<size_t>(opt_case);
+  return index < MAX_CASES ? kOptimizationCaseNames[index] : "unknown";
+}
+
 void ContiguousTensorDesc::refresh_contiguous_using_size_and_stride() {
   if (c10::multiply_integers(sizes_) == 0) {
     is_contiguous_ = true;
@@ -26,30 +43,30 @@ void ContiguousTensorDesc::reset_optimization_cases(
   opt_cases_ = opt_cases;
 }
 
-void ContiguousTensorDesc::add_optimization_case(const std::string& opt_case) {
-  opt_cases_.emplace_back(opt_case);
+void ContiguousTensorDesc::add_optimization_case(OptimizationCase opt_case) {
+  opt_cases_.add(opt_case);
 }
 
 void ContiguousTensorDesc::find_match_optimization_cases() {
   for (const auto i : c10::irange(sizes_.size())) {
     if (strides_[i] == 0) {
-      opt_cases_.emplace_back("broadcast");
+      opt_cases_.add(OptimizationCase::BROADCAST);
       return;
     }
   }
 
   for (const auto i : c10::irange(strides_.size() - 1)) {
     if (strides_[i] < strides_[i + 1]) {
-      opt_cases_.emplace_back("permute");
+      opt_cases_.add(OptimizationCase::PERMUTE);
       return;
     }
   }
 
   // Considering combined-cases, we cannot split slice cases any further.
   if (c10::multiply_integers(sizes_) < c10::multiply_integers(base_sizes_)) {
-    opt_cases_.emplace_back("slice");
-    opt_cases_.emplace_back("select");
-    opt_cases_.emplace_back("indexing");
+    opt_cases_.add(OptimizationCase::SLICE);
+    opt_cases_.add(OptimizationCase::SELECT);
+    opt_cases_.add(OptimizationCase::INDEXING);
     return;
   }
 }
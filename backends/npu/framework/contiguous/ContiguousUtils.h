@@ -2,6 +2,9 @@
 #define __PULGIN_NATIVE_CONTIGUOUS_CONTIGUOUS_UTILS__
 
 #include <c10/util/SmallVector.h>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
 
 #include "framework/utils/NPUDefinition.h"
 #include "framework/utils/NpuUtils.h"
@@ -9,13 +12,83 @@
 
 namespace at_npu {
 namespace native {
-// Max size of discontiguous cases vector
-constexpr int MAX_CASES = 8;
 // Max size of shape size
 constexpr int MAX_DIM = 5;
 
-// Define the discontiguous cases vector to be optimized
-using OptimizationCases = c10::SmallVector<std::string, MAX_CASES>;
+// Discontiguous cases to be optimized. When several cases of a tensor match,
+// they are tried in this order.
+enum class OptimizationCase : uint8_t {
+  RESHAPE,
+  RESHAPE_V2,
+  PERMUTE,
+  SLICE,
+  SELECT,
+  INDEXING,
+  BROADCAST,
+  COMBINED,
+  CASE_NUM
+};
+constexpr size_t MAX_CASES = static_cast<size_t>(OptimizationCase::CASE_NUM);
+
+// Name of the case for logs and profiling, e.g. "reshapeV2".
+const char* GetOptimizationCaseName(OptimizationCase opt_case);
+
+// Set of cases, iterated in OptimizationCase order.
+class OptimizationCases {
+ public:
+  class iterator {
+   public:
+    explicit iterator(uint32_t mask) : mask_(mask) {}
+    OptimizationCase operator*() const {
+      return static_cast<OptimizationCase>(__builtin_ctz(mask_));
+    }
+    iterator& operator++() {
+      mask_ &= mask_ - 1;
+      return *this;
+    }
+    bool operator!=(const iterator& other) const {
+      return mask_ != other.mask_;
+    }
+
+   private:
+    uint32_t mask_;
+  };
+
+  constexpr OptimizationCases() = default;
+  constexpr OptimizationCases(std::initializer_list<OptimizationCase> cases) {
+    for (auto opt_case : cases) {
+      mask_ |= Bit(opt_case);
+    }
+  }
+
+  bool empty() const {
+    return mask_ == 0;
+  }
+  bool contains(OptimizationCase opt_case) const {
+    return (mask_ & Bit(opt_case)) != 0;
+  }
+  void add(OptimizationCase opt_case) {
+    mask_ |= Bit(opt_case);
+  }
+  void clear() {
+    mask_ = 0;
+  }
+  iterator begin() const {
+    return iterator(mask_);
+  }
+  iterator end() const {
+    return iterator(0);
+  }
+
+ private:
+  static constexpr uint32_t Bit(OptimizationCase opt_case) {
+    return 1U << static_cast<uint32_t>(opt_case);
+  }
+
+  uint32_t mask_ = 0;
+};
+
+struct CachedContiguousOpt;
 
 struct ContiguousTensorDesc {
   bool is_contiguous_;
@@ -30,10 +103,13 @@ struct ContiguousTensorDesc {
   OptimizationCases opt_cases_;
   void refresh_contiguous_using_size_and_stride();
   void reset_optimization_cases(const OptimizationCases& opt_cases);
-  void add_optimization_case(const std::string& opt_case);
+  void add_optimization_case(OptimizationCase opt_case);
   void find_match_optimization_cases();
   size_t hash_src_desc;
   bool cached_contiguous;
+  // Set together with cached_contiguous, keeps the entry alive even if it is
+  // evicted while the cached optimizer runs.
+  std::shared_ptr<const CachedContiguousOpt> cached_opt;
 };
 
 } // namespace native
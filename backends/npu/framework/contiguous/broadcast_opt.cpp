@@ -95,7 +95,7 @@ class BroadcastContiguousOpt : public ContiguousOpt {
   }
 }; // class BroadcastContiguousOpt
 
-REGISTER_COPY_OPT(broadcast, BroadcastContiguousOpt)
+REGISTER_COPY_OPT(BROADCAST, BroadcastContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
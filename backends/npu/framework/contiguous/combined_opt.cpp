@@ -41,8 +41,7 @@ class CombinedContiguousOpt : public ContiguousOpt {
       RECORD_FUNCTION(
           "cached_contiguous_h_combined", std::vector<c10::IValue>({src}));
 
-      CachedContiguousOpt cachedContiguousOpt =
-          TransContiguous::cached_contiguous_opt[src_desc.hash_src_desc];
+      const auto& cachedContiguousOpt = *src_desc.cached_opt;
       shape_stride_stacks = cachedContiguousOpt.shape_stride_stack;
       offset_stack = cachedContiguousOpt.offset_stack;
       return pre_combined_to_contiguous(
@@ -59,12 +58,12 @@ class CombinedContiguousOpt : public ContiguousOpt {
       bool contiguousOrNot = pre_combined_to_contiguous(
           self, src, shape_stride_stacks, offset_stack);
       if (contiguousOrNot) {
-        CachedContiguousOpt cached_opt = CachedContiguousOpt{"combined"};
+        CachedContiguousOpt cached_opt{OptimizationCase::COMBINED};
         cached_opt.shape_stride_stack = cached_shape_stride_stacks;
         cached_opt.offset_stack = cached_offset_stack;
         cached_opt.contiguous_tensor_desc = src_desc;
-        TransContiguous::cached_contiguous_opt[src_desc.hash_src_desc] =
-            cached_opt;
+        TransContiguous::cached_contiguous_opt.Insert(
+            src_desc, std::move(cached_opt));
       }
       return contiguousOrNot;
     }
@@ -125,7 +124,10 @@ class CombinedContiguousOpt : public ContiguousOpt {
 
   // Whether tensor can be optimized(no optimization).
   bool can_be_optimize_from_default_cases(ContiguousTensorDesc& tensor_desc) {
-    OptimizationCases opt_cases{"reshape", "slice", "select"};
+    OptimizationCases opt_cases{
+        OptimizationCase::RESHAPE,
+        OptimizationCase::SLICE,
+        OptimizationCase::SELECT};
     tensor_desc.reset_optimization_cases(opt_cases);
     return TransContiguous::CanOptimize(tensor_desc);
   }
@@ -460,7 +462,10 @@ Inference order: permute, select, slice.
     if (shape_stride_stacks.size() == 1) {
       if (reconstruct_tensor(src, shape_stride_stacks, offset_stacks)) {
         OptimizationCases opt_cases_last{
-            "reshape", "permute", "slice", "select"};
+            OptimizationCase::RESHAPE,
+            OptimizationCase::PERMUTE,
+            OptimizationCase::SLICE,
+            OptimizationCase::SELECT};
         return copy_optimize_contiguous_by_given_cases(
             self, src, opt_cases_last);
       }
@@ -469,7 +474,10 @@ Inference order: permute, select, slice.
     // Construct the first tensor and judge whether it can be optimized.
     if (reconstruct_tensor(src, shape_stride_stacks, offset_stacks)) {
       ContiguousTensorDesc src_desc_ = TransContiguous::GetTensorDescInfo(src);
-      OptimizationCases opt_cases_first{"reshape", "slice", "select"};
+      OptimizationCases opt_cases_first{
+          OptimizationCase::RESHAPE,
+          OptimizationCase::SLICE,
+          OptimizationCase::SELECT};
       if (reshape_without_copy_match(src)) {
         // case 1 : The first tensor is reshape-type, refresh its info is enough
         return combined_to_contiguous(
@@ -497,7 +505,7 @@ Inference order: permute, select, slice.
   }
 }; // class combinedContiguousOpt
 
-REGISTER_COPY_OPT(combined, CombinedContiguousOpt)
+REGISTER_COPY_OPT(COMBINED, CombinedContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
@@ -4,9 +4,8 @@
 #include <ATen/ATen.h>
 #include <c10/util/Optional.h>
 
-#include <map>
-#include <mutex>
-#include <string>
+#include <array>
+#include <memory>
 
 #include "framework/FormatHelper.h"
 #include "framework/StorageDescHelper.h"
@@ -43,53 +42,55 @@ class CopyOptRegister {
     static CopyOptRegister instance;
     return &instance;
   }
-  void Register(std::string& name, ::std::unique_ptr<ContiguousOpt>& ptr) {
-    std::lock_guard<std::mutex> lock(mu_);
-    registry.emplace(name, std::move(ptr));
+  // Registration only happens during static initialization, lookups are a
+  // plain index into the table afterwards.
+  void Register(
+      OptimizationCase opt_case,
+      ::std::unique_ptr<ContiguousOpt>& ptr) {
+    registry[static_cast<size_t>(opt_case)] = std::move(ptr);
   }
 
-  bool CanOptimize(std::string& name, const ContiguousTensorDesc& src_desc) {
-    auto itr = registry.find(name);
-    if (itr != registry.end()) {
-      return itr->second->CanOptimizer(src_desc);
-    }
-    return false;
+  bool CanOptimize(
+      OptimizationCase opt_case,
+      const ContiguousTensorDesc& src_desc) {
+    auto opt = Get(opt_case);
+    return opt != nullptr && opt->CanOptimizer(src_desc);
   }
 
   bool Run(
-      const std::string& name,
+      OptimizationCase opt_case,
       at::Tensor& self,
       const at::Tensor& src,
       const ContiguousTensorDesc& src_desc) {
-    auto itr = registry.find(name);
-    if (itr != registry.end()) {
-      return itr->second->Optimizer(self, src, src_desc);
-    }
-    return false;
+    auto opt = Get(opt_case);
+    return opt != nullptr && opt->Optimizer(self, src, src_desc);
   }
 
   bool CachedRun(
-      const std::string& name,
+      OptimizationCase opt_case,
       at::Tensor& self,
       const at::Tensor& src,
       const ContiguousTensorDesc& src_desc) {
-    auto itr = registry.find(name);
-    if (itr != registry.end()) {
-      return itr->second->CachedOptimizer(self, src, src_desc);
-    }
-    return false;
+    auto opt = Get(opt_case);
+    return opt != nullptr && opt->CachedOptimizer(self, src, src_desc);
   }
 
  private:
   CopyOptRegister() {}
-  mutable std::mutex mu_;
-  mutable std::map<std::string, ::std::unique_ptr<ContiguousOpt>> registry;
+  ContiguousOpt* Get(OptimizationCase opt_case) const {
+    auto index = static_cast<size_t>(opt_case);
+    return index < MAX_CASES ? registry[index].get() : nullptr;
+  }
+
+  std::array<::std::unique_ptr<ContiguousOpt>, MAX_CASES> registry;
 }; // class CopyOptRegister
 
 class CopyOptBuilder {
  public:
-  CopyOptBuilder(std::string name, ::std::unique_ptr<ContiguousOpt>& ptr) {
-    CopyOptRegister::GetInstance()->Register(name, ptr);
+  CopyOptBuilder(
+      OptimizationCase opt_case,
+      ::std::unique_ptr<ContiguousOpt>& ptr) {
+    CopyOptRegister::GetInstance()->Register(opt_case, ptr);
   }
   ~CopyOptBuilder() = default;
 }; // class CopyOptBuilder
@@ -100,7 +101,7 @@ class CopyOptBuilder {
 #define REGISTER_COPY_OPT_UNIQ(id, name, optimization)                       \
   auto copy_opt_##id = ::std::unique_ptr<ContiguousOpt>(new optimization()); \
   static register_opt::CopyOptBuilder register_copy_opt##id(                 \
-      #name, copy_opt_##id);
+      OptimizationCase::name, copy_opt_##id);
 
 } // namespace native
 } // namespace at_npu
@@ -133,7 +133,7 @@ class IndexingContiguousOpt : public ContiguousOpt {
   }
 }; // class IndexingContiguousOpt
 
-REGISTER_COPY_OPT(indexing, IndexingContiguousOpt)
+REGISTER_COPY_OPT(INDEXING, IndexingContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
@@ -38,12 +38,9 @@ class PermuteContiguousOpt : public ContiguousOpt {
     if (src_desc.cached_contiguous) {
       RECORD_FUNCTION(
           "cached_contiguous_d_Transpose", std::vector<c10::IValue>({src}));
-      CachedContiguousOpt cachedContiguousOpt =
-          TransContiguous::cached_contiguous_opt[src_desc.hash_src_desc];
-      c10::SmallVector<int64_t, MAX_DIM> sizes =
-          cachedContiguousOpt.cached_opt_parameters.pop_back_val();
-      c10::SmallVector<int64_t, MAX_DIM> perm =
-          cachedContiguousOpt.cached_opt_parameters.pop_back_val();
+      const auto& cachedContiguousOpt = *src_desc.cached_opt;
+      const auto& perm = cachedContiguousOpt.cached_opt_parameters[0];
+      const auto& sizes = cachedContiguousOpt.cached_opt_parameters[1];
       permute_to_contiguous(self, src, perm, sizes);
       return true;
     }
@@ -54,12 +51,12 @@ class PermuteContiguousOpt : public ContiguousOpt {
     if (can_use_permute(src_desc, perm, sizes)) {
       RECORD_FUNCTION(
           "contiguous_d_Transpose", std::vector<c10::IValue>({src}));
-      CachedContiguousOpt cached_opt = CachedContiguousOpt{"permute"};
+      CachedContiguousOpt cached_opt{OptimizationCase::PERMUTE};
       cached_opt.cached_opt_parameters.emplace_back(perm);
       cached_opt.cached_opt_parameters.emplace_back(sizes);
       cached_opt.contiguous_tensor_desc = src_desc;
-      TransContiguous::cached_contiguous_opt[src_desc.hash_src_desc] =
-          cached_opt;
+      TransContiguous::cached_contiguous_opt.Insert(
+          src_desc, std::move(cached_opt));
       permute_to_contiguous(self, src, perm, sizes);
       return true;
     }
@@ -222,7 +219,7 @@ class PermuteContiguousOpt : public ContiguousOpt {
   }
 }; // class PermuteContiguousOpt
 
-REGISTER_COPY_OPT(permute, PermuteContiguousOpt)
+REGISTER_COPY_OPT(PERMUTE, PermuteContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
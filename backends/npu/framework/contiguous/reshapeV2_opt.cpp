@@ -99,7 +99,7 @@ class ReshapeV2ContiguousOpt : public ContiguousOpt {
   }
 }; // class ReshapeV2ContiguousOpt
 
-REGISTER_COPY_OPT(reshapeV2, ReshapeV2ContiguousOpt)
+REGISTER_COPY_OPT(RESHAPE_V2, ReshapeV2ContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
@@ -25,7 +25,7 @@ class ReshapeContiguousOpt : public ContiguousOpt {
   }
 }; // class ReshapeContiguousOpt
 
-REGISTER_COPY_OPT(reshape, ReshapeContiguousOpt)
+REGISTER_COPY_OPT(RESHAPE, ReshapeContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
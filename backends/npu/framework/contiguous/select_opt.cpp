@@ -129,7 +129,7 @@ class SelectContiguousOpt : public ContiguousOpt {
   }
 }; // class SelectContiguousOpt
 
-REGISTER_COPY_OPT(select, SelectContiguousOpt)
+REGISTER_COPY_OPT(SELECT, SelectContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
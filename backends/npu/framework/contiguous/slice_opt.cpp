@@ -37,12 +37,9 @@ class SliceContiguousOpt : public ContiguousOpt {
     if (src_desc.cached_contiguous) {
       RECORD_FUNCTION(
           "cached_contiguous_d_Slice", std::vector<c10::IValue>({src}));
-      CachedContiguousOpt cachedContiguousOpt =
-          TransContiguous::cached_contiguous_opt[src_desc.hash_src_desc];
-      c10::SmallVector<int64_t, MAX_DIM> size =
-          cachedContiguousOpt.cached_opt_parameters.pop_back_val();
-      c10::SmallVector<int64_t, MAX_DIM> offsets =
-          cachedContiguousOpt.cached_opt_parameters.pop_back_val();
+      const auto& cachedContiguousOpt = *src_desc.cached_opt;
+      const auto& offsets = cachedContiguousOpt.cached_opt_parameters[0];
+      const auto& size = cachedContiguousOpt.cached_opt_parameters[1];
       slice_to_contiguous(self, src, offsets, size, src_desc);
       return true;
     }
@@ -50,12 +47,12 @@ class SliceContiguousOpt : public ContiguousOpt {
     c10::SmallVector<int64_t, MAX_DIM> size;
     if (can_use_slice(src_desc, offsets, size)) {
       RECORD_FUNCTION("contiguous_d_Slice", std::vector<c10::IValue>({src}));
-      CachedContiguousOpt cached_opt = CachedContiguousOpt{"slice"};
+      CachedContiguousOpt cached_opt{OptimizationCase::SLICE};
       cached_opt.cached_opt_parameters.emplace_back(offsets);
       cached_opt.cached_opt_parameters.emplace_back(size);
       cached_opt.contiguous_tensor_desc = src_desc;
-      TransContiguous::cached_contiguous_opt[src_desc.hash_src_desc] =
-          cached_opt;
+      TransContiguous::cached_contiguous_opt.Insert(
+          src_desc, std::move(cached_opt));
       slice_to_contiguous(self, src, offsets, size, src_desc);
       return true;
     }
@@ -153,7 +150,7 @@ class SliceContiguousOpt : public ContiguousOpt {
   }
 }; // class SliceContiguousOpt
 
-REGISTER_COPY_OPT(slice, SliceContiguousOpt)
+REGISTER_COPY_OPT(SLICE, SliceContiguousOpt)
 
 } // namespace native
 } // namespace at_npu
@@ -19,6 +19,7 @@
 #include "framework/utils/CalcuOpUtil.h"
 #include "framework/utils/ForceJitCompileList.h"
 #include "framework/utils/NpuUtils.h"
+#include "framework/utils/ScalarConstantCache.h"
 
 namespace {
 constexpr float EPSILON = 1e-6;
@@ -179,8 +180,21 @@ c10::Scalar CalcuOpUtil::ConvertTensorToScalar(const at::Tensor& tensor) {
 at::Tensor CalcuOpUtil::CopyScalarToDevice(
     const c10::Scalar& cpu_scalar,
     at::ScalarType scalar_data_type) {
-  return CalcuOpUtil::CopyTensorHostToDevice(
-      scalar_to_tensor(cpu_scalar).to(scalar_data_type));
+  return ScalarConstantCache::GetInstance().Get(cpu_scalar, scalar_data_type);
+}
+
+at::Tensor CalcuOpUtil::CopyScalarsToDevice(
+    c10::ArrayRef<c10::Scalar> cpu_scalars,
+    at::ScalarType scalar_data_type) {
+  // Packs the scalars on the host so they take a single copy.
+  at::Tensor cpu_tensor = at::empty(
+      {static_cast<int64_t>(cpu_scalars.size())},
+      at::TensorOptions().dtype(at::kDouble));
+  double* data = cpu_tensor.data_ptr<double>();
+  for (size_t i = 0; i < cpu_scalars.size(); i++) {
+    data[i] = cpu_scalars[i].toDouble();
+  }
+  return CopyTensorHostToDevice(cpu_tensor.to(scalar_data_type));
 }
 
 at::Tensor CalcuOpUtil::CopyTensorHostToDevice(const at::Tensor& cpu_tensor) {
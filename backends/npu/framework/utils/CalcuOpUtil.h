@@ -64,9 +64,14 @@ class CalcuOpUtil {
       const at::ScalarType& data_type,
       const string& realDataType);
   static c10::Scalar ConvertTensorToScalar(const at::Tensor& tensor);
+  // The tensors returned may be shared through ScalarConstantCache and must
+  // not be written to.
   static at::Tensor CopyScalarToDevice(
       const c10::Scalar& cpu_scalar,
       at::ScalarType scalar_data_type);
+  static at::Tensor CopyScalarsToDevice(
+      c10::ArrayRef<c10::Scalar> cpu_scalars,
+      at::ScalarType scalar_data_type);
   static at::Tensor CopyTensorHostToDevice(const at::Tensor& cpu_tensor);
   static NPUStatus AclrtMemcpyAsync(
       const std::pair<at::Tensor, int64_t>& dst,
@@ -166,7 +166,7 @@ at::Tensor metadata_convert_match_with_copy_optimize(const at::Tensor& src) {
   bool numelEq = (src.numel() == c10::multiply_integers(src_desc.base_sizes_));
 
   // For unmatched Tensors with base format, we can:
-  OptimizationCases optimizations_reshape{"reshapeV2"};
+  OptimizationCases optimizations_reshape{OptimizationCase::RESHAPE_V2};
   if (numelEq && src_desc.npu_format_ == ACL_FORMAT_ND &&
       src_desc.origin_format_ == ACL_FORMAT_ND && (src.dim() != 0) &&
       !src_desc.base_sizes_.empty()) {
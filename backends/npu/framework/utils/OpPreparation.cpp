@@ -122,6 +122,14 @@ at::Tensor OpPreparation::copy_scalar_to_device(
   return copy_scalar_to_device(cpu_scalar, scalar_data_type);
 }
 
+at::Tensor OpPreparation::copy_scalars_to_device(
+    c10::ArrayRef<c10::Scalar> cpu_scalars,
+    at::ScalarType scalar_data_type,
+    const c10::Device device) {
+  c10::DeviceGuard guard(device);
+  return CalcuOpUtil::CopyScalarsToDevice(cpu_scalars, scalar_data_type);
+}
+
 at::Tensor OpPreparation::copy_tensor_host_to_device(
     const at::Tensor& cpu_tensor) {
   return CalcuOpUtil::CopyTensorHostToDevice(cpu_tensor);
@@ -46,6 +46,11 @@ class OpPreparation {
       const c10::Scalar& cpu_scalar,
       at::ScalarType scalar_data_type,
       const c10::Device device);
+  // 1-D tensor of the scalars on device, uploaded in one host to device copy.
+  static at::Tensor copy_scalars_to_device(
+      c10::ArrayRef<c10::Scalar> cpu_scalars,
+      at::ScalarType scalar_data_type,
+      const c10::Device device);
   static at::Tensor copy_tensor_host_to_device(const at::Tensor& cpu_tensor);
 
   static bool is_scalar_wrapped_to_tensor(const at::Tensor& tensor);
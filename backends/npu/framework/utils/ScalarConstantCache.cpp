@@ -0,0 +1,165 @@
+#include "framework/utils/ScalarConstantCache.h"
+
+#include <cstring>
+
+#include <ATen/ScalarOps.h>
+#include <c10/core/InferenceMode.h>
+#include <c10/util/hash.h>
+
+#include "core/register/OptionsManager.h"
+#include "csrc/backend/NPUCachingAllocator.h"
+#include "csrc/backend/NPUFunctions.h"
+#include "csrc/backend/NPUStream.h"
+#include "framework/utils/CalcuOpUtil.h"
+
+namespace at_npu {
+namespace native {
+
+namespace {
+constexpr uint8_t kFloatingTag = 0;
+constexpr uint8_t kIntegralTag = 1;
+constexpr uint8_t kBooleanTag = 2;
+} // namespace
+
+bool ScalarConstantKey::operator==(const ScalarConstantKey& other) const {
+  return device == other.device && type == other.type && tag == other.tag &&
+      bits == other.bits;
+}
+
+size_t ScalarConstantKeyHash::operator()(const ScalarConstantKey& key) const {
+  size_t seed = c10::hash_combine(
+      static_cast<size_t>(key.device), static_cast<size_t>(key.type));
+  seed = c10::hash_combine(seed, key.tag);
+  return c10::hash_combine(seed, std::hash<uint64_t>()(key.bits));
+}
+
+ScalarConstantCache& ScalarConstantCache::GetInstance() {
+  // Leak the cache, its tensors must not be freed after the driver.
+  static auto* instance = new ScalarConstantCache(
+      c10::npu::option::OptionsManager::GetScalarCacheCapacity());
+  return *instance;
+}
+
+ScalarConstantCache::ScalarConstantCache(size_t capacity)
+    : capacity_(capacity) {}
+
+bool ScalarConstantCache::MakeKey(
+    const c10::Scalar& scalar,
+    at::ScalarType type,
+    c10::DeviceIndex device,
+    ScalarConstantKey* key) {
+  if (scalar.isSymbolic() || scalar.isComplex()) {
+    return false;
+  }
+  key->device = device;
+  key->type = type;
+  if (scalar.isFloatingPoint()) {
+    double value = scalar.toDouble();
+    key->tag = kFloatingTag;
+    std::memcpy(&key->bits, &value, sizeof(value));
+  } else if (scalar.isBoolean()) {
+    key->tag = kBooleanTag;
+    key->bits = scalar.toBool();
+  } else {
+    int64_t value = scalar.toLong();
+    key->tag = kIntegralTag;
+    std::memcpy(&key->bits, &value, sizeof(value));
+  }
+  return true;
+}
+
+at::Tensor ScalarConstantCache::Upload(
+    const c10::Scalar& scalar,
+    at::ScalarType type) {
+  // Inference tensors have no version counter to check writes against.
+  c10::InferenceMode guard(false);
+  return CalcuOpUtil::CopyTensorHostToDevice(scalar_to_tensor(scalar).to(type));
+}
+
+bool ScalarConstantCache::Find(
+    const ScalarConstantKey& key,
+    at::Tensor* tensor) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end()) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  Entry& entry = it->second->second;
+  if (entry.tensor._version() != entry.version) {
+    lru_.erase(it->second);
+    index_.erase(it);
+    invalidations_.fetch_add(1, std::memory_order_relaxed);
+    misses_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+  lru_.splice(lru_.begin(), lru_, it->second);
+  hits_.fetch_add(1, std::memory_order_relaxed);
+
+  c10::Stream stream = c10::backend::getCurrentNPUStream(key.device).unwrap();
+  if (stream != entry.stream) {
+    c10::backend::Allocator::recordStream(
+        entry.tensor.storage().data_ptr(), stream);
+  }
+  *tensor = entry.tensor;
+  return true;
+}
+
+void ScalarConstantCache::Insert(
+    const ScalarConstantKey& key,
+    const at::Tensor& tensor) {
+  c10::Stream stream = c10::backend::getCurrentNPUStream(key.device).unwrap();
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    // Uploaded by another thread in the meantime.
+    lru_.erase(it->second);
+    index_.erase(it);
+  }
+  lru_.emplace_front(key, Entry{tensor, tensor._version(), stream});
+  index_.emplace(key, lru_.begin());
+  while (lru_.size() > capacity_) {
+    index_.erase(lru_.back().first);
+    lru_.pop_back();
+    evictions_.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+at::Tensor ScalarConstantCache::Get(
+    const c10::Scalar& scalar,
+    at::ScalarType type) {
+  c10::DeviceIndex device = 0;
+  NPU_CHECK_ERROR(c10::backend::GetDevice(&device));
+
+  ScalarConstantKey key;
+  bool cacheable = capacity_ > 0 && MakeKey(scalar, type, device, &key);
+  at::Tensor tensor;
+  if (cacheable && Find(key, &tensor)) {
+    return tensor;
+  }
+  tensor = Upload(scalar, type);
+  if (cacheable) {
+    Insert(key, tensor);
+  }
+  return tensor;
+}
+
+void ScalarConstantCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  index_.clear();
+  lru_.clear();
+}
+
+ScalarConstantCacheStats ScalarConstantCache::GetStats() {
+  ScalarConstantCacheStats stats;
+  stats.hits = hits_.load(std::memory_order_relaxed);
+  stats.misses = misses_.load(std::memory_order_relaxed);
+  stats.evictions = evictions_.load(std::memory_order_relaxed);
+  stats.invalidations = invalidations_.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats.entries = lru_.size();
+  return stats;
+}
+
+} // namespace native
+} // namespace at_npu
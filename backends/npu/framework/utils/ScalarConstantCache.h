@@ -0,0 +1,96 @@
+#ifndef __PLUGIN_NATIVE_UTILS_SCALAR_CONSTANT_CACHE__
+#define __PLUGIN_NATIVE_UTILS_SCALAR_CONSTANT_CACHE__
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <ATen/ATen.h>
+
+namespace at_npu {
+namespace native {
+
+struct ScalarConstantCacheStats {
+  uint64_t hits = 0;
+  uint64_t misses = 0;
+  uint64_t evictions = 0;
+  // Cached tensors found written to in place and dropped.
+  uint64_t invalidations = 0;
+  size_t entries = 0;
+};
+
+// A scalar of some dtype on some device, with its value bit for bit.
+struct ScalarConstantKey {
+  c10::DeviceIndex device = -1;
+  at::ScalarType type = at::ScalarType::Undefined;
+  // Which of the c10::Scalar representations bits holds.
+  uint8_t tag = 0;
+  uint64_t bits = 0;
+
+  bool operator==(const ScalarConstantKey& other) const;
+};
+
+struct ScalarConstantKeyHash {
+  size_t operator()(const ScalarConstantKey& key) const;
+};
+
+// LRU of the 0-dim device tensors that scalars such as alpha, lr and betas
+// are uploaded to for ops that take them as tensors, bounded by
+// SCALAR_CACHE_CAPACITY entries. A hit saves a pinned allocation and a host
+// to device copy.
+//
+// Callers only read the tensors returned. A cached tensor found written to in
+// place, by its version counter, is dropped and uploaded again. A tensor
+// handed out on another stream than the one it was uploaded on is recorded on
+// that stream, so the allocator does not reuse it early once it is evicted.
+class ScalarConstantCache {
+ public:
+  static ScalarConstantCache& GetInstance();
+
+  explicit ScalarConstantCache(size_t capacity);
+
+  // False for scalars that are not cached, symbolic or complex ones.
+  static bool MakeKey(
+      const c10::Scalar& scalar,
+      at::ScalarType type,
+      c10::DeviceIndex device,
+      ScalarConstantKey* key);
+
+  // 0-dim tensor of type holding scalar on the current device.
+  at::Tensor Get(const c10::Scalar& scalar, at::ScalarType type);
+  void Clear();
+  ScalarConstantCacheStats GetStats();
+
+ private:
+  struct Entry {
+    at::Tensor tensor;
+    int64_t version;
+    // stream the tensor was uploaded on
+    c10::Stream stream;
+  };
+  using Lru = std::list<std::pair<ScalarConstantKey, Entry>>;
+
+  // Uploads scalar to the current device.
+  static at::Tensor Upload(const c10::Scalar& scalar, at::ScalarType type);
+  bool Find(const ScalarConstantKey& key, at::Tensor* tensor);
+  void Insert(const ScalarConstantKey& key, const at::Tensor& tensor);
+
+  size_t capacity_;
+  std::mutex mutex_;
+  // most recently used first
+  Lru lru_;
+  std::unordered_map<ScalarConstantKey, Lru::iterator, ScalarConstantKeyHash>
+      index_;
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> evictions_{0};
+  std::atomic<uint64_t> invalidations_{0};
+};
+
+} // namespace native
+} // namespace at_npu
+
+#endif
@@ -5,6 +5,10 @@ if(BUILD_TEST)
   include_directories(BEFORE SYSTEM ${PROJECT_SOURCE_DIR}/third_party/googletest/googletest/include)
   include_directories(BEFORE SYSTEM ${PROJECT_SOURCE_DIR}/third_party/googletest/googlemock/include)
 
+  # backends/fake helpers, only linked by the test and benchmark binaries
+  add_library(torch_backend_fake STATIC ${FAKE_TEST_SRCS})
+  target_link_libraries(torch_backend_fake PUBLIC torch_backend)
+
   # test/cpp/core
   add_subdirectory(${PROJECT_SOURCE_DIR}/test/cpp/core ${CMAKE_BINARY_DIR}/test_core)
   add_subdirectory(${PROJECT_SOURCE_DIR}/test/cpp/backend ${CMAKE_BINARY_DIR}/test_backend)
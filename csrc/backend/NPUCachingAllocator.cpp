@@ -3,6 +3,7 @@
 #include <c10/util/irange.h>
 #include <iostream>
 #include "csrc/backend/NPUFunctions.h"
+#include "csrc/backend/NPUGuard.h"
 #include "csrc/backend/NPUStream.h"
 #include "csrc/core/allocator/CachingAllocator.h"
 
@@ -76,6 +77,22 @@ class DefaultNPUAllocator final : public NPUAllocator {
       c10::backend::CachingAllocator::OutOfMemoryObserver observer) override {
     delegate->attachOutOfMemoryObserver(observer);
   }
+  void beginAllocateToPool(
+      int device,
+      c10::backend::CachingAllocator::MempoolId_t mempool_id,
+      std::function<bool(void*)> filter) override {
+    delegate->beginAllocateToPool(device, mempool_id, std::move(filter));
+  }
+  void endAllocateToPool(
+      int device,
+      c10::backend::CachingAllocator::MempoolId_t mempool_id) override {
+    delegate->endAllocateToPool(device, mempool_id);
+  }
+  void releasePool(
+      int device,
+      c10::backend::CachingAllocator::MempoolId_t mempool_id) override {
+    delegate->releasePool(device, mempool_id);
+  }
 
  private:
   c10::backend::CachingAllocator::CachingAllocator* delegate;
@@ -99,7 +116,11 @@ class CachingAllocatorHelper
     return c10::backend::getCurrentNPUStream(device_index);
   }
 
-  int synchronizeStream(void* stream) override {
+  int synchronizeStream(c10::DeviceIndex device, void* stream) override {
+    // Tasks for the stream are queued on the task queue of its device, which
+    // need not be the current one, e.g. on the reclaim thread.
+    c10::backend::NPUGuard device_guard{device};
+    c10::npu::DrainTaskQueue(device);
     return aclrtSynchronizeStream(stream);
   }
 
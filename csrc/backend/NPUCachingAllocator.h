@@ -25,6 +25,16 @@ class NPUAllocator : public c10::Allocator {
       c10::backend::CachingAllocator::RecordContext when) = 0;
   virtual void attachOutOfMemoryObserver(
       c10::backend::CachingAllocator::OutOfMemoryObserver observer) = 0;
+  virtual void beginAllocateToPool(
+      int device,
+      c10::backend::CachingAllocator::MempoolId_t mempool_id,
+      std::function<bool(void*)> filter) = 0;
+  virtual void endAllocateToPool(
+      int device,
+      c10::backend::CachingAllocator::MempoolId_t mempool_id) = 0;
+  virtual void releasePool(
+      int device,
+      c10::backend::CachingAllocator::MempoolId_t mempool_id) = 0;
 };
 
 extern std::atomic<NPUAllocator*> npu_allocator;
@@ -98,4 +108,23 @@ inline void attachOutOfMemoryObserver(
     c10::backend::CachingAllocator::OutOfMemoryObserver observer) {
   return get()->attachOutOfMemoryObserver(observer);
 }
+
+inline void beginAllocateToPool(
+    int device,
+    c10::backend::CachingAllocator::MempoolId_t mempool_id,
+    std::function<bool(void*)> filter) {
+  return get()->beginAllocateToPool(device, mempool_id, std::move(filter));
+}
+
+inline void endAllocateToPool(
+    int device,
+    c10::backend::CachingAllocator::MempoolId_t mempool_id) {
+  return get()->endAllocateToPool(device, mempool_id);
+}
+
+inline void releasePool(
+    int device,
+    c10::backend::CachingAllocator::MempoolId_t mempool_id) {
+  return get()->releasePool(device, mempool_id);
+}
 } // namespace c10::backend::Allocator
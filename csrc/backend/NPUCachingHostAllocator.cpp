@@ -5,16 +5,17 @@
 #include <cstdint>
 #include <deque>
 #include <memory>
-#include <set>
-#include <shared_mutex>
+#include <mutex>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "csrc/backend/NPUCachingHostAllocator.h"
 #include "csrc/backend/NPUEvent.h"
 #include "csrc/backend/NPUFunctions.h"
 #include "csrc/core/allocator/EventPool.h"
+#include "csrc/core/allocator/PinnedMemoryPool.h"
 
 namespace c10::backend::HostAllocator {
 
@@ -25,25 +26,32 @@ struct HostAllocator
           c10::backend::CachingAllocator::EventPool<NPUEvent>::Event> {
  public:
   bool isPinndPtr(const void* ptr) {
-    std::shared_lock<std::shared_mutex> lock(mutex_);
-    return pinned_ptrs.find(ptr) != pinned_ptrs.end();
+    return pinned_pool_.contains(ptr);
+  }
+
+  void reserve(size_t bytes) {
+    pinned_pool_.reserve(bytes);
+  }
+
+  PinnedMemoryStats getPinnedStats() const {
+    return pinned_pool_.getStats();
+  }
+
+  void empty_cache() override {
+    at::CachingHostAllocatorImpl<
+        NPUStream,
+        c10::backend::CachingAllocator::EventPool<NPUEvent>::Event>::
+        empty_cache();
+    pinned_pool_.releaseFreeSlabs();
   }
 
  private:
   void allocate_host_memory(size_t size, void** ptr) override {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-
-    // TODO(FFFrog): implement aclrtMallocHost which don`t need explicitly
-    // to create context
-    c10::backend::current_device();
-    aclrtMallocHost(ptr, size);
-    pinned_ptrs.insert(*ptr);
+    *ptr = pinned_pool_.malloc(size);
   }
 
   void free_block(Block* block) override {
-    std::unique_lock<std::shared_mutex> lock(mutex_);
-    aclrtFreeHost(block->ptr_);
-    pinned_ptrs.erase(block->ptr_);
+    pinned_pool_.free(block->ptr_, block->size_);
   }
 
   void record_stream(
@@ -72,8 +80,18 @@ struct HostAllocator
     return event_pool->get(idx);
   }
 
-  std::shared_mutex mutex_{};
-  std::set<const void*> pinned_ptrs{};
+  PinnedMemoryPool pinned_pool_{
+      [](size_t size) -> void* {
+        // TODO(FFFrog): implement aclrtMallocHost which don`t need explicitly
+        // to create context
+        c10::backend::current_device();
+        void* ptr = nullptr;
+        if (aclrtMallocHost(&ptr, size) != ACL_ERROR_NONE) {
+          return nullptr;
+        }
+        return ptr;
+      },
+      [](void* ptr) { aclrtFreeHost(ptr); }};
 };
 
 void raw_local_deleter(void* ptr);
@@ -92,6 +110,14 @@ struct NPUCachingHostAllocator final
   bool isPinnedPtr(const void* ptr) {
     return impl_->isPinndPtr(ptr);
   }
+
+  void reserve(size_t bytes) {
+    impl_->reserve(bytes);
+  }
+
+  PinnedMemoryStats getPinnedStats() const {
+    return impl_->getPinnedStats();
+  }
 };
 
 static NPUCachingHostAllocator npu_caching_host_allocator;
@@ -116,4 +142,70 @@ bool isPinndPtr(const void* ptr) {
   return npu_caching_host_allocator.isPinnedPtr(ptr);
 }
 
+void reservePinnedMemory(size_t bytes) {
+  npu_caching_host_allocator.reserve(bytes);
+}
+
+PinnedMemoryStats getPinnedMemoryStats() {
+  return npu_caching_host_allocator.getPinnedStats();
+}
+
+namespace {
+
+constexpr size_t kStagingSlots = 512;
+
+struct StagingRing {
+  std::mutex mutex;
+  c10::DataPtr memory;
+  std::vector<bool> in_use;
+  size_t next = 0;
+};
+
+StagingRing& staging_ring() {
+  // Leak the ring, its pinned memory must not be freed after the driver.
+  static auto* ring = new StagingRing();
+  return *ring;
+}
+
+} // namespace
+
+StagingSlot acquireStagingSlot() {
+  auto& ring = staging_ring();
+  {
+    std::lock_guard<std::mutex> lock(ring.mutex);
+    if (!ring.memory) {
+      ring.memory = npu_caching_host_allocator.allocate(
+          kStagingSlots * kStagingSlotSize);
+      ring.in_use.resize(kStagingSlots);
+    }
+    for (size_t i = 0; i < kStagingSlots; i++) {
+      size_t index = (ring.next + i) % kStagingSlots;
+      if (!ring.in_use[index]) {
+        ring.in_use[index] = true;
+        ring.next = (index + 1) % kStagingSlots;
+        StagingSlot slot;
+        slot.ptr =
+            static_cast<char*>(ring.memory.get()) + index * kStagingSlotSize;
+        slot.index = static_cast<int64_t>(index);
+        return slot;
+      }
+    }
+  }
+  StagingSlot slot;
+  slot.storage = npu_caching_host_allocator.allocate(kStagingSlotSize);
+  slot.ptr = slot.storage.get();
+  return slot;
+}
+
+void releaseStagingSlot(StagingSlot& slot) {
+  if (slot.index >= 0) {
+    auto& ring = staging_ring();
+    std::lock_guard<std::mutex> lock(ring.mutex);
+    ring.in_use[slot.index] = false;
+  }
+  slot.storage.clear();
+  slot.ptr = nullptr;
+  slot.index = -1;
+}
+
 } // namespace c10::backend::HostAllocator
\ No newline at end of file
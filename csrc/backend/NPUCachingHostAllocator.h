@@ -4,6 +4,7 @@
 
 #include "csrc/backend/NPUStream.h"
 #include "csrc/core/Macros.h"
+#include "csrc/core/allocator/PinnedMemoryPool.h"
 
 // TODO(FFFrog):
 // Remove later
@@ -17,7 +18,30 @@ bool recordEvent(void* ptr, void* ctx, c10::backend::NPUStream stream);
 
 void emptyCache(void);
 
+// Pins at least bytes of host memory up front. The memory is kept by
+// emptyCache and serves later pinned allocations.
+void reservePinnedMemory(size_t bytes);
+
+PinnedMemoryStats getPinnedMemoryStats();
+
 // TODO(FFFrog): Remove
 bool isPinndPtr(const void* ptr);
 
+// Pinned slot of kStagingSlotSize bytes to copy a scalar back to the host.
+// Slots are taken from a ring of pinned memory allocated once, or allocated
+// on their own while every slot of the ring is taken.
+constexpr size_t kStagingSlotSize = 8;
+
+struct StagingSlot {
+  void* ptr = nullptr;
+  // Index of the slot in the ring, -1 for a slot allocated on its own.
+  int64_t index = -1;
+  c10::DataPtr storage;
+};
+
+StagingSlot acquireStagingSlot();
+
+// The copies into slot must have completed.
+void releaseStagingSlot(StagingSlot& slot);
+
 } // namespace c10::backend::HostAllocator
\ No newline at end of file
@@ -10,6 +10,7 @@
 // Remove later
 #include "acl/include/acl/acl.h"
 #include "core/NPUException.h"
+#include "core/interface/AsyncTaskQueueInterface.h"
 
 namespace c10::backend {
 /*
@@ -25,8 +26,7 @@ struct C10_BACKEND_API NPUEvent {
   ~NPUEvent() {
     try {
       if (is_created_) {
-        NPUGuard guard(device_index_);
-        aclrtDestroyEvent(event_);
+        c10::npu::queue::LaunchLazyDestroyEventTask(event_, device_index_);
       }
     } catch (...) { /* No throw */
     }
@@ -73,6 +73,9 @@ struct C10_BACKEND_API NPUEvent {
     if (!is_created_) {
       return true;
     }
+    if (c10::npu::queue::IsEventRecordPending(event_, device_index_)) {
+      return false;
+    }
     aclrtEventRecordedStatus currStatus = ACL_EVENT_RECORDED_STATUS_NOT_READY;
     aclrtQueryEventStatus(event_, &currStatus);
 
@@ -103,15 +106,13 @@ struct C10_BACKEND_API NPUEvent {
         " does not match recording stream's device ",
         stream.device_index(),
         ".");
-    NPUGuard guard(device_index_);
-    aclrtRecordEvent(event_, stream);
+    NPU_CHECK_ERROR(c10::npu::queue::LaunchRecordEventTask(event_, stream));
     was_recorded_ = true;
   }
 
   void block(const NPUStream& stream) {
     if (is_created_) {
-      NPUGuard guard(stream.device_index());
-      aclrtStreamWaitEvent(stream, event_);
+      NPU_CHECK_ERROR(c10::npu::queue::LaunchWaitEventTask(event_, stream));
     }
   }
 
@@ -124,6 +125,7 @@ struct C10_BACKEND_API NPUEvent {
     // but if we don't and the current device is not initialized, it will
     // create a new NPU context, which will consume a lot of memory.
     NPUGuard guard(device_index_);
+    c10::npu::DrainTaskQueue(device_index_);
     // raise error if either event is recorded but not yet completed
     aclrtEventElapsedTime(&time_ms, event_, other.event_);
     return time_ms;
@@ -131,6 +133,7 @@ struct C10_BACKEND_API NPUEvent {
 
   void synchronize() const {
     if (is_created_) {
+      c10::npu::DrainTaskQueue(device_index_);
       aclrtSynchronizeEvent(event_);
     }
   }
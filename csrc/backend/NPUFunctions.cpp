@@ -6,6 +6,7 @@
 // TODO(FFFrog):
 // Remove later
 #include "adapter/acl_device_adapter.h"
+#include "core/NPUQueue.h"
 
 namespace c10::backend {
 
@@ -56,6 +57,7 @@ void set_device(c10::DeviceIndex device) {
 }
 
 void device_synchronize() {
+  c10::npu::DrainTaskQueue();
   NPU_CHECK_ERROR(aclrtSynchronizeDevice());
 }
 
@@ -12,6 +12,7 @@
 // TODO(FFFrog):
 // Remove later
 #include "core/NPUException.h"
+#include "core/interface/AsyncTaskQueueInterface.h"
 
 namespace c10::backend {
 namespace impl {
@@ -90,7 +91,8 @@ struct NPUGuardImpl final : public PrivateUse1GuardImpl {
     c10::DeviceIndex orig_device{-1};
     NPU_CHECK_WARN(c10::backend::GetDevice(&orig_device));
     NPU_CHECK_WARN(c10::backend::SetDevice(device_index));
-    NPU_CHECK_WARN(aclrtDestroyEvent(acl_event));
+    NPU_CHECK_WARN(
+        c10::npu::queue::LaunchLazyDestroyEventTask(acl_event, device_index));
     NPU_CHECK_WARN(c10::backend::SetDevice(orig_device));
   }
 
@@ -120,7 +122,8 @@ struct NPUGuardImpl final : public PrivateUse1GuardImpl {
       auto flag_ = ACL_EVENT_SYNC;
       NPU_CHECK_ERROR(aclrtCreateEventWithFlag(&npu_event, flag_));
     }
-    NPU_CHECK_ERROR(aclrtRecordEvent(npu_event, npu_stream));
+    NPU_CHECK_ERROR(
+        c10::npu::queue::LaunchRecordEventTask(npu_event, npu_stream));
     // Makes the void* point to the (possibly just allocated) NPU event
     *event = npu_event;
 
@@ -135,7 +138,8 @@ struct NPUGuardImpl final : public PrivateUse1GuardImpl {
     NPUStream npu_stream{stream};
     const auto orig_device = getDevice();
     setDevice(stream.device());
-    NPU_CHECK_ERROR(aclrtStreamWaitEvent(npu_stream, npu_event));
+    NPU_CHECK_ERROR(
+        c10::npu::queue::LaunchWaitEventTask(npu_event, npu_stream));
     setDevice(orig_device);
   }
 
@@ -144,6 +148,9 @@ struct NPUGuardImpl final : public PrivateUse1GuardImpl {
     if (!event)
       return true;
     aclrtEvent npu_event = static_cast<aclrtEvent>(event);
+    if (c10::npu::queue::IsEventRecordPending(npu_event)) {
+      return false;
+    }
     aclrtEventRecordedStatus status = ACL_EVENT_RECORDED_STATUS_NOT_READY;
     NPU_CHECK_ERROR(aclrtQueryEventStatus(npu_event, &status));
     return (status == ACL_EVENT_RECORDED_STATUS_COMPLETE);
@@ -153,6 +160,7 @@ struct NPUGuardImpl final : public PrivateUse1GuardImpl {
     if (!event)
       return;
     aclrtEvent npu_event = static_cast<aclrtEvent>(event);
+    c10::npu::DrainAllTaskQueues();
     NPU_CHECK_ERROR(aclrtSynchronizeEvent(npu_event));
   }
 };
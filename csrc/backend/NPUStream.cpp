@@ -1,7 +1,12 @@
 #include <array>
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "csrc/backend/NPUFunctions.h"
@@ -13,8 +18,7 @@
 #include "acl/include/acl/acl_rt.h"
 #include "adapter/acl_device_adapter.h"
 #include "core/NPUException.h"
-
-#define C10_COMPILE_TIME_MAX_NPUS 16
+#include "core/register/OptionsManager.h"
 
 namespace c10::backend {
 namespace {
@@ -22,39 +26,70 @@ namespace {
 // Global stream state and constants
 static c10::once_flag init_flag;
 static c10::DeviceIndex num_npus = -1;
-static constexpr int kStreamsPerPoolBits = 5;
-static constexpr int kStreamsPerPool = 1 << kStreamsPerPoolBits;
+static constexpr int kStreamsPerPoolBits = 10;
+static constexpr int kMaxStreamsPerPool = 1 << kStreamsPerPoolBits;
 static constexpr int kStreamTypeBits = 4;
 
-static std::once_flag device_flags[C10_COMPILE_TIME_MAX_NPUS];
+// Streams in each of the low and high priority pools, read from
+// NPU_STREAMS_PER_POOL when the stream state is initialized.
+static int streams_per_pool = 0;
+
+struct PooledStream {
+  c10::once_flag flag;
+  aclrtStream stream = nullptr;
+};
 
 // Non-default streams
-// Note: the number of NPU devices is determined at run time,
-// and the low and high priority pools are lazily initialized
-// when the first stream is requested for a device.
-// The device flags track the initialization of each device, while
+// Note: the number of NPU devices and the size of the pools are determined
+// at run time, and each stream of the low and high priority pools is lazily
+// created the first time it is used, so a process that only ever touches a
+// few pooled streams does not pay for creating all of them.
+// The flag of each pooled stream tracks its creation, while
 // the low and high priority counters track, for each device, the next stream
 // in the pool to be returned when a stream is requested (round-robin fashion
-// , see the note in NPUStream.h).
+// , see the note in NPUStream.h). Only the first shared_streams[p] streams of
+// pool p are handed out round-robin, the ones after them are reserved for
+// workloads, see reserveWorkloadStreams.
+// NOLINTNEXTLINE(*-arrays)
 static std::array<
-    std::array<std::atomic<uint32_t>, C10_COMPILE_TIME_MAX_NPUS>,
+    std::unique_ptr<std::atomic<uint32_t>[]>,
     max_compile_time_stream_priorities>
     priority_counters;
 
+// Stream i of pool p on device d is streams[p][d * streams_per_pool + i].
+// NOLINTNEXTLINE(*-arrays)
 static std::array<
-    std::array<
-        std::array<aclrtStream, kStreamsPerPool>,
-        C10_COMPILE_TIME_MAX_NPUS>,
+    std::unique_ptr<PooledStream[]>,
     max_compile_time_stream_priorities>
     streams;
 
+static std::array<std::atomic<int>, max_compile_time_stream_priorities>
+    shared_streams;
+
+// Whether getStreamFromPool handed out a stream of pool p, after which no
+// more streams of the pool can be reserved.
+static std::array<std::atomic<bool>, max_compile_time_stream_priorities>
+    pool_handed_out;
+
+struct WorkloadStreams {
+  int pool;
+  int first;
+  int count;
+  // NOLINTNEXTLINE(*-arrays)
+  std::unique_ptr<std::atomic<uint32_t>[]> counters;
+};
+
+static std::mutex workload_mutex;
+static std::unordered_map<std::string, std::unique_ptr<WorkloadStreams>>
+    workload_streams;
+
 thread_local std::unique_ptr<c10::StreamId[]> current_streams = nullptr;
 
 // Note [StreamId assignment]
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~
 // How do we assign stream IDs?
 //
-// -- 54 bits --  -- 5 bits -----  -- 4 bits --     --1 bit --
+// -- 49 bits --  -- 10 bits ----  -- 4 bits --     --1 bit --
 // zeros          stream id index  StreamIdType     Ext/native stream
 //                ignored for ext   ignored for ext
 // for external stream, StreamID is a aclStream_t pointer
@@ -150,38 +185,49 @@ c10::StreamId makeStreamId(StreamIdType st, size_t si) {
 
 static void initGlobalStreamState() {
   num_npus = c10::backend::device_count();
-  // Check if the number of NPUs matches the expected compile-time max number
-  // of NPUs.
-  AT_ASSERTM(
-      num_npus <= C10_COMPILE_TIME_MAX_NPUS,
-      "Number of NPU devices on the machine is larger than the compiled "
-      "max number of npus expected (",
-      C10_COMPILE_TIME_MAX_NPUS,
-      "). Increase that and recompile.",
+  streams_per_pool = static_cast<int>(
+      c10::npu::option::OptionsManager::GetStreamsPerPool());
+  TORCH_CHECK(
+      streams_per_pool >= 1 && streams_per_pool <= kMaxStreamsPerPool,
+      "NPU_STREAMS_PER_POOL must be between 1 and ",
+      kMaxStreamsPerPool,
+      ", but got ",
+      streams_per_pool,
       PTA_ERROR(ErrCode::VALUE));
+  // The pools are sized for the devices found, there is no compile time
+  // limit on their number.
+  const size_t slots = static_cast<size_t>(num_npus) * streams_per_pool;
+  for (const auto p : c10::irange(max_compile_time_stream_priorities)) {
+    streams[p] = std::make_unique<PooledStream[]>(slots);
+    priority_counters[p] = std::make_unique<std::atomic<uint32_t>[]>(num_npus);
+    shared_streams[p] = streams_per_pool;
+  }
 }
 
-// Init a single NPU stream
-static void initSingleStream(int p, c10::DeviceIndex device_index, int i) {
-  auto& stream = streams[p][device_index][i];
-  auto pri = -p; // lower number is higher priority
-
-  NPU_CHECK_SUPPORTED_OR_ERROR(aclrtCreateStreamWithConfig(
-      &stream, 0, (ACL_STREAM_FAST_LAUNCH | ACL_STREAM_FAST_SYNC)));
-  priority_counters[p][device_index] = 0;
+static inline PooledStream& pooledStream(
+    int p,
+    c10::DeviceIndex device_index,
+    int i) {
+  return streams[p][static_cast<size_t>(device_index) * streams_per_pool + i];
 }
 
-// Creates the low and high priority stream pools for the specified device
-// Warning: only call once per device!
-static void initDeviceStreamState(c10::DeviceIndex device_index) {
-  // Switches to the requested device so streams are properly associated
+// Creates stream i of pool p for the specified device
+// Warning: only call once per stream!
+//
+// Pooled streams are created with the runtime's default priority 0, the
+// priority of the default stream. 0 is also the most urgent priority the
+// runtime accepts, so there is nothing left above it for the high priority
+// pool: its streams are kept apart from the low priority ones but run with
+// the same priority, instead of demoting every normal pooled stream below
+// the default stream.
+static void initSingleStream(int p, c10::DeviceIndex device_index, int i) {
+  // Switches to the requested device so the stream is properly associated
   // with it.
   NPUGuard device_guard{device_index};
-  for (const auto i : c10::irange(kStreamsPerPool)) {
-    for (const auto p : c10::irange(max_compile_time_stream_priorities)) {
-      initSingleStream(p, device_index, i);
-    }
-  }
+  auto& stream = pooledStream(p, device_index, i).stream;
+  const uint32_t flags = ACL_STREAM_FAST_LAUNCH | ACL_STREAM_FAST_SYNC;
+  NPU_CHECK_SUPPORTED_OR_ERROR(
+      aclrtCreateStreamWithConfig(&stream, 0, flags));
 }
 
 static void initNPUStreamsOnce() {
@@ -211,9 +257,9 @@ static inline void check_npu(c10::DeviceIndex device_index) {
       PTA_ERROR(ErrCode::VALUE));
 }
 
-static uint32_t get_idx(std::atomic<uint32_t>& counter) {
+static uint32_t get_idx(std::atomic<uint32_t>& counter, int count) {
   auto raw_idx = counter++;
-  return raw_idx % kStreamsPerPool;
+  return raw_idx % static_cast<uint32_t>(count);
 }
 
 NPUStream NPUStreamForId(
@@ -259,13 +305,44 @@ aclrtStream NPUStream::stream() const {
         " with the value ",
         streamType,
         ")");
-    return streams[st.getStreamType() - 1][device_index][si];
+    c10::call_once(init_flag, initGlobalStreamState);
+    TORCH_CHECK(
+        si < static_cast<size_t>(streams_per_pool),
+        "Unrecognized stream ",
+        stream_,
+        " (the stream index ",
+        si,
+        " is out of the pool of ",
+        streams_per_pool,
+        " streams)");
+    const int p = streamType - 1;
+    // Creates the stream on first use. Once it exists, this is one atomic
+    // load.
+    auto& pooled = pooledStream(p, device_index, static_cast<int>(si));
+    c10::call_once(
+        pooled.flag,
+        initSingleStream,
+        p,
+        device_index,
+        static_cast<int>(si));
+    return pooled.stream;
   }
 }
 
+int NPUStream::priority() const {
+  // Every stream runs with the runtime's default priority, see
+  // initSingleStream.
+  return 0;
+}
+
+std::tuple<int, int> NPUStream::priority_range() {
+  // Like devices without stream priorities in c10, the range is empty.
+  return std::make_tuple(0, 0);
+}
+
 // Returns a stream from the requested pool
-// Note: when called the first time on a device, this will create the
-// stream pools for that device.
+// Note: this does not create the stream, which is created the first time
+// its aclrtStream is used.
 NPUStream getStreamFromPool(const int priority, c10::DeviceIndex device_index) {
   initNPUStreamsOnce();
   if (device_index == -1) {
@@ -274,14 +351,21 @@ NPUStream getStreamFromPool(const int priority, c10::DeviceIndex device_index) {
 
   check_npu(device_index);
 
-  // Initializes the stream pools (once)
-  std::call_once(
-      device_flags[device_index], initDeviceStreamState, device_index);
-
+  // The stream itself is only created when it is first used, see
+  // NPUStream::stream().
   auto pri_idx = -priority;
-  pri_idx = std::min(
-      pri_idx, max_compile_time_stream_priorities - 1); // pri_idx is zero-based
-  const auto idx = get_idx(priority_counters[pri_idx][device_index]);
+  pri_idx = std::clamp(
+      pri_idx,
+      0,
+      max_compile_time_stream_priorities - 1); // pri_idx is zero-based
+  // Marks the pool before reading its shared streams, reserveWorkloadStreams
+  // does the opposite, so either this reads the shrunk pool or the
+  // reservation sees the mark.
+  if (!pool_handed_out[pri_idx].load()) {
+    pool_handed_out[pri_idx].store(true);
+  }
+  const auto idx = get_idx(
+      priority_counters[pri_idx][device_index], shared_streams[pri_idx]);
   StreamIdType id_type = StreamIdType(pri_idx + 1);
   return NPUStreamForId(device_index, makeStreamId(id_type, idx));
 }
@@ -294,6 +378,85 @@ NPUStream getStreamFromPool(
   return getStreamFromPool(priority, device);
 }
 
+void reserveWorkloadStreams(
+    const std::string& workload,
+    int count,
+    const bool isHighPriority) {
+  c10::call_once(init_flag, initGlobalStreamState);
+  const int p = isHighPriority ? max_compile_time_stream_priorities - 1 : 0;
+  std::lock_guard<std::mutex> lock(workload_mutex);
+  auto it = workload_streams.find(workload);
+  if (it != workload_streams.end()) {
+    TORCH_CHECK(
+        it->second->pool == p && it->second->count == count,
+        "Streams were already reserved for workload ",
+        workload,
+        " with a different count or priority",
+        PTA_ERROR(ErrCode::PARAM));
+    return;
+  }
+  const int shared = shared_streams[p];
+  TORCH_CHECK(
+      count >= 1 && count < shared,
+      "Cannot reserve ",
+      count,
+      " streams for workload ",
+      workload,
+      ", ",
+      shared,
+      " streams of the pool are left and at least one must stay shared. "
+      "Set NPU_STREAMS_PER_POOL to a larger pool size.",
+      PTA_ERROR(ErrCode::PARAM));
+  // Reserved streams are taken from the end of the shared ones. Streams
+  // already handed out by getStreamFromPool may be any of them and keep being
+  // used, so the reservation is undone if the pool was used.
+  shared_streams[p] = shared - count;
+  if (pool_handed_out[p].load()) {
+    shared_streams[p] = shared;
+    TORCH_CHECK(
+        false,
+        "Cannot reserve streams for workload ",
+        workload,
+        ", streams of the pool were already handed out. "
+        "Reserve workload streams before taking streams from the pool.",
+        PTA_ERROR(ErrCode::PARAM));
+  }
+  auto reserved = std::make_unique<WorkloadStreams>();
+  reserved->pool = p;
+  reserved->first = shared - count;
+  reserved->count = count;
+  reserved->counters = std::make_unique<std::atomic<uint32_t>[]>(num_npus);
+  workload_streams.emplace(workload, std::move(reserved));
+}
+
+NPUStream getStreamForWorkload(
+    const std::string& workload,
+    c10::DeviceIndex device_index) {
+  initNPUStreamsOnce();
+  if (device_index == -1) {
+    device_index = c10::backend::current_device();
+  }
+  check_npu(device_index);
+
+  WorkloadStreams* reserved = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(workload_mutex);
+    auto it = workload_streams.find(workload);
+    TORCH_CHECK(
+        it != workload_streams.end(),
+        "No streams were reserved for workload ",
+        workload,
+        ", call reserveWorkloadStreams first",
+        PTA_ERROR(ErrCode::PARAM));
+    reserved = it->second.get();
+  }
+  // Reservations are never removed, so the entry outlives the lock.
+  const auto idx = reserved->first +
+      get_idx(reserved->counters[device_index], reserved->count);
+  StreamIdType id_type = StreamIdType(reserved->pool + 1);
+  return NPUStreamForId(device_index, makeStreamId(id_type, idx));
+}
+
 NPUStream getStreamFromExternal(
     aclrtStream ext_stream,
     c10::DeviceIndex device_index) {
@@ -329,14 +492,18 @@ std::ostream& operator<<(std::ostream& stream, const NPUStream& s) {
 }
 
 aclError DestroyUsedStreams() {
+  if (streams_per_pool == 0) {
+    // No pooled stream was ever requested.
+    return ACL_ERROR_NONE;
+  }
   c10::DeviceIndex cur_device = 0;
   NPU_CHECK_ERROR(c10::backend::GetDevice(&cur_device));
   std::vector<c10::DeviceIndex> device_idx_vec = acl_adapter::GetUsedDevices();
   for (const auto deviceId : device_idx_vec) {
     NPU_CHECK_ERROR(c10::backend::SetDevice(deviceId));
-    for (const auto i : c10::irange(kStreamsPerPool)) {
+    for (const auto i : c10::irange(streams_per_pool)) {
       for (const auto p : c10::irange(max_compile_time_stream_priorities)) {
-        aclrtStream stream = streams[p][deviceId][i];
+        aclrtStream stream = pooledStream(p, deviceId, i).stream;
         if (stream == nullptr) {
           continue;
         }
@@ -6,6 +6,8 @@
 #include <c10/util/SmallVector.h>
 #include <cstdint>
 #include <mutex>
+#include <string>
+#include <tuple>
 
 #include "csrc/aten/generated/NPUNativeFunctions.h"
 #include "csrc/core/Macros.h"
@@ -15,6 +17,7 @@
 #include "acl/include/acl/acl.h"
 #include "acl/include/acl/acl_op.h"
 #include "core/NPUException.h"
+#include "core/NPUQueue.h"
 
 /*
  * Stream pool note.
@@ -23,24 +26,33 @@
  * are backed by cuStreams, but they use several pools to minimize the costs
  * associated with creating, retaining, and destroying cuStreams.
  *
- * There are three pools per device, and a device's pools are lazily created.
+ * There are three pools per device, and the streams of a device's pools are
+ * lazily created, each one the first time it is used.
  *
  * The first pool contains only the default stream. When the default stream
  * is requested it's returned.
  *
  * The second pool is the "low priority" or "default priority" streams. In
  * HIP builds there is no distinction between streams in this pool and streams
- * in the third pool (below). There are 32 of these streams per device, and
- * when a stream is requested one of these streams is returned round-robin.
- * That is, the first stream requested is at index 0, the second at index 1...
- * to index 31, then index 0 again.
+ * in the third pool (below). There are 32 of these streams per device by
+ * default, up to 1024 with NPU_STREAMS_PER_POOL, and when a stream is
+ * requested one of these streams is returned round-robin. That is, the first
+ * stream requested is at index 0, the second at index 1... to index 31, then
+ * index 0 again.
  *
  * This means that if 33 low priority streams are requested, the first and
  * last streams requested are actually the same stream (under the covers)
  * and kernels enqueued on them cannot run concurrently.
  *
  * The third pool is the "high priority" streams. The third pool acts like
- * the second pool except the streams are created with a higher priority.
+ * the second pool, keeping high priority work off the streams of the second
+ * pool. The runtime has no priority above the default stream's, so its
+ * streams are created with the same priority as the other streams.
+ *
+ * Streams at the end of the second and third pools can be reserved for a
+ * named workload, e.g. dataloader copies or gradient all-reduce, with
+ * reserveWorkloadStreams. Reserved streams are only returned by
+ * getStreamForWorkload, so unrelated work never lands on them.
  *
  * These pools suggest that stream users should prefer many short-lived streams,
  * as the cost of acquiring and releasing streams is effectively zero. If
@@ -125,6 +137,7 @@ class C10_BACKEND_API NPUStream {
 
   bool query() const {
     c10::DeviceGuard guard{stream_.device()};
+    c10::npu::DrainTaskQueue(stream_.device_index());
     aclrtStreamStatus status = ACL_STREAM_STATUS_RESERVED;
     NPU_CHECK_ERROR(aclrtStreamQuery(stream(), &status));
     if (status == ACL_STREAM_STATUS_COMPLETE) {
@@ -135,12 +148,20 @@ class C10_BACKEND_API NPUStream {
 
   void synchronize() const {
     c10::DeviceGuard guard{stream_.device()};
+    c10::npu::DrainTaskQueue(stream_.device_index());
     NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(stream(), -1));
   }
 
-  // Explicit conversion to aclrtStream.
+  // Explicit conversion to aclrtStream. Creates pooled streams on first use.
   aclrtStream stream() const;
 
+  // Priority of the stream, lower numbers are higher priorities. All streams
+  // run with the runtime's default priority 0.
+  int priority() const;
+
+  // The least and greatest priorities of pooled streams, both 0.
+  static std::tuple<int, int> priority_range();
+
   // Explicit conversion to Stream.
   c10::Stream unwrap() const {
     return stream_;
@@ -189,6 +210,27 @@ C10_BACKEND_API NPUStream getStreamFromPool(
 C10_BACKEND_API NPUStream
 getStreamFromPool(const int priority, c10::DeviceIndex device = -1);
 
+/**
+ * Reserves count streams of the low or high priority pool of every device for
+ * the workload named workload. The streams reserved are no longer returned by
+ * getStreamFromPool. Reserve them before other work takes pooled streams:
+ * once getStreamFromPool handed out a stream of the pool, reserving throws.
+ * Reserving again with the same count and priority does nothing. At least one stream of the pool must
+ * stay shared.
+ */
+C10_BACKEND_API void reserveWorkloadStreams(
+    const std::string& workload,
+    int count,
+    const bool isHighPriority = false);
+
+/**
+ * Get a stream reserved for workload, for the passed NPU device or the
+ * current one. The reserved streams are returned round-robin.
+ */
+C10_BACKEND_API NPUStream getStreamForWorkload(
+    const std::string& workload,
+    c10::DeviceIndex device = -1);
+
 /**
  * Get a NPUStream from a externally allocated one.
  *
@@ -0,0 +1,99 @@
+#include "csrc/core/allocator/AllocatorTrace.h"
+
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+#include <c10/util/Exception.h>
+#include <c10/util/flat_hash_map.h>
+
+namespace c10::backend::CachingAllocator {
+
+namespace {
+
+constexpr char kTraceMagic[8] = {'N', 'P', 'U', 'A', 'L', 'T', 'R', 'C'};
+constexpr uint32_t kTraceVersion = 1;
+
+struct TraceHeader {
+  char magic[8];
+  uint32_t version;
+  uint32_t num_streams;
+  uint64_t num_records;
+};
+
+struct FileCloser {
+  void operator()(FILE* file) const {
+    fclose(file);
+  }
+};
+
+using File = std::unique_ptr<FILE, FileCloser>;
+
+} // namespace
+
+void dumpTrace(const std::string& path, const SnapshotInfo& snapshot) {
+  std::vector<TraceRecord> records;
+  ska::flat_hash_map<void*, uint16_t> streams;
+  for (const auto& trace : snapshot.device_traces) {
+    for (const auto& te : trace) {
+      if (te.action_ == TraceEntry::SNAPSHOT) {
+        continue;
+      }
+      auto it = streams.find(te.stream_);
+      if (it == streams.end()) {
+        TORCH_CHECK(
+            streams.size() <= std::numeric_limits<uint16_t>::max(),
+            "Too many streams in the allocator trace");
+        it = streams.emplace(te.stream_, streams.size()).first;
+      }
+      TraceRecord record{};
+      record.action = static_cast<uint8_t>(te.action_);
+      record.device = static_cast<int8_t>(te.device_);
+      record.stream = it->second;
+      record.addr = te.addr_;
+      record.size = te.size_;
+      records.push_back(record);
+    }
+  }
+
+  TraceHeader header{};
+  memcpy(header.magic, kTraceMagic, sizeof(kTraceMagic));
+  header.version = kTraceVersion;
+  header.num_streams = static_cast<uint32_t>(streams.size());
+  header.num_records = records.size();
+
+  File file(fopen(path.c_str(), "wb"));
+  TORCH_CHECK(file, "Failed to open ", path, " for writing");
+  bool ok = fwrite(&header, sizeof(header), 1, file.get()) == 1 &&
+      fwrite(records.data(), sizeof(TraceRecord), records.size(), file.get()) ==
+          records.size();
+  TORCH_CHECK(ok, "Failed to write the allocator trace to ", path);
+}
+
+std::vector<TraceRecord> loadTrace(const std::string& path) {
+  File file(fopen(path.c_str(), "rb"));
+  TORCH_CHECK(file, "Failed to open ", path);
+
+  TraceHeader header{};
+  TORCH_CHECK(
+      fread(&header, sizeof(header), 1, file.get()) == 1 &&
+          memcmp(header.magic, kTraceMagic, sizeof(kTraceMagic)) == 0,
+      path,
+      " is not an allocator trace");
+  TORCH_CHECK(
+      header.version == kTraceVersion,
+      "Unsupported allocator trace version ",
+      header.version);
+
+  std::vector<TraceRecord> records(header.num_records);
+  TORCH_CHECK(
+      fread(records.data(), sizeof(TraceRecord), records.size(), file.get()) ==
+          records.size(),
+      "Allocator trace ",
+      path,
+      " is truncated");
+  return records;
+}
+
+} // namespace c10::backend::CachingAllocator
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "csrc/core/allocator/CachingAllocator.h"
+
+namespace c10::backend::CachingAllocator {
+
+// Compact binary form of the allocator history kept by recordHistory, so a
+// trace taken from a real run can be replayed offline. The file is a header
+// followed by fixed size records in native byte order:
+//
+//   char magic[8] = "NPUALTRC"; uint32 version; uint32 num_streams;
+//   uint64 num_records; TraceRecord records[num_records];
+//
+// Stack contexts are dropped and streams are stored as indices in order of
+// first use. Records of one device keep their order, records of different
+// devices follow each other device by device.
+struct TraceRecord {
+  uint8_t action; // TraceEntry::Action
+  int8_t device;
+  uint16_t stream;
+  uint32_t reserved;
+  int64_t addr; // for OOM, the free bytes reported by the device
+  int64_t size;
+};
+
+static_assert(sizeof(TraceRecord) == 24, "TraceRecord is part of the format");
+
+// Writes the device traces of snapshot to path.
+void dumpTrace(const std::string& path, const SnapshotInfo& snapshot);
+
+// Reads a trace written by dumpTrace.
+std::vector<TraceRecord> loadTrace(const std::string& path);
+
+} // namespace c10::backend::CachingAllocator
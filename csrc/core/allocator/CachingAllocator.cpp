@@ -1,11 +1,15 @@
 #include <algorithm>
+#include <array>
 #include <bitset>
+#include <chrono>
+#include <condition_variable>
 #include <deque>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <regex>
 #include <set>
+#include <thread>
 #include <vector>
 
 #include <c10/core/Allocator.h>
@@ -15,7 +19,10 @@
 #include <c10/util/Optional.h>
 #include <c10/util/UniqueVoidPtr.h>
 #include <c10/util/flat_hash_map.h>
+#include <c10/util/hash.h>
 #include <c10/util/irange.h>
+#include <c10/util/llvmMathExtras.h>
+#include <c10/util/thread_name.h>
 
 #include "csrc/core/allocator/CachingAllocator.h"
 #include "csrc/core/allocator/EventPool.h"
@@ -28,20 +35,6 @@ inline const c10::impl::DeviceGuardImplInterface* getDeviceGuardImpl() {
   return c10::impl::getDeviceGuardImpl(c10::kPrivateUse1);
 }
 
-inline const c10::DeviceIndex getDeviceIndex() {
-  auto device = getDeviceGuardImpl()->getDevice();
-  return device.index();
-}
-
-inline void setDevice(c10::DeviceIndex deviceIndex) {
-  c10::Device device(c10::kPrivateUse1, deviceIndex);
-  getDeviceGuardImpl()->setDevice(device);
-}
-
-inline const c10::DeviceIndex deviceCount() {
-  return getDeviceGuardImpl()->deviceCount();
-}
-
 //
 // Yet another caching allocator for device allocations.
 //
@@ -81,9 +74,14 @@ constexpr size_t kSmallBuffer =
     2097152; // "small" allocations are packed in 2 MiB blocks
 constexpr size_t kLargeBuffer =
     20971520; // "large" allocations may be packed in 20 MiB blocks
-constexpr size_t kMinLargeAlloc =
-    10485760; // allocations between 1 and 10 MiB may use kLargeBuffer
 constexpr size_t kRoundLarge = 2097152; // round up large allocs to 2 MiB
+// kSmallSize, kLargeBuffer and kRoundLarge are the defaults of the
+// small_size_kb, large_buffer_mb and round_large_mb settings. Allocations
+// below half of the large buffer may be packed in it.
+constexpr size_t kRoundUpPowerOfTwoIntervals =
+    16; // roundup_power2_divisions intervals, from 1 MiB to 32 GiB and above
+constexpr size_t kMaxEventBatch =
+    32; // blocks freed on a stream that share one event
 
 using StatTypes = std::array<bool, static_cast<size_t>(StatType::NUM_TYPES)>;
 
@@ -126,20 +124,45 @@ void update_stat_array(
       });
 }
 
+void update_histogram(Histogram& histogram, int64_t value) {
+  size_t bucket = value > 0 ? c10::llvm::Log2_64(value) : 0;
+  histogram[bucket]++;
+}
+
+void update_histogram_array(
+    HistogramArray& histogram_array,
+    int64_t value,
+    const StatTypes& stat_types) {
+  for_each_selected_stat_type(
+      stat_types, [&histogram_array, value](size_t stat_type) {
+        update_histogram(histogram_array[stat_type], value);
+      });
+}
+
+int64_t elapsed_us(std::chrono::steady_clock::time_point since) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - since)
+      .count();
+}
+
 struct Block;
 using Comparison = bool (*)(const Block*, const Block*);
 static bool BlockComparatorSize(const Block* a, const Block* b);
 static bool BlockComparatorAddress(const Block* a, const Block* b);
 
+struct PrivatePool;
+
 struct BlockPool {
   std::set<Block*, Comparison> blocks;
   std::set<Block*, Comparison> unmapped;
   const bool is_small;
+  PrivatePool* owner_PrivatePool;
 
-  BlockPool(bool small)
+  BlockPool(bool small, PrivatePool* private_pool = nullptr)
       : blocks(BlockComparatorSize),
         unmapped(BlockComparatorAddress),
-        is_small(small) {}
+        is_small(small),
+        owner_PrivatePool(private_pool) {}
 };
 
 struct ExpandableSegment;
@@ -164,6 +187,8 @@ struct Block {
   int gc_count{0}; // counter for prioritizing older / less useful blocks for
                    // garbage collection
   ExpandableSegment* expandable_segment_ = nullptr;
+  // when the block was last handed out, for the lifetime histogram
+  std::chrono::steady_clock::time_point allocated_at;
 
   std::shared_ptr<c10::GatheredContext> context_when_allocated;
   // only set for the first block in the segment (when prev == null)
@@ -227,6 +252,18 @@ struct Block {
 typedef void* MemGenericAllocationHandle; // like CUmemGenericAllocationHandle
 CachingAllocatorHelper* helper;
 
+inline const c10::DeviceIndex getDeviceIndex() {
+  return helper->getDevice();
+}
+
+inline void setDevice(c10::DeviceIndex deviceIndex) {
+  helper->setDevice(deviceIndex);
+}
+
+inline const c10::DeviceIndex deviceCount() {
+  return helper->deviceCount();
+}
+
 struct SegmentRange {
   char* ptr;
   size_t size;
@@ -407,7 +444,7 @@ struct ExpandableSegment {
     // cannot call c10::npu::stream_synchronize because
     // it might grab the GIL which can lead to a deadlock
     // Locking order must be GIL -> Allocator Lock
-    helper->synchronizeStream(stream_);
+    helper->synchronizeStream(device_, stream_);
     for (auto i : c10::irange(begin, end)) {
       MemGenericAllocationHandle h = handles_.at(i).value();
       handles_.at(i) = c10::nullopt;
@@ -502,6 +539,135 @@ static std::string format_size(uint64_t size) {
   return os.str();
 }
 
+StatTypes get_stat_types_for_pool(const BlockPool& pool) {
+  StatTypes stat_types = {false};
+  stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
+  stat_types[static_cast<size_t>(
+      pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL)] = true;
+  return stat_types;
+}
+
+// Changes to a Stat not applied yet: the amounts added and removed, and the
+// highest the running sum of the changes got.
+struct StatDelta {
+  int64_t added = 0;
+  int64_t removed = 0;
+  int64_t peak = 0;
+
+  void update(int64_t amount) {
+    if (amount > 0) {
+      added += amount;
+    } else {
+      removed -= amount;
+    }
+    peak = std::max(peak, added - removed);
+  }
+
+  // Appends the changes of later.
+  void append(const StatDelta& later) {
+    peak = std::max(peak, added - removed + later.peak);
+    added += later.added;
+    removed += later.removed;
+  }
+
+  void apply(Stat& stat) const {
+    stat.peak = std::max(stat.peak, stat.current + peak);
+    stat.current += added - removed;
+    stat.allocated += added;
+    stat.freed += removed;
+  }
+};
+
+// Device stats of the blocks a thread cache handed out again or took back,
+// kept with the cache so that hits and frees never lock the device
+// allocator. They are applied the next time the thread enters the device
+// allocator, and when the stats are read or the caches drained.
+struct ThreadCacheStats {
+  static constexpr size_t kNumTypes = static_cast<size_t>(StatType::NUM_TYPES);
+
+  std::array<StatDelta, kNumTypes> allocation;
+  std::array<StatDelta, kNumTypes> allocated_bytes;
+  std::array<StatDelta, kNumTypes> active;
+  std::array<StatDelta, kNumTypes> active_bytes;
+  std::array<StatDelta, kNumTypes> requested_bytes;
+  HistogramArray allocation_size_histogram{};
+  HistogramArray block_lifetime_histogram{};
+  bool empty = true;
+
+  // A cached block handed out for orig_size bytes, as malloc accounts for it.
+  void record_reuse(const Block* block, size_t orig_size);
+  // A block freed into the cache, as free accounts for it.
+  void record_keep(const Block* block, int64_t lifetime);
+  void append(const ThreadCacheStats& later);
+  void apply(DeviceStats& stats) const;
+};
+
+void ThreadCacheStats::record_reuse(const Block* block, size_t orig_size) {
+  const auto size = static_cast<int64_t>(block->size);
+  for_each_selected_stat_type(
+      get_stat_types_for_pool(*block->pool), [&](size_t stat_type) {
+        allocation[stat_type].update(1);
+        allocated_bytes[stat_type].update(size);
+        active[stat_type].update(1);
+        active_bytes[stat_type].update(size);
+        requested_bytes[stat_type].update(static_cast<int64_t>(orig_size));
+        update_histogram(
+            allocation_size_histogram[stat_type],
+            static_cast<int64_t>(orig_size));
+      });
+  empty = false;
+}
+
+void ThreadCacheStats::record_keep(const Block* block, int64_t lifetime) {
+  const auto size = static_cast<int64_t>(block->size);
+  for_each_selected_stat_type(
+      get_stat_types_for_pool(*block->pool), [&](size_t stat_type) {
+        allocation[stat_type].update(-1);
+        allocated_bytes[stat_type].update(-size);
+        active[stat_type].update(-1);
+        active_bytes[stat_type].update(-size);
+        requested_bytes[stat_type].update(
+            -static_cast<int64_t>(block->requested_size));
+        update_histogram(block_lifetime_histogram[stat_type], lifetime);
+      });
+  empty = false;
+}
+
+void ThreadCacheStats::append(const ThreadCacheStats& later) {
+  if (later.empty) {
+    return;
+  }
+  for (size_t i = 0; i < kNumTypes; i++) {
+    allocation[i].append(later.allocation[i]);
+    allocated_bytes[i].append(later.allocated_bytes[i]);
+    active[i].append(later.active[i]);
+    active_bytes[i].append(later.active_bytes[i]);
+    requested_bytes[i].append(later.requested_bytes[i]);
+    for (size_t j = 0; j < kHistogramBuckets; j++) {
+      allocation_size_histogram[i][j] += later.allocation_size_histogram[i][j];
+      block_lifetime_histogram[i][j] += later.block_lifetime_histogram[i][j];
+    }
+  }
+  empty = false;
+}
+
+void ThreadCacheStats::apply(DeviceStats& stats) const {
+  if (empty) {
+    return;
+  }
+  for (size_t i = 0; i < kNumTypes; i++) {
+    allocation[i].apply(stats.allocation[i]);
+    allocated_bytes[i].apply(stats.allocated_bytes[i]);
+    active[i].apply(stats.active[i]);
+    active_bytes[i].apply(stats.active_bytes[i]);
+    requested_bytes[i].apply(stats.requested_bytes[i]);
+    for (size_t j = 0; j < kHistogramBuckets; j++) {
+      stats.allocation_size_histogram[i][j] += allocation_size_histogram[i][j];
+      stats.block_lifetime_histogram[i][j] += block_lifetime_histogram[i][j];
+    }
+  }
+}
+
 struct AllocParams {
   AllocParams(
       c10::DeviceIndex device,
@@ -533,20 +699,82 @@ struct AllocParams {
   StatTypes stat_types = {false};
   int err;
 };
+
+// Private pools keep their own cached blocks, which are never handed out to
+// allocations outside of the pool. Blocks remember their pool through
+// Block::pool->owner_PrivatePool.
+struct PrivatePool {
+  PrivatePool()
+      : large_blocks(/*small=*/false, this),
+        small_blocks(/*small=*/true, this) {}
+  PrivatePool(const PrivatePool&) = delete;
+  PrivatePool(PrivatePool&&) = delete;
+  PrivatePool& operator=(const PrivatePool&) = delete;
+  // Number of beginAllocateToPool not yet matched by a releasePool.
+  int use_count{1};
+  // Number of segments of the pool that have not been freed yet. Once the
+  // pool is released and this drops to 0, the pool can be destroyed.
+  int npuMalloc_count{0};
+  size_t reserved_bytes{0};
+  size_t allocated_bytes{0};
+  BlockPool large_blocks;
+  BlockPool small_blocks;
+};
 } // namespace
 
 class CachingAllocatorConfig {
  public:
   static size_t max_split_size() {
-    return instance().m_max_split_size;
+    return settings().max_split_size;
   }
 
   static double garbage_collection_threshold() {
-    return instance().m_garbage_collection_threshold;
+    return settings().garbage_collection_threshold;
   }
 
   static bool expandable_segments() {
-    return instance().m_expandable_segments;
+    return settings().expandable_segments;
+  }
+
+  static size_t thread_cache_size() {
+    return settings().thread_cache_size;
+  }
+
+  static size_t background_reclaim_interval() {
+    return instance().m_background_reclaim_interval;
+  }
+
+  static size_t small_size() {
+    return settings().small_size;
+  }
+
+  static size_t large_buffer() {
+    return settings().large_buffer;
+  }
+
+  static size_t min_large_alloc() {
+    return settings().large_buffer / 2;
+  }
+
+  static size_t round_large() {
+    return settings().round_large;
+  }
+
+  // Divisions of the power of two interval of size that allocations of
+  // this size are rounded up to, 0 or 1 to only round to kMinBlockSize.
+  static size_t roundup_power2_divisions(size_t size) {
+    size_t log_size = 63 - c10::llvm::countLeadingZeros(size);
+    // Intervals start at 1 MiB, smaller sizes share the first one.
+    const size_t interval_start =
+        63 - c10::llvm::countLeadingZeros(static_cast<size_t>(1048576));
+    const size_t index =
+        (log_size > interval_start) ? (log_size - interval_start) : 0;
+    return settings().roundup_power2_divisions[std::min(
+        index, kRoundUpPowerOfTwoIntervals - 1)];
+  }
+
+  static std::vector<size_t> roundup_power2_divisions() {
+    return settings().roundup_power2_divisions;
   }
 
   static CachingAllocatorConfig& instance() {
@@ -562,15 +790,34 @@ class CachingAllocatorConfig {
   void parseArgs(const char* env);
 
  private:
-  size_t m_max_split_size;
-  double m_garbage_collection_threshold;
-  bool m_expandable_segments;
-  bool set_expandable_segments_flag = false;
+  // Options set by PYTORCH_ALLOC_CONF, defaults when not set.
+  struct Settings {
+    size_t max_split_size = std::numeric_limits<size_t>::max();
+    double garbage_collection_threshold = 0;
+    bool expandable_segments = true;
+    size_t thread_cache_size = 0;
+    size_t background_reclaim_interval = 0;
+    size_t small_size = kSmallSize;
+    size_t large_buffer = kLargeBuffer;
+    size_t round_large = kRoundLarge;
+    std::vector<size_t> roundup_power2_divisions =
+        std::vector<size_t>(kRoundUpPowerOfTwoIntervals, 0);
+  };
+
+  // Settings in use. Allocations and the reclaim thread read them without a
+  // lock while parseArgs runs, so new settings are published with a single
+  // store and the ones they replace are kept alive in m_published.
+  std::atomic<const Settings*> m_settings;
+  std::mutex m_publish_mutex;
+  std::vector<std::unique_ptr<const Settings>> m_published;
+  bool m_expandable_segments_supported;
+  // Also read by the background reclaim thread.
+  std::atomic<size_t> m_background_reclaim_interval;
 
   CachingAllocatorConfig()
-      : m_max_split_size(std::numeric_limits<size_t>::max()),
-        m_garbage_collection_threshold(0),
-        m_expandable_segments(true) {
+      : m_settings(nullptr),
+        m_expandable_segments_supported(true),
+        m_background_reclaim_interval(0) {
     void* ptr = nullptr;
     auto status = helper->memAddressReserve(&ptr, 512, 0, NULL, 1);
     if (status == MEM_SUCCESS) {
@@ -579,22 +826,50 @@ class CachingAllocatorConfig {
       TORCH_WARN_ONCE(
           "expandable_segments feature is not supportted and "
           "the possible cause is that driver and firmware packages do not match.");
-      m_expandable_segments = false;
+      m_expandable_segments_supported = false;
     }
   }
 
+  static const Settings& settings() {
+    return *instance().m_settings.load(std::memory_order_acquire);
+  }
+
+  void publish(Settings settings);
+
   void lexArgs(const char* env, std::vector<std::string>& config);
   void consumeToken(
       const std::vector<std::string>& config,
       size_t i,
       const char c);
-  size_t parseMaxSplitSize(const std::vector<std::string>& config, size_t i);
+  size_t parseMaxSplitSize(
+      const std::vector<std::string>& config,
+      size_t i,
+      Settings& settings);
   size_t parseGarbageCollectionThreshold(
       const std::vector<std::string>& config,
-      size_t i);
+      size_t i,
+      Settings& settings);
   size_t parseExpandableSegments(
       const std::vector<std::string>& config,
-      size_t i);
+      size_t i,
+      Settings& settings);
+  size_t parseThreadCacheSize(
+      const std::vector<std::string>& config,
+      size_t i,
+      Settings& settings);
+  size_t parseBackgroundReclaim(
+      const std::vector<std::string>& config,
+      size_t i,
+      Settings& settings);
+  size_t parseRoundUpPower2Divisions(
+      const std::vector<std::string>& config,
+      size_t i,
+      Settings& settings);
+  size_t parseSizeThreshold(
+      const std::vector<std::string>& config,
+      size_t i,
+      size_t unit,
+      size_t& value);
 };
 
 void CachingAllocatorConfig::lexArgs(
@@ -631,17 +906,14 @@ void CachingAllocatorConfig::consumeToken(
 
 size_t CachingAllocatorConfig::parseMaxSplitSize(
     const std::vector<std::string>& config,
-    size_t i) {
+    size_t i,
+    Settings& settings) {
   consumeToken(config, ++i, ':');
   if (++i < config.size()) {
+    // Checked against large_buffer_mb once all options are parsed.
     size_t val1 = static_cast<size_t>(stoi(config[i]));
-    TORCH_CHECK(
-        val1 > kLargeBuffer / (1024 * 1024),
-        "CachingAllocator option max_split_size_mb too small, must be > ",
-        kLargeBuffer / (1024 * 1024));
-    val1 = std::max(val1, kLargeBuffer / (1024 * 1024));
     val1 = std::min(val1, (std::numeric_limits<size_t>::max() / (1024 * 1024)));
-    m_max_split_size = val1 * 1024 * 1024;
+    settings.max_split_size = val1 * 1024 * 1024;
   } else {
     TORCH_CHECK(false, "Error, expecting max_split_size_mb value");
   }
@@ -650,7 +922,8 @@ size_t CachingAllocatorConfig::parseMaxSplitSize(
 
 size_t CachingAllocatorConfig::parseGarbageCollectionThreshold(
     const std::vector<std::string>& config,
-    size_t i) {
+    size_t i,
+    Settings& settings) {
   consumeToken(config, ++i, ':');
   if (++i < config.size()) {
     double val1 = stod(config[i]);
@@ -658,7 +931,7 @@ size_t CachingAllocatorConfig::parseGarbageCollectionThreshold(
         val1 > 0, "garbage_collect_threshold too small, set it 0.0~1.0");
     TORCH_CHECK(
         val1 < 1.0, "garbage_collect_threshold too big, set it 0.0~1.0");
-    m_garbage_collection_threshold = val1;
+    settings.garbage_collection_threshold = val1;
   } else {
     TORCH_CHECK(false, "Error, expecting garbage_collection_threshold value");
   }
@@ -667,14 +940,15 @@ size_t CachingAllocatorConfig::parseGarbageCollectionThreshold(
 
 size_t CachingAllocatorConfig::parseExpandableSegments(
     const std::vector<std::string>& config,
-    size_t i) {
+    size_t i,
+    Settings& settings) {
   consumeToken(config, ++i, ':');
   if (++i < config.size()) {
     TORCH_CHECK(
         i < config.size() && (config[i] == "True" || config[i] == "False"),
         "Expected a single True/False argument for expandable_segments");
-    m_expandable_segments = (config[i] == "True");
-    if (m_expandable_segments) {
+    settings.expandable_segments = (config[i] == "True");
+    if (settings.expandable_segments) {
       void* ptr = nullptr;
       auto status = helper->memAddressReserve(&ptr, 512, 0, NULL, 1);
       if (status == MEM_SUCCESS) {
@@ -682,7 +956,7 @@ size_t CachingAllocatorConfig::parseExpandableSegments(
       } else {
         TORCH_WARN_ONCE(
             "expandable_segments setting failure, now change to expandable_segments = false.");
-        m_expandable_segments = false;
+        settings.expandable_segments = false;
       }
     }
   } else {
@@ -691,26 +965,157 @@ size_t CachingAllocatorConfig::parseExpandableSegments(
   return i;
 }
 
-void CachingAllocatorConfig::parseArgs(const char* env) {
-  // If empty, set the default values
-  m_max_split_size = std::numeric_limits<size_t>::max();
-  m_garbage_collection_threshold = 0;
+size_t CachingAllocatorConfig::parseThreadCacheSize(
+    const std::vector<std::string>& config,
+    size_t i,
+    Settings& settings) {
+  consumeToken(config, ++i, ':');
+  if (++i < config.size()) {
+    int val1 = stoi(config[i]);
+    TORCH_CHECK(
+        val1 >= 0, "CachingAllocator option thread_cache_size_kb is negative");
+    settings.thread_cache_size = static_cast<size_t>(val1) * 1024;
+  } else {
+    TORCH_CHECK(false, "Error, expecting thread_cache_size_kb value");
+  }
+  return i;
+}
 
-  if (env == nullptr) {
-    return;
+size_t CachingAllocatorConfig::parseBackgroundReclaim(
+    const std::vector<std::string>& config,
+    size_t i,
+    Settings& settings) {
+  consumeToken(config, ++i, ':');
+  if (++i < config.size()) {
+    int val1 = stoi(config[i]);
+    TORCH_CHECK(
+        val1 >= 0, "CachingAllocator option background_reclaim_ms is negative");
+    settings.background_reclaim_interval = static_cast<size_t>(val1);
+  } else {
+    TORCH_CHECK(false, "Error, expecting background_reclaim_ms value");
+  }
+  return i;
+}
+
+size_t CachingAllocatorConfig::parseRoundUpPower2Divisions(
+    const std::vector<std::string>& config,
+    size_t i,
+    Settings& settings) {
+  consumeToken(config, ++i, ':');
+  bool first_value = true;
+  if (++i < config.size()) {
+    if (config[i].compare("[") == 0) {
+      // [<interval start in MiB>:<divisions>,...,>:<divisions>], intervals
+      // before the first one use its divisions, '>' sets all later ones.
+      size_t last_index = 0;
+      while (++i < config.size() && config[i].compare("]") != 0) {
+        const std::string& val1 = config[i];
+        size_t val2 = 0;
+        consumeToken(config, ++i, ':');
+        if (++i < config.size()) {
+          val2 = static_cast<size_t>(stoi(config[i]));
+        } else {
+          TORCH_CHECK(false, "Error parsing roundup_power2_divisions value");
+        }
+        TORCH_CHECK(
+            val2 == 0 || c10::llvm::isPowerOf2_64(val2),
+            "For roundups, the divisions have to be a power of 2 or 0 to "
+            "disable roundup");
+        if (val1 == ">") {
+          std::fill(
+              std::next(settings.roundup_power2_divisions.begin(), last_index),
+              settings.roundup_power2_divisions.end(),
+              val2);
+        } else {
+          size_t val1_long = stoul(val1);
+          TORCH_CHECK(
+              c10::llvm::isPowerOf2_64(val1_long),
+              "For roundups, the intervals have to be a power of 2, got ",
+              val1);
+          size_t index = 63 - c10::llvm::countLeadingZeros(val1_long);
+          index = std::min(index, settings.roundup_power2_divisions.size() - 1);
+          if (first_value) {
+            std::fill(
+                settings.roundup_power2_divisions.begin(),
+                std::next(settings.roundup_power2_divisions.begin(), index),
+                val2);
+            first_value = false;
+          }
+          settings.roundup_power2_divisions[index] = val2;
+          last_index = index;
+        }
+        if (i + 1 < config.size() && config[i + 1].compare("]") != 0) {
+          consumeToken(config, ++i, ',');
+        }
+      }
+      TORCH_CHECK(
+          i < config.size(), "Error, expecting ] in roundup_power2_divisions");
+    } else {
+      size_t val1 = static_cast<size_t>(stoi(config[i]));
+      TORCH_CHECK(
+          c10::llvm::isPowerOf2_64(val1),
+          "For roundups, the divisions have to be a power of 2");
+      std::fill(
+          settings.roundup_power2_divisions.begin(),
+          settings.roundup_power2_divisions.end(),
+          val1);
+    }
+  } else {
+    TORCH_CHECK(false, "Error, expecting roundup_power2_divisions value");
   }
+  return i;
+}
+
+size_t CachingAllocatorConfig::parseSizeThreshold(
+    const std::vector<std::string>& config,
+    size_t i,
+    size_t unit,
+    size_t& value) {
+  const std::string& name = config[i];
+  consumeToken(config, ++i, ':');
+  if (++i < config.size()) {
+    int val1 = stoi(config[i]);
+    TORCH_CHECK(val1 > 0, "CachingAllocator option ", name, " must be > 0");
+    value = static_cast<size_t>(val1) * unit;
+  } else {
+    TORCH_CHECK(false, "Error, expecting ", name, " value");
+  }
+  return i;
+}
+
+void CachingAllocatorConfig::parseArgs(const char* env) {
+  // Options are parsed and checked into a new set of settings, which only
+  // replaces the one in use once all of them are accepted. Options that are
+  // not set get their default values.
+  Settings settings;
+  settings.expandable_segments = m_expandable_segments_supported;
+  bool set_expandable_segments_flag = false;
 
   std::vector<std::string> config;
-  lexArgs(env, config);
+  if (env != nullptr) {
+    lexArgs(env, config);
+  }
 
   for (size_t i = 0; i < config.size(); i++) {
     if (config[i].compare("max_split_size_mb") == 0) {
-      i = parseMaxSplitSize(config, i);
+      i = parseMaxSplitSize(config, i, settings);
     } else if (config[i].compare("garbage_collection_threshold") == 0) {
-      i = parseGarbageCollectionThreshold(config, i);
+      i = parseGarbageCollectionThreshold(config, i, settings);
     } else if (config[i] == "expandable_segments") {
       set_expandable_segments_flag = true;
-      i = parseExpandableSegments(config, i);
+      i = parseExpandableSegments(config, i, settings);
+    } else if (config[i] == "thread_cache_size_kb") {
+      i = parseThreadCacheSize(config, i, settings);
+    } else if (config[i] == "background_reclaim_ms") {
+      i = parseBackgroundReclaim(config, i, settings);
+    } else if (config[i] == "roundup_power2_divisions") {
+      i = parseRoundUpPower2Divisions(config, i, settings);
+    } else if (config[i] == "small_size_kb") {
+      i = parseSizeThreshold(config, i, 1024, settings.small_size);
+    } else if (config[i] == "large_buffer_mb") {
+      i = parseSizeThreshold(config, i, 1024 * 1024, settings.large_buffer);
+    } else if (config[i] == "round_large_mb") {
+      i = parseSizeThreshold(config, i, 1024 * 1024, settings.round_large);
     } else {
       TORCH_CHECK(false, "Unrecognized CachingAllocator option: ", config[i]);
     }
@@ -720,22 +1125,48 @@ void CachingAllocatorConfig::parseArgs(const char* env) {
     }
   }
 
-  if (m_expandable_segments) {
+  // Small allocations are packed in kSmallBuffer segments, and the ones
+  // right above small_size in half of a large buffer.
+  TORCH_CHECK(
+      settings.small_size <= kSmallBuffer,
+      "CachingAllocator option small_size_kb too big, must be <= ",
+      kSmallBuffer / 1024);
+  TORCH_CHECK(
+      settings.large_buffer / 2 > settings.small_size,
+      "CachingAllocator option large_buffer_mb too small, must be > ",
+      "twice small_size_kb");
+  TORCH_CHECK(
+      settings.max_split_size == std::numeric_limits<size_t>::max() ||
+          settings.max_split_size > settings.large_buffer,
+      "CachingAllocator option max_split_size_mb too small, must be > ",
+      settings.large_buffer / (1024 * 1024));
+
+  if (settings.expandable_segments) {
     if (set_expandable_segments_flag) {
       TORCH_CHECK(
-          m_max_split_size == std::numeric_limits<size_t>::max() &&
-              m_garbage_collection_threshold == 0,
+          settings.max_split_size == std::numeric_limits<size_t>::max() &&
+              settings.garbage_collection_threshold == 0,
           "`max_split_size_mb` or `garbage_collection_threshold`, cannot be enabled with "
           "`expandable_segments`, please set `expandable_segments` to `false`.");
     } else if (
-        m_max_split_size != std::numeric_limits<size_t>::max() ||
-        m_garbage_collection_threshold != 0) {
-      m_expandable_segments = false;
+        settings.max_split_size != std::numeric_limits<size_t>::max() ||
+        settings.garbage_collection_threshold != 0) {
+      settings.expandable_segments = false;
       TORCH_WARN_ONCE(
           "`max_split_size_mb` or `garbage_collection_threshold` is enabled, and the "
           "`expandable_segments` is changed to `false` by default.");
     }
   }
+
+  publish(std::move(settings));
+}
+
+void CachingAllocatorConfig::publish(Settings settings) {
+  std::lock_guard<std::mutex> lock(m_publish_mutex);
+  m_published.push_back(std::make_unique<const Settings>(std::move(settings)));
+  const Settings* published = m_published.back().get();
+  m_settings.store(published, std::memory_order_release);
+  m_background_reclaim_interval = published->background_reclaim_interval;
 }
 
 class DeviceCachingAllocator {
@@ -755,11 +1186,19 @@ class DeviceCachingAllocator {
   // allocated or in use by a stream
   ska::flat_hash_set<Block*> active_blocks;
 
-  // outstanding events
-  ska::flat_hash_map<
-      c10::Stream,
-      std::deque<std::pair<EventPool<c10::Event>::Event, Block*>>>
-      npu_events;
+  // Blocks freed while used by other streams, per stream, waiting for the
+  // next process_events to record one event for all of them, or for
+  // kMaxEventBatch of them to be freed.
+  ska::flat_hash_map<c10::Stream, std::vector<Block*>> pending_stream_frees;
+
+  // Event recorded on a stream, and the blocks freed before it was recorded.
+  struct EventBatch {
+    EventPool<AllocatorEvent>::Event event;
+    std::vector<Block*> blocks;
+  };
+
+  // outstanding events, in the order they were recorded on each stream
+  ska::flat_hash_map<c10::Stream, std::deque<EventBatch>> npu_events;
 
   // record used memory.
   size_t total_allocated_memory = 0;
@@ -786,6 +1225,33 @@ class DeviceCachingAllocator {
   // XXX - maybe we should generalize and have multiple events
   std::vector<OutOfMemoryObserver> oom_observers_;
 
+  // Private pools, by id.
+  ska::flat_hash_map<MempoolId_t, std::unique_ptr<PrivatePool>, MempoolIdHash>
+      graph_pools;
+  // Pools no longer referenced by any user, whose cached blocks are freed
+  // by release_cached_blocks.
+  ska::flat_hash_map<MempoolId_t, PrivatePool*, MempoolIdHash>
+      graph_pools_freeable;
+
+  // Allocations on streams accepted by the filter go to the private pool.
+  std::vector<std::pair<MempoolId_t, std::function<bool(void*)>>>
+      captures_underway;
+  // Size of captures_underway, readable without the mutex.
+  std::atomic<size_t> num_captures_underway{0};
+
+  // Background reclamation, see background_reclaim_ms. The thread is started
+  // by the first malloc after the option is set.
+  std::thread reclaim_thread;
+  std::mutex reclaim_mutex;
+  std::condition_variable reclaim_cv;
+  bool reclaim_stop = false;
+  bool reclaim_requested = false;
+  // background_reclaim_ms the reclaim thread currently waits with.
+  std::atomic<size_t> reclaim_interval{0};
+  // Blocks taken out of their pool until their stream is synchronized. Their
+  // event_count is raised so that nothing merges with them meanwhile.
+  std::vector<Block*> reclaim_pending;
+
  public:
   DeviceCachingAllocator()
       : large_blocks(false),
@@ -796,6 +1262,17 @@ class DeviceCachingAllocator {
     context_recorder_.store(nullptr);
   }
 
+  ~DeviceCachingAllocator() {
+    if (reclaim_thread.joinable()) {
+      {
+        std::lock_guard<std::mutex> lock(reclaim_mutex);
+        reclaim_stop = true;
+      }
+      reclaim_cv.notify_one();
+      reclaim_thread.join();
+    }
+  }
+
   void recordHistory(
       bool enabled,
       CreateContextFn context_recorder,
@@ -831,21 +1308,36 @@ class DeviceCachingAllocator {
   // All public methods (except the above) acquire the allocator mutex.
   // Thus, do not call a public method from another public method.
 
-  Block* malloc(c10::DeviceIndex device, size_t orig_size, void* stream) {
+  // thread_stats are the changes of the calling thread's cache, applied
+  // first so that the stats see the thread's operations in order.
+  Block* malloc(
+      c10::DeviceIndex device,
+      size_t orig_size,
+      void* stream,
+      const ThreadCacheStats* thread_stats = nullptr) {
     // done outside the lock because we don't know what locks the recorder needs
     // to have...
     auto context = maybeGatherContext(RecordContext::STATE);
 
     std::unique_lock<std::recursive_mutex> lock(mutex);
+    if (thread_stats != nullptr) {
+      thread_stats->apply(stats);
+    }
 
     if (device == -1) {
       device = getDeviceIndex();
     }
 
+    if (C10_UNLIKELY(
+            CachingAllocatorConfig::background_reclaim_interval() !=
+            reclaim_interval.load(std::memory_order_relaxed))) {
+      update_reclaim_thread(device);
+    }
+
     // process outstanding npu Events
     process_events(context);
     auto size = round_size(orig_size);
-    auto& pool = get_pool(size);
+    auto& pool = get_pool(size, stream);
 
     const size_t alloc_size = get_allocation_size(size);
     AllocParams params(device, size, stream, &pool, alloc_size, stats);
@@ -859,10 +1351,15 @@ class DeviceCachingAllocator {
         (trigger_free_memory_callbacks(params) && get_free_block(params));
     // Can't reuse an existing block; try to get a new one.
     if (!block_found) {
-      // Do garbage collection if the flag is set.
-      if (C10_UNLIKELY(
-              set_fraction &&
-              CachingAllocatorConfig::garbage_collection_threshold() > 0.0)) {
+      // Do garbage collection if the flag is set. The reclaim thread, if
+      // there is one, does it once the new block is accounted for.
+      const bool gc_enabled = C10_UNLIKELY(
+          set_fraction &&
+          CachingAllocatorConfig::garbage_collection_threshold() > 0.0);
+      const bool gc_in_background = gc_enabled &&
+          reclaim_thread.joinable() &&
+          CachingAllocatorConfig::background_reclaim_interval() > 0;
+      if (gc_enabled && !gc_in_background) {
         garbage_collect_cached_blocks(context);
       }
       // Attempt allocate
@@ -871,6 +1368,9 @@ class DeviceCachingAllocator {
           // alloc.
           (release_available_cached_blocks(params, context) &&
            alloc_block(params, false, context, lock));
+      if (gc_in_background) {
+        request_reclaim();
+      }
     }
 
     if (!block_found) {
@@ -1000,6 +1500,10 @@ class DeviceCachingAllocator {
       remaining->ptr = static_cast<char*>(remaining->ptr) + size;
       remaining->size -= size;
       pool->blocks.insert(remaining);
+      update_histogram_array(
+          stats.split_remainder_histogram,
+          static_cast<int64_t>(remaining->size),
+          params.stat_types);
 
       if (already_split && !block->expandable_segment_) {
         // An already-split inactive block is being shrunk by size bytes.
@@ -1029,6 +1533,10 @@ class DeviceCachingAllocator {
 
     block->allocated = true;
     block->requested_size = orig_size;
+    block->allocated_at = std::chrono::steady_clock::now();
+    if (auto private_pool = pool->owner_PrivatePool) {
+      private_pool->allocated_bytes += block->size;
+    }
 
     block->context_when_allocated = std::move(context);
     record_trace(
@@ -1053,6 +1561,9 @@ class DeviceCachingAllocator {
       update_stat(
           stats.requested_bytes[stat_type],
           static_cast<std::int64_t>(block->requested_size));
+      update_histogram(
+          stats.allocation_size_histogram[stat_type],
+          static_cast<std::int64_t>(orig_size));
     });
 
     if (block->size >= CachingAllocatorConfig::max_split_size())
@@ -1061,10 +1572,13 @@ class DeviceCachingAllocator {
     return block;
   }
 
-  void free(Block* block) {
+  void free(Block* block, const ThreadCacheStats* thread_stats = nullptr) {
     std::shared_ptr<c10::GatheredContext> context =
         maybeGatherContext(RecordContext::ALL);
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    if (thread_stats != nullptr) {
+      thread_stats->apply(stats);
+    }
 
     block->allocated = false;
 
@@ -1074,10 +1588,15 @@ class DeviceCachingAllocator {
     auto orig_block_size = block->size;
 
     StatTypes stat_types = get_stat_types_for_pool(*(block->pool));
+    int64_t lifetime = elapsed_us(block->allocated_at);
     for_each_selected_stat_type(stat_types, [&](size_t stat_type) {
       update_stat(stats.allocation[stat_type], -1);
       update_stat(stats.allocated_bytes[stat_type], -block->size);
+      update_histogram(stats.block_lifetime_histogram[stat_type], lifetime);
     });
+    if (auto private_pool = block->pool->owner_PrivatePool) {
+      private_pool->allocated_bytes -= block->size;
+    }
 
     record_trace(
         TraceEntry::FREE_REQUESTED,
@@ -1097,6 +1616,19 @@ class DeviceCachingAllocator {
     }
   }
 
+  // Applies the stats of thread caches and returns the blocks they held,
+  // accounted for as freed by those stats, to their pools.
+  void release_thread_cached(
+      const std::vector<Block*>& blocks,
+      const ThreadCacheStats& thread_stats) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    thread_stats.apply(stats);
+    for (Block* block : blocks) {
+      block->allocated = false;
+      free_block(block, nullptr, /*was_active=*/false);
+    }
+  }
+
   void* getBaseAllocation(Block* block, size_t* outSize) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
     while (block->prev) {
@@ -1126,17 +1658,32 @@ class DeviceCachingAllocator {
     block->stream_uses.erase(stream);
 
     // free block, lazy destory block related events
-    for (auto it = npu_events[stream].begin();
-         it != npu_events[stream].end();) {
-      if (block != it->second) {
-        it++;
-        continue;
+    auto forget = [block](std::vector<Block*>& blocks) {
+      auto it = std::find(blocks.begin(), blocks.end(), block);
+      if (it == blocks.end()) {
+        return false;
+      }
+      blocks.erase(it);
+      return true;
+    };
+    bool found = false;
+    auto pending = pending_stream_frees.find(stream);
+    if (pending != pending_stream_frees.end()) {
+      found = forget(pending->second);
+    }
+    auto events = npu_events.find(stream);
+    if (!found && events != npu_events.end()) {
+      for (auto& batch : events->second) {
+        if (forget(batch.blocks)) {
+          found = true;
+          break;
+        }
       }
-      it = npu_events[stream].erase(it);
+    }
+    if (found) {
       block->event_count--;
       if (block->event_count == 0) {
         free_block(block, context);
-        break;
       }
     }
   }
@@ -1158,6 +1705,73 @@ class DeviceCachingAllocator {
     release_cached_blocks(check_error, context);
   }
 
+  /** routes allocations on streams accepted by filter to a private pool **/
+  void beginAllocateToPool(
+      MempoolId_t mempool_id,
+      std::function<bool(void*)> filter) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    auto it = graph_pools.find(mempool_id);
+    if (it == graph_pools.end()) {
+      // mempool_id does not reference an existing pool. Make a new pool for
+      // this capture.
+      graph_pools.emplace(mempool_id, std::make_unique<PrivatePool>());
+    } else {
+      // mempool_id references an existing pool, which the current capture
+      // will share. Check this pool is live (at least one other capture
+      // already references it).
+      TORCH_INTERNAL_ASSERT(it->second->use_count > 0);
+      it->second->use_count++;
+    }
+    for (auto it2 = captures_underway.begin(); it2 != captures_underway.end();
+         ++it2) {
+      TORCH_CHECK(
+          it2->first != mempool_id,
+          "beginAllocateToPool: already recording to mempool_id");
+    }
+    captures_underway.emplace_back(mempool_id, std::move(filter));
+    num_captures_underway.store(
+        captures_underway.size(), std::memory_order_relaxed);
+  }
+
+  /** stops routing allocations to a private pool **/
+  void endAllocateToPool(MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    for (auto it = captures_underway.begin(); it != captures_underway.end();
+         ++it) {
+      if (it->first == mempool_id) {
+        captures_underway.erase(it);
+        num_captures_underway.store(
+            captures_underway.size(), std::memory_order_relaxed);
+        return;
+      }
+    }
+    TORCH_CHECK(
+        false, "endAllocatePool: not currently recording to mempool_id");
+  }
+
+  /** drops a use of a private pool, its memory is freed once unused **/
+  void releasePool(MempoolId_t mempool_id) {
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    // The instantiated graph or the tenant that used the pool is gone, so
+    // its memory may be released once every block of it is freed.
+    auto it = graph_pools.find(mempool_id);
+    TORCH_INTERNAL_ASSERT(it != graph_pools.end());
+    auto uc = --(it->second->use_count);
+    TORCH_INTERNAL_ASSERT(uc >= 0);
+    if (uc == 0) {
+      // Allows release_cached_blocks to begin npuFreeing this pool's memory,
+      // and makes sure this pool wasn't somehow made freeable already.
+      bool inserted =
+          graph_pools_freeable.insert({mempool_id, it->second.get()}).second;
+      TORCH_INTERNAL_ASSERT(inserted);
+    }
+  }
+
+  /** whether some stream of the device is routed to a private pool **/
+  bool allocatingToPool() const {
+    return num_captures_underway.load(std::memory_order_relaxed) > 0;
+  }
+
   /** Retrieves info (total size + largest block) of the memory cache **/
   void cacheInfo(size_t* total, size_t* largest) {
     std::lock_guard<std::recursive_mutex> lock(mutex);
@@ -1168,7 +1782,76 @@ class DeviceCachingAllocator {
   /** Returns a copy of the memory allocator stats **/
   DeviceStats getStats() {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    return stats;
+    DeviceStats result = stats;
+    result.small_size =
+        static_cast<int64_t>(CachingAllocatorConfig::small_size());
+    result.large_buffer =
+        static_cast<int64_t>(CachingAllocatorConfig::large_buffer());
+    result.round_large =
+        static_cast<int64_t>(CachingAllocatorConfig::round_large());
+    for (auto divisions : CachingAllocatorConfig::roundup_power2_divisions()) {
+      result.roundup_power2_divisions.push_back(
+          static_cast<int64_t>(divisions));
+    }
+    result.private_pools.reserve(graph_pools.size());
+    for (const auto& pair : graph_pools) {
+      const PrivatePool& private_pool = *pair.second;
+      result.private_pools.emplace_back();
+      PoolStats& pool_stats = result.private_pools.back();
+      pool_stats.id = pair.first;
+      pool_stats.use_count = private_pool.use_count;
+      pool_stats.segment = private_pool.npuMalloc_count;
+      pool_stats.reserved_bytes =
+          static_cast<int64_t>(private_pool.reserved_bytes);
+      pool_stats.allocated_bytes =
+          static_cast<int64_t>(private_pool.allocated_bytes);
+    }
+    free_block_stats(result);
+    return result;
+  }
+
+  // Fills in the free block histograms and the fragmentation of each pool
+  // type from the cached blocks.
+  void free_block_stats(DeviceStats& result) {
+    constexpr size_t kNumTypes = static_cast<size_t>(StatType::NUM_TYPES);
+    std::array<int64_t, kNumTypes> free_bytes{};
+    std::array<int64_t, kNumTypes> largest{};
+    ska::flat_hash_map<void*, size_t> stream_index;
+    auto add_pool = [&](const BlockPool& pool) {
+      StatTypes stat_types = get_stat_types_for_pool(pool);
+      for (const Block* block : pool.blocks) {
+        if (!block->mapped) {
+          continue;
+        }
+        auto it = stream_index
+                      .emplace(
+                          block->stream, result.free_block_histograms.size())
+                      .first;
+        if (it->second == result.free_block_histograms.size()) {
+          result.free_block_histograms.emplace_back();
+          result.free_block_histograms.back().stream = block->stream;
+        }
+        auto size = static_cast<int64_t>(block->size);
+        update_histogram(result.free_block_histograms[it->second].sizes, size);
+        for_each_selected_stat_type(stat_types, [&](size_t stat_type) {
+          free_bytes[stat_type] += size;
+          largest[stat_type] = std::max(largest[stat_type], size);
+        });
+      }
+    };
+    add_pool(large_blocks);
+    add_pool(small_blocks);
+    for (const auto& pair : graph_pools) {
+      add_pool(pair.second->large_blocks);
+      add_pool(pair.second->small_blocks);
+    }
+    for (size_t stat_type = 0; stat_type < kNumTypes; ++stat_type) {
+      result.fragmentation[stat_type] = free_bytes[stat_type] > 0
+          ? 1.0 -
+              static_cast<double>(largest[stat_type]) /
+                  static_cast<double>(free_bytes[stat_type])
+          : 0.0;
+    }
   }
 
   /** Resets the historical accumulation stats for the device **/
@@ -1191,8 +1874,15 @@ class DeviceCachingAllocator {
 
     stats.num_alloc_retries = 0;
     stats.num_ooms = 0;
+    stats.num_background_reclaims = 0;
+    stats.background_reclaimed_bytes = 0;
+    stats.num_event_queries = 0;
     reset_accumulated_stat(stats.oversize_allocations);
     reset_accumulated_stat(stats.oversize_segments);
+    reset_accumulated_stat(stats.outstanding_events);
+    stats.allocation_size_histogram = {};
+    stats.block_lifetime_histogram = {};
+    stats.split_remainder_histogram = {};
   }
 
   /** Resets the historical peak stats for the device **/
@@ -1215,6 +1905,7 @@ class DeviceCachingAllocator {
 
     reset_peak_stat(stats.oversize_allocations);
     reset_peak_stat(stats.oversize_segments);
+    reset_peak_stat(stats.outstanding_events);
   }
 
   /** Dump a complete snapshot of the memory held by the allocator. Potentially
@@ -1226,6 +1917,12 @@ class DeviceCachingAllocator {
     std::vector<SegmentInfo> result;
     const auto all_blocks = get_all_blocks();
 
+    ska::flat_hash_map<const PrivatePool*, MempoolId_t> pool_to_id;
+    pool_to_id.reserve(graph_pools.size());
+    for (const auto& pair : graph_pools) {
+      pool_to_id[pair.second.get()] = pair.first;
+    }
+
     for (const Block* const head_block : all_blocks) {
       // For expandable segments, we report one segment for each continguous
       // mapped range of memory
@@ -1239,6 +1936,10 @@ class DeviceCachingAllocator {
       segment_info.stream = head_block->stream;
       segment_info.is_large = (!head_block->pool->is_small);
       segment_info.is_expandable = head_block->expandable_segment_;
+      if (head_block->pool->owner_PrivatePool) {
+        segment_info.owner_private_pool_id =
+            pool_to_id[head_block->pool->owner_PrivatePool];
+      }
       segment_info.context_when_allocated =
           head_block->context_when_segment_allocated;
 
@@ -1293,10 +1994,34 @@ class DeviceCachingAllocator {
     return result;
   }
 
+  static size_t roundup_power2_next_division(size_t size, size_t divisions) {
+    if (c10::llvm::isPowerOf2_64(size)) {
+      return size;
+    }
+    TORCH_CHECK(divisions >= 2, "Only 2 or more divisions are supported");
+    // divide the space between these 2's power into equal divisions
+    // If division is zero, return the power-of-2 ceiling.
+    size_t power2_floor = c10::llvm::PowerOf2Floor(size);
+    size_t power2_division =
+        power2_floor >> (63 - c10::llvm::countLeadingZeros(divisions));
+    if (C10_UNLIKELY(power2_division == 0)) {
+      return (power2_floor << 1);
+    }
+    size_t round_size_floor = size & (~(power2_division - 1));
+    return (round_size_floor == size) ? size
+                                      : round_size_floor + power2_division;
+  }
+
   static size_t round_size(size_t size) {
     size = size + 32;
     if (size < kMinBlockSize) {
       return kMinBlockSize;
+    }
+    // Rounding nearby sizes up to the same division lets blocks of variable
+    // shape workloads be reused for each other.
+    auto divisions = CachingAllocatorConfig::roundup_power2_divisions(size);
+    if (divisions > 1 && size > (kMinBlockSize * divisions)) {
+      return roundup_power2_next_division(size, divisions);
     } else {
       return kMinBlockSize * ((size + kMinBlockSize - 1) / kMinBlockSize);
     }
@@ -1315,7 +2040,19 @@ class DeviceCachingAllocator {
         blocks.end(), small_blocks.blocks.begin(), small_blocks.blocks.end());
     blocks.insert(
         blocks.end(), large_blocks.blocks.begin(), large_blocks.blocks.end());
+    for (const auto& gp : graph_pools) {
+      blocks.insert(
+          blocks.end(),
+          gp.second->small_blocks.blocks.begin(),
+          gp.second->small_blocks.blocks.end());
+      blocks.insert(
+          blocks.end(),
+          gp.second->large_blocks.blocks.begin(),
+          gp.second->large_blocks.blocks.end());
+    }
     blocks.insert(blocks.end(), active_blocks.begin(), active_blocks.end());
+    blocks.insert(
+        blocks.end(), reclaim_pending.begin(), reclaim_pending.end());
     return blocks;
   }
 
@@ -1465,7 +2202,8 @@ class DeviceCachingAllocator {
   /** moves a block into a pool of cached free blocks **/
   void free_block(
       Block* block,
-      const std::shared_ptr<c10::GatheredContext>& context) {
+      const std::shared_ptr<c10::GatheredContext>& context,
+      bool was_active = true) {
     AT_ASSERT(!block->allocated && block->event_count == 0);
 
     record_trace(
@@ -1517,11 +2255,13 @@ class DeviceCachingAllocator {
             stats.inactive_split_bytes[stat_type],
             net_change_inactive_split_size);
       }
-      update_stat(stats.active[stat_type], -1);
-      update_stat(stats.active_bytes[stat_type], -original_block_size);
-      update_stat(
-          stats.requested_bytes[stat_type],
-          -static_cast<std::int64_t>(requested_size));
+      if (was_active) {
+        update_stat(stats.active[stat_type], -1);
+        update_stat(stats.active_bytes[stat_type], -original_block_size);
+        update_stat(
+            stats.requested_bytes[stat_type],
+            -static_cast<std::int64_t>(requested_size));
+      }
     });
   }
 
@@ -1558,22 +2298,29 @@ class DeviceCachingAllocator {
     return subsumed_size;
   }
 
-  BlockPool& get_pool(size_t size) {
-    if (size <= kSmallSize) {
+  BlockPool& get_pool(size_t size, void* stream) {
+    // captures_underway is a conservative guess that the current stream may
+    // be routed to a private pool.
+    if (C10_UNLIKELY(!captures_underway.empty())) {
+      for (auto& entry : captures_underway) {
+        if (entry.second(stream)) {
+          auto it1 = graph_pools.find(entry.first);
+          TORCH_INTERNAL_ASSERT(it1 != graph_pools.end());
+          if (size <= CachingAllocatorConfig::small_size()) {
+            return it1->second->small_blocks;
+          } else {
+            return it1->second->large_blocks;
+          }
+        }
+      }
+    }
+    if (size <= CachingAllocatorConfig::small_size()) {
       return small_blocks;
     } else {
       return large_blocks;
     }
   }
 
-  StatTypes get_stat_types_for_pool(const BlockPool& pool) {
-    StatTypes stat_types = {false};
-    stat_types[static_cast<size_t>(StatType::AGGREGATE)] = true;
-    stat_types[static_cast<size_t>(
-        pool.is_small ? StatType::SMALL_POOL : StatType::LARGE_POOL)] = true;
-    return stat_types;
-  }
-
   bool should_split(const Block* block, size_t size) {
     size_t remaining = block->size - size;
     if (block->pool->is_small ||
@@ -1581,17 +2328,18 @@ class DeviceCachingAllocator {
       return remaining >= kMinBlockSize;
     } else {
       return (size < CachingAllocatorConfig::max_split_size()) &&
-          (remaining > kSmallSize);
+          (remaining > CachingAllocatorConfig::small_size());
     }
   }
 
   static size_t get_allocation_size(size_t size) {
-    if (size <= kSmallSize) {
+    if (size <= CachingAllocatorConfig::small_size()) {
       return kSmallBuffer;
-    } else if (size < kMinLargeAlloc) {
-      return kLargeBuffer;
+    } else if (size < CachingAllocatorConfig::min_large_alloc()) {
+      return CachingAllocatorConfig::large_buffer();
     } else {
-      return kRoundLarge * ((size + kRoundLarge - 1) / kRoundLarge);
+      size_t round_large = CachingAllocatorConfig::round_large();
+      return round_large * ((size + round_large - 1) / round_large);
     }
   }
 
@@ -1600,8 +2348,10 @@ class DeviceCachingAllocator {
 
     if (C10_UNLIKELY(
             set_fraction &&
-            CachingAllocatorConfig::garbage_collection_threshold() > 0.0)) {
+            CachingAllocatorConfig::garbage_collection_threshold() > 0.0 &&
+            CachingAllocatorConfig::background_reclaim_interval() == 0)) {
       // Track block reuse interval only when garbage collection is enabled.
+      // The reclaim thread ages blocks by its own passes instead.
       for (auto& b : pool.blocks) {
         ++b->gc_count;
       }
@@ -1651,7 +2401,7 @@ class DeviceCachingAllocator {
     }
     // Allow oversized block size to be rounded up but within a limit
     if ((p.size() >= CachingAllocatorConfig::max_split_size()) &&
-        ((*it)->size >= p.size() + kLargeBuffer)) {
+        ((*it)->size >= p.size() + CachingAllocatorConfig::large_buffer())) {
       return false;
     }
     p.block = *it;
@@ -1727,6 +2477,161 @@ class DeviceCachingAllocator {
     }
   }
 
+  // Starts the reclaim thread, or wakes it up to pick up a new interval.
+  void update_reclaim_thread(c10::DeviceIndex device) {
+    if (reclaim_thread.joinable()) {
+      // Taking the mutex makes sure the thread either sees the new interval
+      // or is waiting for the notification.
+      { std::lock_guard<std::mutex> lock(reclaim_mutex); }
+      reclaim_cv.notify_one();
+      return;
+    }
+    reclaim_interval = CachingAllocatorConfig::background_reclaim_interval();
+    reclaim_thread =
+        std::thread(&DeviceCachingAllocator::reclaim_loop, this, device);
+  }
+
+  void request_reclaim() {
+    {
+      std::lock_guard<std::mutex> lock(reclaim_mutex);
+      reclaim_requested = true;
+    }
+    reclaim_cv.notify_one();
+  }
+
+  void reclaim_loop(c10::DeviceIndex device) {
+    c10::setThreadName("Reclaim_thread");
+    helper->setDevice(device);
+    std::unique_lock<std::mutex> lock(reclaim_mutex);
+    while (!reclaim_stop) {
+      auto interval = CachingAllocatorConfig::background_reclaim_interval();
+      reclaim_interval = interval;
+      auto wake = [this, interval]() {
+        return reclaim_stop || reclaim_requested ||
+            interval != CachingAllocatorConfig::background_reclaim_interval();
+      };
+      // Passes that time out are periodic, the others are requested by
+      // malloc over the garbage collection threshold.
+      bool requested = true;
+      if (interval == 0) {
+        reclaim_cv.wait(lock, wake);
+      } else {
+        requested = reclaim_cv.wait_for(
+            lock, std::chrono::milliseconds(interval), wake);
+      }
+      if (reclaim_stop) {
+        break;
+      }
+      if (!reclaim_requested &&
+          interval != CachingAllocatorConfig::background_reclaim_interval()) {
+        continue;
+      }
+      reclaim_requested = false;
+      lock.unlock();
+      reclaim_cached_blocks(device, /*age_blocks=*/!requested);
+      lock.lock();
+    }
+  }
+
+  // Whether the reclaim thread may take block out of its pool: whole
+  // unsplit segments, or free pages of expandable segments.
+  static bool reclaimable(const Block* block) {
+    return block->expandable_segment_ ? block->mapped : !block->is_split();
+  }
+
+  // Runs on the reclaim thread. Each periodic pass ages the cached blocks of
+  // the global pools, and segments unused for kReclaimColdPasses passes are
+  // released. Over the garbage collection threshold, the oldest ones are
+  // released as well until below it. Streams are synchronized without the
+  // allocator mutex, so malloc and free only wait for the pool updates.
+  void reclaim_cached_blocks(c10::DeviceIndex device, bool age_blocks) {
+    constexpr int kReclaimColdPasses = 20;
+    std::vector<Block*> candidates;
+    std::vector<void*> streams;
+    {
+      std::lock_guard<std::recursive_mutex> lock(mutex);
+      process_events(nullptr);
+
+      std::vector<Block*> reclaimable_blocks;
+      for (BlockPool* pool : {&large_blocks, &small_blocks}) {
+        for (Block* block : pool->blocks) {
+          if (age_blocks) {
+            ++block->gc_count;
+          }
+          if (reclaimable(block)) {
+            reclaimable_blocks.push_back(block);
+          }
+        }
+      }
+      // Oldest first
+      std::stable_sort(
+          reclaimable_blocks.begin(),
+          reclaimable_blocks.end(),
+          [](const Block* a, const Block* b) {
+            return a->gc_count > b->gc_count;
+          });
+
+      size_t target_size = 0;
+      if (set_fraction &&
+          CachingAllocatorConfig::garbage_collection_threshold() > 0.0) {
+        size_t gc_threshold = static_cast<size_t>(
+            CachingAllocatorConfig::garbage_collection_threshold() *
+            allowed_memory_maximum);
+        if (total_allocated_memory > gc_threshold) {
+          target_size = total_allocated_memory - gc_threshold;
+        }
+      }
+      size_t selected_size = 0;
+      for (Block* block : reclaimable_blocks) {
+        if (block->gc_count < kReclaimColdPasses &&
+            selected_size >= target_size) {
+          break;
+        }
+        selected_size += block->size;
+        candidates.push_back(block);
+      }
+
+      for (Block* block : candidates) {
+        block->pool->blocks.erase(block);
+        block->event_count++;
+        reclaim_pending.push_back(block);
+        if (std::find(streams.begin(), streams.end(), block->stream) ==
+            streams.end()) {
+          streams.push_back(block->stream);
+        }
+      }
+    }
+    if (candidates.empty()) {
+      return;
+    }
+
+    // Work queued before the blocks were freed may still use them.
+    for (void* stream : streams) {
+      helper->synchronizeStream(device, stream);
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(mutex);
+    const size_t allocated_before = total_allocated_memory;
+    for (Block* block : candidates) {
+      block->event_count--;
+      reclaim_pending.erase(
+          std::find(reclaim_pending.begin(), reclaim_pending.end(), block));
+      block->gc_count = 0;
+      block->pool->blocks.insert(block);
+      if (block->expandable_segment_) {
+        unmap_block(block, nullptr);
+        if (!block->prev && !block->next) {
+          release_expandable_segment(block);
+        }
+      } else {
+        release_block(block, nullptr);
+      }
+    }
+    stats.num_background_reclaims += static_cast<int64_t>(candidates.size());
+    stats.background_reclaimed_bytes +=
+        static_cast<int64_t>(allocated_before - total_allocated_memory);
+  }
+
   bool alloc_block(
       AllocParams& p,
       bool isRetry,
@@ -1742,7 +2647,11 @@ class DeviceCachingAllocator {
     if (set_fraction &&
         total_allocated_memory + size > allowed_memory_maximum) {
       p.err = MEM_ALLOCATION_ERROR;
-    } else if (CachingAllocatorConfig::expandable_segments()) {
+    } else if (
+        CachingAllocatorConfig::expandable_segments() &&
+        // Private pools keep plain segments, so that releasing a pool
+        // frees whole segments.
+        !p.pool->owner_PrivatePool) {
       p.block = try_allocate_expandable_block(
           p.device(), p.stream(), p.pool, p.size(), ctx);
       if (p.block) {
@@ -1760,6 +2669,12 @@ class DeviceCachingAllocator {
       return false;
     }
 
+    if (p.pool->owner_PrivatePool) {
+      // The block is for a private pool, bump its segment count and size.
+      p.pool->owner_PrivatePool->npuMalloc_count++;
+      p.pool->owner_PrivatePool->reserved_bytes += size;
+    }
+
     total_allocated_memory += size;
     p.block = new Block(p.device(), p.stream(), size, p.pool, (char*)ptr);
     for_each_selected_stat_type(p.stat_types, [&](size_t stat_type) {
@@ -1845,6 +2760,22 @@ class DeviceCachingAllocator {
     release_blocks(large_blocks, context);
     release_blocks(small_blocks, context);
 
+    for (auto it = graph_pools_freeable.begin();
+         it != graph_pools_freeable.end();) {
+      // Pools become freeable in releasePool. Their cached segments are
+      // freed here, and the pool itself once all of its segments are gone.
+      TORCH_INTERNAL_ASSERT(it->second->use_count == 0);
+      release_blocks(it->second->small_blocks, context);
+      release_blocks(it->second->large_blocks, context);
+      if (it->second->npuMalloc_count == 0) {
+        auto erase_count = graph_pools.erase(it->first);
+        TORCH_INTERNAL_ASSERT(erase_count == 1);
+        it = graph_pools_freeable.erase(it);
+      } else {
+        ++it;
+      }
+    }
+
     return true;
   }
 
@@ -1885,6 +2816,12 @@ class DeviceCachingAllocator {
     total_allocated_memory -= block->size;
 
     auto* pool = block->pool;
+    if (pool->owner_PrivatePool) {
+      // The npuFreed block belonged to a private pool.
+      TORCH_INTERNAL_ASSERT(pool->owner_PrivatePool->npuMalloc_count > 0);
+      pool->owner_PrivatePool->npuMalloc_count--;
+      pool->owner_PrivatePool->reserved_bytes -= block->size;
+    }
 
     StatTypes stat_types = get_stat_types_for_pool(*pool);
     for_each_selected_stat_type(stat_types, [&](size_t stat_type) {
@@ -1985,28 +2922,25 @@ class DeviceCachingAllocator {
     }
   }
 
-  EventPool<c10::Event>::Event create_event_internal(int idx) {
+  EventPool<AllocatorEvent>::Event create_event_internal(int idx) {
     // Leak the event pool to avoid shutdown issues.
-    static auto* event_pool = new EventPool<c10::Event>(deviceCount(), []() {
-      return std::make_unique<c10::Event>(at::kPrivateUse1);
-    });
+    static auto* event_pool = new EventPool<AllocatorEvent>(
+        deviceCount(), []() { return helper->createEvent(); });
     return event_pool->get(idx);
   }
 
   void synchronize_and_free_events(
       bool check_error,
       const std::shared_ptr<c10::GatheredContext>& context) {
+    record_pending_events();
     // Synchronize on outstanding events and then free associated blocks.
     for (auto& st : npu_events) {
-      for (auto& e : st.second) {
-        EventPool<c10::Event>::Event event = std::move(e.first);
-        Block* block = e.second;
-        event->synchronize();
-
-        block->event_count--;
-        if (block->event_count == 0) {
-          free_block(block, context);
-        }
+      if (!st.second.empty()) {
+        // Events of a stream complete in order.
+        st.second.back().event->synchronize();
+      }
+      for (auto& batch : st.second) {
+        retire_event_batch(batch, context);
       }
     }
 
@@ -2014,47 +2948,99 @@ class DeviceCachingAllocator {
   }
 
   void insert_events(Block* block) {
-    helper->insertEventWrapper(block->device, [&]() {
-      stream_set streams(std::move(block->stream_uses));
-      AT_ASSERT(block->stream_uses.empty());
-      for (auto& stream : streams) {
-        setDevice(stream.device_index());
-
-        EventPool<c10::Event>::Event event =
-            create_event_internal(stream.device_index());
-        event->record(stream);
+    stream_set streams(std::move(block->stream_uses));
+    AT_ASSERT(block->stream_uses.empty());
+    for (auto& stream : streams) {
+      block->event_count++;
+      auto& pending = pending_stream_frees[stream];
+      pending.push_back(block);
+      // Bounds how much later than the frees the event is recorded.
+      if (pending.size() >= kMaxEventBatch) {
+        record_event(stream, pending);
+      }
+    }
+  }
 
-        block->event_count++;
-        npu_events[stream].emplace_back(std::move(event), block);
+  // Records one event on each stream for all the blocks freed since the
+  // last call. Recording later than the frees is safe, the event then also
+  // waits for work queued after them.
+  void record_pending_events() {
+    for (auto& pending : pending_stream_frees) {
+      if (!pending.second.empty()) {
+        record_event(pending.first, pending.second);
       }
+    }
+  }
+
+  // Records an event on stream for blocks, which is left empty.
+  void record_event(const c10::Stream& stream, std::vector<Block*>& blocks) {
+    helper->insertEventWrapper(stream.device_index(), [&]() {
+      setDevice(stream.device_index());
+
+      EventPool<AllocatorEvent>::Event event =
+          create_event_internal(stream.device_index());
+      event->record(stream);
+
+      npu_events[stream].push_back(
+          EventBatch{std::move(event), std::move(blocks)});
     });
+    blocks.clear();
+    update_stat(stats.outstanding_events, 1);
+  }
+
+  void retire_event_batch(
+      EventBatch& batch,
+      const std::shared_ptr<c10::GatheredContext>& context) {
+    for (Block* block : batch.blocks) {
+      block->event_count--;
+      if (block->event_count == 0) {
+        free_block(block, context);
+      }
+    }
+    update_stat(stats.outstanding_events, -1);
+  }
+
+  bool query_event(const EventBatch& batch) {
+    stats.num_event_queries++;
+    return batch.event->query();
   }
 
   void process_events(const std::shared_ptr<c10::GatheredContext>& context) {
     // Process outstanding npu Events. Events that are completed are removed
-    // from the queue, and the 'event_count' for the corresponding allocation
-    // is decremented. Stops at the first event which has not been completed.
-    // Since events on different devices or streams may occur out of order,
-    // the processing of some events may be delayed.
+    // from the queue, and the 'event_count' for the corresponding allocations
+    // is decremented. Events of a stream complete in the order they were
+    // recorded, so the newest one is queried first, and otherwise the last
+    // completed one is found by bisection. Since events on different devices
+    // or streams may occur out of order, the processing of some events may
+    // be delayed.
+    record_pending_events();
     for (auto it = npu_events.begin(); it != npu_events.end();) {
-      while (!it->second.empty()) {
-        auto& e = it->second.front();
-        EventPool<c10::Event>::Event event = std::move(e.first);
-        Block* block = e.second;
-
-        if (!event->query()) {
-          e.first = std::move(event);
-          break;
+      auto& batches = it->second;
+      // Number of completed events at the front of batches.
+      size_t completed = 0;
+      if (!batches.empty() && query_event(batches.back())) {
+        completed = batches.size();
+      } else if (batches.size() > 1) {
+        // batches[lo - 1] completed or lo == 0, batches[hi] has not.
+        size_t lo = 0;
+        size_t hi = batches.size() - 1;
+        while (lo < hi) {
+          size_t mid = lo + (hi - lo) / 2;
+          if (query_event(batches[mid])) {
+            lo = mid + 1;
+          } else {
+            hi = mid;
+          }
         }
+        completed = lo;
+      }
 
-        block->event_count--;
-        if (block->event_count == 0) {
-          free_block(block, context);
-        }
-        it->second.pop_front();
+      for (size_t i = 0; i < completed; i++) {
+        retire_event_batch(batches.front(), context);
+        batches.pop_front();
       }
 
-      if (it->second.empty()) {
+      if (batches.empty()) {
         it = npu_events.erase(it);
       } else {
         it++;
@@ -2121,30 +3107,313 @@ static void uncached_delete(void* ptr) {
 
 void local_raw_delete(void* ptr);
 
+// Number of shards of the allocated blocks map. A prime, so that pointers
+// with a common alignment still spread over all shards.
+static constexpr size_t kNumMutexShard = 67;
+
+// Keeps the mutex of each shard on its own cache line.
+struct alignas(64) AlignedMutex {
+  std::mutex m;
+};
+
+// Hit counters of the thread caches for a device.
+struct ThreadCacheUsage {
+  int64_t hits = 0;
+  int64_t misses = 0;
+};
+
+// Blocks and stats taken out of a thread cache, all of one device.
+struct ThreadCacheRelease {
+  c10::DeviceIndex device = -1;
+  std::vector<Block*> blocks;
+  ThreadCacheStats stats;
+};
+
+// Small blocks freed by a thread, kept for its next allocations of the same
+// rounded size on the same device and stream, so that those skip the device
+// allocator and its lock. Up to thread_cache_size_kb bytes are held. A
+// request for another device or stream flushes the cache first.
+//
+// Cached blocks stay allocated in their pools, so that they are not merged.
+// The stats of the frees and reuses served by the cache are kept with it,
+// see ThreadCacheStats, and move with its blocks. The mutex is only
+// contended while another thread drains the cache or reads its stats.
+class ThreadBlockCache {
+ public:
+  static constexpr size_t kMaxBlockSize = 65536;
+  static constexpr size_t kDepth = 8;
+
+  // Returns a cached block of size handed out for orig_size bytes. On a
+  // miss, moves the stats of the cache to stats instead. The blocks and
+  // stats of a previous device or stream are moved to evicted.
+  Block* pop(
+      c10::DeviceIndex device,
+      void* stream,
+      size_t size,
+      size_t orig_size,
+      ThreadCacheStats& stats,
+      ThreadCacheRelease& evicted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    switch_to(device, stream, evicted);
+    Bin& bin = bins_[size / kMinBlockSize - 1];
+    if (bin.count == 0) {
+      counters_[device].misses++;
+      move_stats(stats);
+      return nullptr;
+    }
+    counters_[device].hits++;
+    Block* block = bin.blocks[--bin.count];
+    blocks_--;
+    bytes_ -= block->size;
+    block->requested_size = orig_size;
+    block->allocated_at = std::chrono::steady_clock::now();
+    stats_.record_reuse(block, orig_size);
+    return block;
+  }
+
+  // Keeps block unless its bin is full or the cache would exceed capacity,
+  // in which case the stats of the cache are moved to stats.
+  bool push(
+      Block* block,
+      size_t capacity,
+      ThreadCacheStats& stats,
+      ThreadCacheRelease& evicted) {
+    int64_t lifetime = elapsed_us(block->allocated_at);
+    std::lock_guard<std::mutex> lock(mutex_);
+    switch_to(block->device, block->stream, evicted);
+    Bin& bin = bins_[block->size / kMinBlockSize - 1];
+    if (bin.count == kDepth || bytes_ + block->size > capacity) {
+      move_stats(stats);
+      return false;
+    }
+    bin.blocks[bin.count++] = block;
+    blocks_++;
+    bytes_ += block->size;
+    stats_.record_keep(block, lifetime);
+    return true;
+  }
+
+  // Moves the blocks and stats of device, or of any device for -1, to out.
+  void drain(c10::DeviceIndex device, std::vector<ThreadCacheRelease>& out) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (device_ != -1 && (device == -1 || device == device_)) {
+      out.emplace_back();
+      take_all(out.back());
+    }
+  }
+
+  // Appends the stats kept for device to stats.
+  void take_stats(c10::DeviceIndex device, ThreadCacheStats& stats) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (device == device_ && !stats_.empty) {
+      stats.append(stats_);
+      stats_ = ThreadCacheStats();
+    }
+  }
+
+  void collect(c10::DeviceIndex device, ThreadCacheUsage& usage) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = counters_.find(device);
+    if (it != counters_.end()) {
+      usage.hits += it->second.hits;
+      usage.misses += it->second.misses;
+    }
+  }
+
+  void reset_counters(c10::DeviceIndex device) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    counters_.erase(device);
+  }
+
+ private:
+  struct Bin {
+    std::array<Block*, kDepth> blocks;
+    size_t count = 0;
+  };
+
+  struct Counters {
+    int64_t hits = 0;
+    int64_t misses = 0;
+  };
+
+  void switch_to(
+      c10::DeviceIndex device,
+      void* stream,
+      ThreadCacheRelease& evicted) {
+    if (device != device_ || stream != stream_) {
+      take_all(evicted);
+      device_ = device;
+      stream_ = stream;
+    }
+  }
+
+  void move_stats(ThreadCacheStats& out) {
+    if (!stats_.empty) {
+      out = stats_;
+      stats_ = ThreadCacheStats();
+    }
+  }
+
+  void take_all(ThreadCacheRelease& out) {
+    out.device = device_;
+    move_stats(out.stats);
+    if (blocks_ == 0) {
+      return;
+    }
+    for (auto& bin : bins_) {
+      out.blocks.insert(
+          out.blocks.end(), bin.blocks.begin(), bin.blocks.begin() + bin.count);
+      bin.count = 0;
+    }
+    blocks_ = 0;
+    bytes_ = 0;
+  }
+
+  std::mutex mutex_;
+  c10::DeviceIndex device_ = -1;
+  void* stream_ = nullptr;
+  int64_t blocks_ = 0;
+  int64_t bytes_ = 0;
+  std::array<Bin, kMaxBlockSize / kMinBlockSize> bins_;
+  ThreadCacheStats stats_;
+  ska::flat_hash_map<c10::DeviceIndex, Counters> counters_;
+};
+
+// Owns the cache of a thread and returns its blocks when the thread exits.
+struct ThreadBlockCacheHolder {
+  ThreadBlockCache* cache = nullptr;
+  ~ThreadBlockCacheHolder();
+};
+
+thread_local ThreadBlockCacheHolder thread_block_cache;
+
 class DefaultCachingAllocator : public CachingAllocator {
  private:
-  std::mutex mutex;
+  // Allocated blocks by device pointer, sharded by pointer hash so that
+  // threads allocating and freeing on different devices or streams rarely
+  // contend for the same mutex.
+  std::array<AlignedMutex, kNumMutexShard> mutex;
+  std::array<ska::flat_hash_map<void*, Block*>, kNumMutexShard>
+      allocated_blocks;
 
-  // allocated blocks by device pointer
-  ska::flat_hash_map<void*, Block*> allocated_blocks;
+  static size_t get_mutex_shard_id(void* ptr) {
+    return twang_mix64(reinterpret_cast<uintptr_t>(ptr)) % kNumMutexShard;
+  }
 
   void add_allocated_block(Block* block) {
-    std::lock_guard<std::mutex> lock(mutex);
-    allocated_blocks[block->ptr] = block;
+    const auto mutex_shard_id = get_mutex_shard_id(block->ptr);
+    std::lock_guard<std::mutex> lock(mutex[mutex_shard_id].m);
+    allocated_blocks[mutex_shard_id][block->ptr] = block;
+  }
+
+  // Caches of the threads that freed small blocks, see ThreadBlockCache.
+  std::mutex thread_caches_mutex;
+  std::vector<ThreadBlockCache*> thread_caches;
+
+  ThreadBlockCache* local_thread_cache() {
+    auto& holder = thread_block_cache;
+    if (holder.cache == nullptr) {
+      holder.cache = new ThreadBlockCache();
+      std::lock_guard<std::mutex> lock(thread_caches_mutex);
+      thread_caches.push_back(holder.cache);
+    }
+    return holder.cache;
+  }
+
+  static bool use_thread_cache(size_t size) {
+    return CachingAllocatorConfig::thread_cache_size() > 0 &&
+        DeviceCachingAllocator::round_size(size) <=
+        ThreadBlockCache::kMaxBlockSize;
+  }
+
+  // Returns a block from the thread cache, or nullptr with the stats of the
+  // cache moved to stats.
+  Block* thread_cache_malloc(
+      c10::DeviceIndex device,
+      size_t size,
+      void* stream,
+      ThreadCacheStats& stats) {
+    // Thread caches only hold blocks of the global pools.
+    if (!use_thread_cache(size) ||
+        device_allocator[device]->allocatingToPool()) {
+      take_local_stats(device, stats);
+      return nullptr;
+    }
+    ThreadCacheRelease evicted;
+    Block* block = local_thread_cache()->pop(
+        device,
+        stream,
+        DeviceCachingAllocator::round_size(size),
+        size,
+        stats,
+        evicted);
+    release_blocks(evicted);
+    return block;
+  }
+
+  // Keeps block in the thread cache, or returns false with the stats of the
+  // cache moved to stats.
+  bool thread_cache_free(Block* block, ThreadCacheStats& stats) {
+    size_t capacity = CachingAllocatorConfig::thread_cache_size();
+    if (capacity == 0 || block->size > ThreadBlockCache::kMaxBlockSize ||
+        !block->stream_uses.empty() || block->pool->owner_PrivatePool ||
+        device_allocator[block->device]->isHistoryEnabled()) {
+      take_local_stats(block->device, stats);
+      return false;
+    }
+    ThreadCacheRelease evicted;
+    bool kept = local_thread_cache()->push(block, capacity, stats, evicted);
+    release_blocks(evicted);
+    return kept;
+  }
+
+  // Moves the stats the cache of this thread keeps for device, if any, to
+  // stats, so that they are applied before the device allocator is used.
+  static void take_local_stats(
+      c10::DeviceIndex device,
+      ThreadCacheStats& stats) {
+    if (auto* cache = thread_block_cache.cache) {
+      cache->take_stats(device, stats);
+    }
+  }
+
+  // Returns blocks and stats taken out of a thread cache to their device.
+  void release_blocks(const ThreadCacheRelease& release) {
+    if (release.device == -1 ||
+        (release.blocks.empty() && release.stats.empty)) {
+      return;
+    }
+    device_allocator[release.device]->release_thread_cached(
+        release.blocks, release.stats);
+  }
+
+  // Applies the stats the thread caches keep for device.
+  void apply_thread_cache_stats(c10::DeviceIndex device) {
+    ThreadCacheRelease release;
+    release.device = device;
+    {
+      std::lock_guard<std::mutex> lock(thread_caches_mutex);
+      for (auto* cache : thread_caches) {
+        cache->take_stats(device, release.stats);
+      }
+    }
+    release_blocks(release);
   }
 
  public:
   std::vector<std::unique_ptr<DeviceCachingAllocator>> device_allocator;
 
   Block* get_allocated_block(void* ptr, bool remove = false) {
-    std::lock_guard<std::mutex> lock(mutex);
-    auto it = allocated_blocks.find(ptr);
-    if (it == allocated_blocks.end()) {
+    const auto mutex_shard_id = get_mutex_shard_id(ptr);
+    std::lock_guard<std::mutex> lock(mutex[mutex_shard_id].m);
+    auto& blocks = allocated_blocks[mutex_shard_id];
+    auto it = blocks.find(ptr);
+    if (it == blocks.end()) {
       return nullptr;
     }
     Block* block = it->second;
     if (remove) {
-      allocated_blocks.erase(it);
+      blocks.erase(it);
     }
     return block;
   }
@@ -2169,7 +3438,12 @@ class DefaultCachingAllocator : public CachingAllocator {
       c10::DeviceIndex device,
       size_t size,
       void* stream) {
-    Block* block = device_allocator[device]->malloc(device, size, stream);
+    ThreadCacheStats stats;
+    Block* block = thread_cache_malloc(device, size, stream, stats);
+    if (block == nullptr) {
+      block = device_allocator[device]->malloc(
+          device, size, stream, stats.empty ? nullptr : &stats);
+    }
     add_allocated_block(block);
     *devPtr = static_cast<void*>(block->ptr);
   }
@@ -2182,7 +3456,44 @@ class DefaultCachingAllocator : public CachingAllocator {
     if (!block) {
       AT_ERROR("invalid device pointer: ", ptr);
     }
-    device_allocator[block->device]->free(block);
+    ThreadCacheStats stats;
+    if (thread_cache_free(block, stats)) {
+      return;
+    }
+    device_allocator[block->device]->free(
+        block, stats.empty ? nullptr : &stats);
+  }
+
+  // Returns the blocks that thread caches hold for device, or for all
+  // devices if device is -1, to the device allocators.
+  bool drain_thread_caches(c10::DeviceIndex device) {
+    std::vector<ThreadCacheRelease> releases;
+    {
+      std::lock_guard<std::mutex> lock(thread_caches_mutex);
+      for (auto* cache : thread_caches) {
+        cache->drain(device, releases);
+      }
+    }
+    bool freed = false;
+    for (const auto& release : releases) {
+      release_blocks(release);
+      freed |= !release.blocks.empty();
+    }
+    return freed;
+  }
+
+  void remove_thread_cache(ThreadBlockCache* cache) {
+    {
+      std::lock_guard<std::mutex> lock(thread_caches_mutex);
+      thread_caches.erase(
+          std::find(thread_caches.begin(), thread_caches.end(), cache));
+    }
+    std::vector<ThreadCacheRelease> releases;
+    cache->drain(-1, releases);
+    for (const auto& release : releases) {
+      release_blocks(release);
+    }
+    delete cache;
   }
 
   void setMemoryFraction(double fraction, c10::DeviceIndex device) override {
@@ -2207,6 +3518,8 @@ class DefaultCachingAllocator : public CachingAllocator {
       CreateContextFn context_recorder,
       size_t alloc_trace_max_entries,
       RecordContext when) override {
+    // Blocks held by thread caches would show up as allocated.
+    drain_thread_caches(-1);
     for (auto& allocator : device_allocator) {
       allocator->recordHistory(
           enabled, context_recorder, alloc_trace_max_entries, when);
@@ -2224,6 +3537,7 @@ class DefaultCachingAllocator : public CachingAllocator {
   }
 
   void emptyCache(bool check_error) override {
+    drain_thread_caches(-1);
     int count = static_cast<int>(device_allocator.size());
     for (int i = 0; i < count; i++)
       device_allocator[i]->emptyCache(check_error);
@@ -2292,6 +3606,7 @@ class DefaultCachingAllocator : public CachingAllocator {
   }
 
   SnapshotInfo snapshot() override {
+    drain_thread_caches(-1);
     SnapshotInfo result;
     int count = static_cast<int>(device_allocator.size());
     for (int i = 0; i < count; i++) {
@@ -2345,16 +3660,34 @@ class DefaultCachingAllocator : public CachingAllocator {
 
   DeviceStats getDeviceStats(c10::DeviceIndex device) override {
     assertValidDevice(device);
-    return device_allocator[device]->getStats();
+    apply_thread_cache_stats(device);
+    DeviceStats stats = device_allocator[device]->getStats();
+
+    ThreadCacheUsage usage;
+    {
+      std::lock_guard<std::mutex> lock(thread_caches_mutex);
+      for (auto* cache : thread_caches) {
+        cache->collect(device, usage);
+      }
+    }
+    stats.thread_cache_hits = usage.hits;
+    stats.thread_cache_misses = usage.misses;
+    return stats;
   }
 
   void resetAccumulatedStats(c10::DeviceIndex device) override {
     assertValidDevice(device);
+    apply_thread_cache_stats(device);
     device_allocator[device]->resetAccumulatedStats();
+    std::lock_guard<std::mutex> lock(thread_caches_mutex);
+    for (auto* cache : thread_caches) {
+      cache->reset_counters(device);
+    }
   }
 
   void resetPeakStats(c10::DeviceIndex device) override {
     assertValidDevice(device);
+    apply_thread_cache_stats(device);
     device_allocator[device]->resetPeakStats();
   }
 
@@ -2383,9 +3716,30 @@ class DefaultCachingAllocator : public CachingAllocator {
   }
 
   void emptyDeviceCache(c10::DeviceIndex device) override {
+    drain_thread_caches(device);
     device_allocator[device]->emptyCache(true);
   }
 
+  void beginAllocateToPool(
+      c10::DeviceIndex device,
+      MempoolId_t mempool_id,
+      std::function<bool(void*)> filter) override {
+    assertValidDevice(device);
+    device_allocator[device]->beginAllocateToPool(
+        std::move(mempool_id), std::move(filter));
+  }
+
+  void endAllocateToPool(c10::DeviceIndex device, MempoolId_t mempool_id)
+      override {
+    assertValidDevice(device);
+    device_allocator[device]->endAllocateToPool(mempool_id);
+  }
+
+  void releasePool(c10::DeviceIndex device, MempoolId_t mempool_id) override {
+    assertValidDevice(device);
+    device_allocator[device]->releasePool(std::move(mempool_id));
+  }
+
   std::string name() override {
     return "native";
   }
@@ -2402,6 +3756,23 @@ void local_raw_delete(void* ptr) {
   default_caching_allocator.free(ptr);
 }
 
+ThreadBlockCacheHolder::~ThreadBlockCacheHolder() {
+  if (cache != nullptr) {
+    default_caching_allocator.remove_thread_cache(cache);
+  }
+}
+
+// Gives the blocks held by thread caches back when an allocation on the
+// current device does not find a free block.
+class ThreadBlockCacheCallback : public FreeMemoryCallback {
+ public:
+  bool Execute() override {
+    return default_caching_allocator.drain_thread_caches(getDeviceIndex());
+  }
+};
+
+REGISTER_FREE_MEMORY_CALLBACK("thread_block_cache", ThreadBlockCacheCallback);
+
 struct BackendStaticInitializer {
   BackendStaticInitializer() {
     caching_allocator.store(&default_caching_allocator);
@@ -2411,7 +3782,56 @@ struct BackendStaticInitializer {
 std::atomic<CachingAllocator*> caching_allocator;
 BackendStaticInitializer backend_static_initializer;
 
+c10::DeviceIndex CachingAllocatorHelper::getDevice() {
+  return getDeviceGuardImpl()->getDevice().index();
+}
+
+void CachingAllocatorHelper::setDevice(c10::DeviceIndex device) {
+  getDeviceGuardImpl()->setDevice(c10::Device(c10::kPrivateUse1, device));
+}
+
+c10::DeviceIndex CachingAllocatorHelper::deviceCount() {
+  return getDeviceGuardImpl()->deviceCount();
+}
+
+namespace {
+
+// AllocatorEvent of the PrivateUse1 device guard.
+class DeviceGuardEvent : public AllocatorEvent {
+ public:
+  void record(const c10::Stream& stream) override {
+    event_.record(stream);
+  }
+
+  bool query() override {
+    return event_.query();
+  }
+
+  void synchronize() override {
+    event_.synchronize();
+  }
+
+ private:
+  c10::Event event_{c10::kPrivateUse1};
+};
+
+} // namespace
+
+std::unique_ptr<AllocatorEvent> CachingAllocatorHelper::createEvent() {
+  return std::make_unique<DeviceGuardEvent>();
+}
+
 void registerHelper(CachingAllocatorHelper* helper_) {
   helper = helper_;
 }
+
+void setAllocatorSettings(const std::string& env) {
+  CachingAllocatorConfig::instance().parseArgs(env.c_str());
+}
+
+MempoolId_t createPoolId() {
+  // Ids start at 1, {0, 0} means the global pools.
+  static std::atomic<uint64_t> uid{1};
+  return {0, uid++};
+}
 } // namespace c10::backend::CachingAllocator
@@ -5,6 +5,7 @@
 #include <c10/util/Registry.h>
 #include <c10/util/SmallVector.h>
 #include <atomic>
+#include <memory>
 
 namespace c10::backend::CachingAllocator {
 
@@ -36,6 +37,43 @@ enum struct StatType : uint64_t {
 };
 
 typedef std::array<Stat, static_cast<size_t>(StatType::NUM_TYPES)> StatArray;
+
+// Power of two histogram: bucket i counts the values in [2^i, 2^(i+1)),
+// bucket 0 counts 0 as well.
+constexpr size_t kHistogramBuckets = 64;
+typedef std::array<int64_t, kHistogramBuckets> Histogram;
+typedef std::array<Histogram, static_cast<size_t>(StatType::NUM_TYPES)>
+    HistogramArray;
+
+// Sizes of the free blocks cached for a stream.
+struct StreamFreeBlocks {
+  void* stream = nullptr;
+  Histogram sizes{};
+};
+
+// Id of a private memory pool. Pools of captured graphs use
+// {capture id, 0}, pools created by createPoolId use {0, id}.
+using MempoolId_t = std::pair<uint64_t, uint64_t>;
+
+struct MempoolIdHash {
+  std::size_t operator()(const MempoolId_t& mempool_id) const noexcept {
+    return mempool_id.first != 0 ? mempool_id.first : mempool_id.second;
+  }
+};
+
+// Struct containing the summary statistics of a private memory pool.
+struct PoolStats {
+  MempoolId_t id = {0, 0};
+  // COUNT: users of the pool, 0 once every user released it
+  int64_t use_count = 0;
+  // COUNT: number of segments allocated for the pool
+  int64_t segment = 0;
+  // SUM: bytes reserved by the pool (both free and used)
+  int64_t reserved_bytes = 0;
+  // SUM: bytes allocated from the pool
+  int64_t allocated_bytes = 0;
+};
+
 // Struct containing memory allocator summary statistics for a device.
 struct DeviceStats {
   // COUNT: allocations requested by client code
@@ -66,14 +104,64 @@ struct DeviceStats {
   // COUNT: total number of OOMs (i.e. failed calls to NPU after cache flush)
   int64_t num_ooms = 0;
 
+  // COUNT: segments and expandable segment ranges released by the background
+  // reclaim thread (see background_reclaim_ms), and their bytes
+  int64_t num_background_reclaims = 0;
+  int64_t background_reclaimed_bytes = 0;
+
   // COUNT: total number of oversize blocks allocated from pool
   Stat oversize_allocations;
 
   // COUNT: total number of oversize blocks requiring malloc
   Stat oversize_segments;
 
+  // COUNT: events recorded on streams that freed blocks were used by (see
+  // recordStream) and not completed yet. One event covers the blocks freed
+  // on a stream between two allocations, up to 32 of them.
+  Stat outstanding_events;
+
+  // COUNT: queries of those events, divide by allocation.allocated for the
+  // queries per malloc
+  int64_t num_event_queries = 0;
+
   // SIZE: maximum block size that is allowed to be split.
   int64_t max_split_size = 0;
+
+  // SIZE: size classes in use (see small_size_kb, large_buffer_mb,
+  // round_large_mb and roundup_power2_divisions). Allocations up to
+  // small_size go to the small pool, larger ones are packed in large_buffer
+  // segments or rounded up to round_large.
+  int64_t small_size = 0;
+  int64_t large_buffer = 0;
+  int64_t round_large = 0;
+  // COUNT: divisions that sizes are rounded up to, per power of two interval
+  // starting at 1 MiB
+  std::vector<int64_t> roundup_power2_divisions;
+
+  // COUNT: small allocations served from and missed by the per-thread block
+  // caches (see thread_cache_size_kb)
+  int64_t thread_cache_hits = 0;
+  int64_t thread_cache_misses = 0;
+
+  // HISTOGRAM: requested sizes of allocations, in bytes
+  HistogramArray allocation_size_histogram{};
+  // HISTOGRAM: time from allocation to free of blocks, in microseconds
+  HistogramArray block_lifetime_histogram{};
+  // HISTOGRAM: sizes of the free blocks left over by splitting a block
+  HistogramArray split_remainder_histogram{};
+
+  // The stats below are computed from the cached blocks by getDeviceStats.
+  // HISTOGRAM: sizes of the free blocks of each stream, unmapped ranges of
+  // expandable segments excluded
+  std::vector<StreamFreeBlocks> free_block_histograms;
+  // RATIO: 1 - largest free block / free bytes of the pool, 0 without free
+  // blocks. Close to 1 when the free memory is spread over many small blocks.
+  std::array<double, static_cast<size_t>(StatType::NUM_TYPES)>
+      fragmentation{};
+
+  // Private pools of the device, see beginAllocateToPool. Their blocks are
+  // included in the stats above as well.
+  std::vector<PoolStats> private_pools;
 };
 
 typedef std::shared_ptr<c10::GatheredContext> (*CreateContextFn)(void);
@@ -100,6 +188,7 @@ struct SegmentInfo {
   int64_t active_size = 0;
   bool is_large = false;
   bool is_expandable = false;
+  MempoolId_t owner_private_pool_id = {0, 0};
   std::vector<BlockInfo> blocks;
   std::shared_ptr<c10::GatheredContext> context_when_allocated;
 };
@@ -197,6 +286,21 @@ class CachingAllocator : public c10::Allocator {
       size_t alloc_trace_max_entries,
       RecordContext when) = 0;
   virtual void attachOutOfMemoryObserver(OutOfMemoryObserver observer) = 0;
+  // Allocations on device for which filter(stream) returns true are served
+  // from the private pool mempool_id, creating it if needed, until
+  // endAllocateToPool. Blocks of a private pool are only reused for
+  // allocations routed to it, and are kept until every begin of the pool
+  // is matched by a releasePool.
+  virtual void beginAllocateToPool(
+      c10::DeviceIndex device,
+      MempoolId_t mempool_id,
+      std::function<bool(void*)> filter) = 0;
+  virtual void endAllocateToPool(
+      c10::DeviceIndex device,
+      MempoolId_t mempool_id) = 0;
+  // Drops a use of the pool. Once unused, its cached memory is freed by
+  // emptyCache and the pool goes away when its last block is freed.
+  virtual void releasePool(c10::DeviceIndex device, MempoolId_t mempool_id) = 0;
 };
 
 // Allocator object, statically initialized
@@ -213,6 +317,16 @@ static const int MEM_ALLOCATION_ERROR = 1;
 CachingAllocatorHelper contains functions that are used by
 DefaultCachingAllocator, and each backend should have its own implementation.
 */
+// Event recorded on a stream that freed blocks were used by (see
+// recordStream). The blocks are reused once it completes.
+class AllocatorEvent {
+ public:
+  virtual ~AllocatorEvent() = default;
+  virtual void record(const c10::Stream& stream) = 0;
+  virtual bool query() = 0;
+  virtual void synchronize() = 0;
+};
+
 class CachingAllocatorHelper {
  public:
   // Wraps the insert event function
@@ -223,12 +337,23 @@ class CachingAllocatorHelper {
   // Returns the current stream for the given device
   virtual void* getCurrentStream(c10::DeviceIndex) = 0;
 
-  // Synchronizes the stream. e.g. cudaStreamSynchronize
-  virtual int synchronizeStream(void* stream) = 0;
+  // Synchronizes the stream of the given device. e.g. cudaStreamSynchronize
+  virtual int synchronizeStream(c10::DeviceIndex device, void* stream) = 0;
 
   // Wait for compute device to finish. e.g. cudaDeviceSynchronize.
   virtual void deviceSynchronize() = 0;
 
+  // Current device, switching devices and the number of devices. Backends
+  // whose devices are managed by the PrivateUse1 device guard can rely on
+  // the defaults.
+  virtual c10::DeviceIndex getDevice();
+  virtual void setDevice(c10::DeviceIndex device);
+  virtual c10::DeviceIndex deviceCount();
+
+  // Creates an event for the allocator to record. The default is a
+  // c10::Event of the PrivateUse1 device guard.
+  virtual std::unique_ptr<AllocatorEvent> createEvent();
+
   /*
    memory management
    */
@@ -296,6 +421,11 @@ class CachingAllocatorHelper {
 // register CachingAllocatorHelper for DefaultCachingAllocator.
 void registerHelper(CachingAllocatorHelper* helper);
 
+// Replaces the settings read from PYTORCH_ALLOC_CONF, options missing from
+// env go back to their defaults. Cached blocks keep the layout they were
+// allocated with, so empty the cache before switching.
+void setAllocatorSettings(const std::string& env);
+
 inline CachingAllocator* get() {
   return caching_allocator.load();
 }
@@ -385,4 +515,24 @@ inline void attachOutOfMemoryObserver(OutOfMemoryObserver observer) {
   return get()->attachOutOfMemoryObserver(observer);
 }
 
+// Returns an id for a new private pool.
+MempoolId_t createPoolId();
+
+inline void beginAllocateToPool(
+    c10::DeviceIndex device,
+    MempoolId_t mempool_id,
+    std::function<bool(void*)> filter) {
+  return get()->beginAllocateToPool(device, mempool_id, std::move(filter));
+}
+
+inline void endAllocateToPool(
+    c10::DeviceIndex device,
+    MempoolId_t mempool_id) {
+  return get()->endAllocateToPool(device, mempool_id);
+}
+
+inline void releasePool(c10::DeviceIndex device, MempoolId_t mempool_id) {
+  return get()->releasePool(device, mempool_id);
+}
+
 } // namespace c10::backend::CachingAllocator
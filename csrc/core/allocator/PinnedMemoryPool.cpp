@@ -0,0 +1,244 @@
+#include "csrc/core/allocator/PinnedMemoryPool.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+#include <c10/util/Exception.h>
+#include <c10/util/llvmMathExtras.h>
+
+namespace c10::backend::HostAllocator {
+
+PinnedMemoryPool::PinnedMemoryPool(
+    AllocFn alloc,
+    FreeFn free,
+    size_t slab_size,
+    size_t initial_slab_size)
+    : alloc_(std::move(alloc)),
+      free_(std::move(free)),
+      slab_size_(slab_size),
+      max_chunk_size_(c10::llvm::PowerOf2Floor(slab_size / 4)),
+      next_slab_size_(std::min(initial_slab_size, slab_size)) {
+  TORCH_CHECK(
+      max_chunk_size_ >= kMinChunkSize,
+      "Pinned memory slabs must hold at least 4 chunks of ",
+      kMinChunkSize,
+      " bytes");
+  free_chunks_.resize(classIndex(max_chunk_size_) + 1);
+}
+
+size_t PinnedMemoryPool::chunkSize(size_t size) const {
+  if (size <= kMinChunkSize) {
+    return kMinChunkSize;
+  }
+  size_t chunk_size = c10::llvm::PowerOf2Ceil(size);
+  return chunk_size <= max_chunk_size_ ? chunk_size : 0;
+}
+
+size_t PinnedMemoryPool::classIndex(size_t chunk_size) const {
+  return c10::llvm::Log2_64(chunk_size) - c10::llvm::Log2_64(kMinChunkSize);
+}
+
+void* PinnedMemoryPool::malloc(size_t size) {
+  size_t chunk_size = chunkSize(size);
+  if (chunk_size == 0) {
+    void* ptr = alloc_(size);
+    if (ptr == nullptr) {
+      return nullptr;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto begin = reinterpret_cast<uintptr_t>(ptr);
+    indexInsert({begin, begin + size, nullptr});
+    stats_.driver_allocs++;
+    stats_.pinned_bytes += static_cast<int64_t>(size);
+    return ptr;
+  }
+
+  size_t slab_size = 0;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto& chunks = free_chunks_[classIndex(chunk_size)];
+    if (!chunks.empty()) {
+      auto chunk = chunks.back();
+      chunks.pop_back();
+      chunk.second->live++;
+      stats_.class_hits++;
+      return chunk.first;
+    }
+    if (void* ptr = carve(chunk_size)) {
+      return ptr;
+    }
+    slab_size = std::max(next_slab_size_, chunk_size);
+  }
+
+  // The driver is called without the mutex, so lookups are not held up.
+  void* base = alloc_(slab_size);
+  if (base == nullptr) {
+    return nullptr;
+  }
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  addSlab(base, slab_size, /*reserved=*/false);
+  next_slab_size_ =
+      std::max(next_slab_size_, std::min(slab_size * 2, slab_size_));
+  void* ptr = carve(chunk_size);
+  TORCH_INTERNAL_ASSERT(ptr != nullptr);
+  return ptr;
+}
+
+void PinnedMemoryPool::free(void* ptr, size_t size) {
+  auto addr = reinterpret_cast<uintptr_t>(ptr);
+  std::unique_lock<std::shared_mutex> lock(mutex_);
+  const Range* range = indexFind(addr);
+  TORCH_INTERNAL_ASSERT(
+      range != nullptr && range->begin <= addr,
+      "Pointer was not allocated by the pinned memory pool");
+  Slab* slab = range->slab;
+  if (slab == nullptr) {
+    indexErase(range->begin, range->end);
+    stats_.driver_frees++;
+    stats_.pinned_bytes -= static_cast<int64_t>(size);
+    lock.unlock();
+    free_(ptr);
+    return;
+  }
+  free_chunks_[classIndex(chunkSize(size))].emplace_back(ptr, slab);
+  slab->live--;
+}
+
+bool PinnedMemoryPool::contains(const void* ptr) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return indexFind(reinterpret_cast<uintptr_t>(ptr)) != nullptr;
+}
+
+void PinnedMemoryPool::reserve(size_t bytes) {
+  size_t count = (bytes + slab_size_ - 1) / slab_size_;
+  for (size_t i = 0; i < count; i++) {
+    void* base = alloc_(slab_size_);
+    if (base == nullptr) {
+      return;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    addSlab(base, slab_size_, /*reserved=*/true);
+  }
+}
+
+void PinnedMemoryPool::releaseFreeSlabs() {
+  std::vector<void*> to_free;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto releasable = [](const std::unique_ptr<Slab>& slab) {
+      return slab->live == 0 && !slab->reserved;
+    };
+    if (std::none_of(slabs_.begin(), slabs_.end(), releasable)) {
+      return;
+    }
+    for (auto& chunks : free_chunks_) {
+      chunks.erase(
+          std::remove_if(
+              chunks.begin(),
+              chunks.end(),
+              [](const std::pair<void*, Slab*>& chunk) {
+                return chunk.second->live == 0 && !chunk.second->reserved;
+              }),
+          chunks.end());
+    }
+    for (const auto& slab : slabs_) {
+      if (releasable(slab)) {
+        auto begin = reinterpret_cast<uintptr_t>(slab->base);
+        indexErase(begin, begin + slab->size);
+        to_free.push_back(slab->base);
+        stats_.slabs--;
+        stats_.driver_frees++;
+        stats_.pinned_bytes -= static_cast<int64_t>(slab->size);
+      }
+    }
+    slabs_.erase(
+        std::remove_if(slabs_.begin(), slabs_.end(), releasable),
+        slabs_.end());
+  }
+  for (void* base : to_free) {
+    free_(base);
+  }
+}
+
+PinnedMemoryStats PinnedMemoryPool::getStats() const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  return stats_;
+}
+
+void* PinnedMemoryPool::carve(size_t chunk_size) {
+  // Chunks are aligned to their size, up to a page.
+  size_t alignment = std::min<size_t>(chunk_size, 4096);
+  for (auto it = slabs_.rbegin(); it != slabs_.rend(); ++it) {
+    Slab* slab = it->get();
+    size_t offset = (slab->carved + alignment - 1) & ~(alignment - 1);
+    if (offset + chunk_size <= slab->size) {
+      slab->carved = offset + chunk_size;
+      slab->live++;
+      return slab->base + offset;
+    }
+  }
+  return nullptr;
+}
+
+PinnedMemoryPool::Slab* PinnedMemoryPool::addSlab(
+    void* base,
+    size_t size,
+    bool reserved) {
+  auto slab = std::make_unique<Slab>();
+  slab->base = static_cast<char*>(base);
+  slab->size = size;
+  slab->reserved = reserved;
+  auto begin = reinterpret_cast<uintptr_t>(base);
+  indexInsert({begin, begin + size, slab.get()});
+  slabs_.push_back(std::move(slab));
+  stats_.slabs++;
+  stats_.reserved_slabs += reserved;
+  stats_.driver_allocs++;
+  stats_.pinned_bytes += static_cast<int64_t>(size);
+  return slabs_.back().get();
+}
+
+void PinnedMemoryPool::indexInsert(const Range& range) {
+  for (uintptr_t g = range.begin >> kGranuleShift;
+       g <= (range.end - 1) >> kGranuleShift;
+       g++) {
+    granules_[g].push_back(range);
+  }
+}
+
+void PinnedMemoryPool::indexErase(uintptr_t begin, uintptr_t end) {
+  for (uintptr_t g = begin >> kGranuleShift; g <= (end - 1) >> kGranuleShift;
+       g++) {
+    auto it = granules_.find(g);
+    if (it == granules_.end()) {
+      continue;
+    }
+    auto& ranges = it->second;
+    ranges.erase(
+        std::remove_if(
+            ranges.begin(),
+            ranges.end(),
+            [begin](const Range& range) { return range.begin == begin; }),
+        ranges.end());
+    if (ranges.empty()) {
+      granules_.erase(it);
+    }
+  }
+}
+
+const PinnedMemoryPool::Range* PinnedMemoryPool::indexFind(
+    uintptr_t addr) const {
+  auto it = granules_.find(addr >> kGranuleShift);
+  if (it == granules_.end()) {
+    return nullptr;
+  }
+  for (const Range& range : it->second) {
+    if (range.begin <= addr && addr < range.end) {
+      return &range;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace c10::backend::HostAllocator
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <shared_mutex>
+#include <vector>
+
+#include <c10/util/SmallVector.h>
+#include <c10/util/flat_hash_map.h>
+
+namespace c10::backend::HostAllocator {
+
+struct PinnedMemoryStats {
+  // COUNT: calls into the driver that allocate or free pinned memory
+  int64_t driver_allocs = 0;
+  int64_t driver_frees = 0;
+  // COUNT: slabs currently held, and the ones of them reserved
+  int64_t slabs = 0;
+  int64_t reserved_slabs = 0;
+  // SUM: pinned bytes currently held, in slabs or allocated on their own
+  int64_t pinned_bytes = 0;
+  // COUNT: allocations served from a free chunk of their size class
+  int64_t class_hits = 0;
+};
+
+// Pinned host memory, taken from the driver in slabs that are carved into
+// power of two size classes. The first slab is small and each new one is
+// twice the size of the previous, up to the slab size, so processes that pin
+// little memory do not hold a whole slab. Sizes above the largest class are allocated on
+// their own. Chunks freed go back to the free list of their class, so
+// pinning the same kinds of buffers over and over does not call the driver
+// again. Every pinned range is indexed by 2 MiB granule, so pointers
+// anywhere inside pinned memory are recognized with one hash lookup.
+//
+// Memory is not given back on destruction, since the pool is meant to live
+// in a static allocator that may outlive the driver.
+class PinnedMemoryPool {
+ public:
+  // alloc returns nullptr on failure.
+  using AllocFn = std::function<void*(size_t)>;
+  using FreeFn = std::function<void(void*)>;
+
+  static constexpr size_t kMinChunkSize = 512;
+  static constexpr size_t kDefaultSlabSize = size_t(64) << 20;
+  static constexpr size_t kInitialSlabSize = size_t(2) << 20;
+
+  PinnedMemoryPool(
+      AllocFn alloc,
+      FreeFn free,
+      size_t slab_size = kDefaultSlabSize,
+      size_t initial_slab_size = kInitialSlabSize);
+
+  // Returns pinned memory of at least size bytes, nullptr if the driver is
+  // out of memory.
+  void* malloc(size_t size);
+  // Gives back memory returned by malloc(size).
+  void free(void* ptr, size_t size);
+  // Whether ptr points inside pinned memory held by the pool.
+  bool contains(const void* ptr) const;
+
+  // Allocates slabs of the full slab size for at least bytes up front.
+  // Reserved slabs are kept by releaseFreeSlabs.
+  void reserve(size_t bytes);
+  // Gives the slabs without allocated chunks back to the driver.
+  void releaseFreeSlabs();
+
+  PinnedMemoryStats getStats() const;
+
+  // Size class that allocations of size are served from, 0 for sizes that
+  // are allocated on their own.
+  size_t chunkSize(size_t size) const;
+
+ private:
+  struct Slab {
+    char* base;
+    size_t size;
+    // Bytes handed out from the start of the slab so far.
+    size_t carved = 0;
+    // Chunks of the slab currently allocated.
+    size_t live = 0;
+    bool reserved = false;
+  };
+
+  struct Range {
+    uintptr_t begin;
+    uintptr_t end;
+    Slab* slab; // nullptr for memory allocated on its own
+  };
+
+  static constexpr int kGranuleShift = 21;
+
+  void* carve(size_t chunk_size);
+  Slab* addSlab(void* base, size_t size, bool reserved);
+  void indexInsert(const Range& range);
+  void indexErase(uintptr_t begin, uintptr_t end);
+  const Range* indexFind(uintptr_t addr) const;
+  size_t classIndex(size_t chunk_size) const;
+
+  AllocFn alloc_;
+  FreeFn free_;
+  const size_t slab_size_;
+  const size_t max_chunk_size_;
+
+  mutable std::shared_mutex mutex_;
+  std::vector<std::unique_ptr<Slab>> slabs_;
+  // Size of the next slab allocated by malloc.
+  size_t next_slab_size_;
+  // Free chunks per size class, from kMinChunkSize to max_chunk_size_.
+  std::vector<std::vector<std::pair<void*, Slab*>>> free_chunks_;
+  ska::flat_hash_map<uintptr_t, c10::SmallVector<Range, 1>> granules_;
+  PinnedMemoryStats stats_;
+};
+
+} // namespace c10::backend::HostAllocator
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "framework/AclResourceCache.h"
+#include "framework/OpParamMaker.h"
+
+using at_npu::native::AclTensorDescKey;
+using at_npu::native::AclTensorDescKeyHash;
+using at_npu::native::OpAttrMaker;
+
+TEST(AclResourceCacheTest, TestTensorDescKey) {
+  AclTensorDescKey key;
+  key.dataType = ACL_FLOAT16;
+  key.originFormat = ACL_FORMAT_NCHW;
+  key.dims = {2, 3, 4, 5};
+  key.hasFormat = true;
+  key.format = ACL_FORMAT_NC1HWC0;
+  key.hasStorageDims = true;
+  key.storageDims = {2, 1, 4, 5, 16};
+
+  AclTensorDescKey same = key;
+  EXPECT_EQ(key, same);
+  EXPECT_EQ(AclTensorDescKeyHash()(key), AclTensorDescKeyHash()(same));
+
+  AclTensorDescKey otherShape = key;
+  otherShape.dims = {2, 3, 5, 4};
+  EXPECT_FALSE(key == otherShape);
+
+  AclTensorDescKey otherName = key;
+  otherName.name = "x";
+  EXPECT_FALSE(key == otherName);
+
+  // An empty storage shape is still set on the desc, unlike no shape at all.
+  AclTensorDescKey emptyShape;
+  emptyShape.hasStorageDims = true;
+  EXPECT_FALSE(emptyShape == AclTensorDescKey());
+}
+
+TEST(AclResourceCacheTest, TestOpAttrKey) {
+  auto makeKey = [](int64_t axis, bool keepDim) {
+    std::string key("ReduceSum");
+    key.push_back('\0');
+    OpAttrMaker::AppendKey(key, "axes", c10::IntArrayRef({axis}));
+    OpAttrMaker::AppendKey(key, "keep_dims", keepDim);
+    OpAttrMaker::AppendKey(key, "_exclude_engines", std::string("AiCore"));
+    return key;
+  };
+
+  EXPECT_EQ(makeKey(1, true), makeKey(1, true));
+  EXPECT_NE(makeKey(1, true), makeKey(2, true));
+  EXPECT_NE(makeKey(1, true), makeKey(1, false));
+
+  // Names are length prefixed, so shifting bytes between them changes the key.
+  std::string lhs("Op");
+  lhs.push_back('\0');
+  std::string rhs = lhs;
+  OpAttrMaker::AppendKey(lhs, "ab", std::string("c"));
+  OpAttrMaker::AppendKey(rhs, "a", std::string("bc"));
+  EXPECT_NE(lhs, rhs);
+}
@@ -0,0 +1,171 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+#include "framework/contiguous/ContiguousOpt.h"
+
+// Feeds view layouts of transformer activations through the contiguous
+// optimization cache key: q/k/v slices of a fused projection, head permutes,
+// K transposes, token selects and sequence windows. Reports how many distinct
+// layouts share a hash with the previous shifted-xor key and the current one,
+// and the cost of hashing plus a cache lookup.
+
+namespace {
+
+using at_npu::native::CachedContiguousOpt;
+using at_npu::native::ContiguousOptCache;
+using at_npu::native::ContiguousTensorDesc;
+using at_npu::native::OptimizationCase;
+using Dims = c10::SmallVector<int64_t, at_npu::native::MAX_DIM>;
+
+constexpr int kLookupRounds = 20;
+
+Dims ContiguousStrides(const Dims& sizes) {
+  Dims strides(sizes.size(), 1);
+  for (int i = static_cast<int>(sizes.size()) - 2; i >= 0; i--) {
+    strides[i] = strides[i + 1] * sizes[i + 1];
+  }
+  return strides;
+}
+
+ContiguousTensorDesc MakeView(
+    const Dims& base,
+    const Dims& sizes,
+    const Dims& strides,
+    int64_t offset) {
+  ContiguousTensorDesc desc = {};
+  desc.sizes_ = sizes;
+  desc.strides_ = strides;
+  desc.offset_ = offset;
+  desc.base_sizes_ = base;
+  desc.base_strides_ = ContiguousStrides(base);
+  desc.storage_sizes_ = base;
+  desc.npu_format_ = ACL_FORMAT_ND;
+  return desc;
+}
+
+std::vector<ContiguousTensorDesc> TransformerViews() {
+  std::vector<ContiguousTensorDesc> views;
+  for (int64_t B : {1, 2, 4, 8, 16, 32}) {
+    for (int64_t S = 128; S <= 4096; S += 128) {
+      for (int64_t H : {8, 12, 16, 32, 40}) {
+        for (int64_t D : {64, 128}) {
+          int64_t HD = H * D;
+          // q, k and v out of a fused projection
+          for (int64_t i = 0; i < 3; i++) {
+            views.push_back(MakeView(
+                {B, S, 3 * HD}, {B, S, HD}, {S * 3 * HD, 3 * HD, 1}, i * HD));
+          }
+          // [B, S, H, D] -> [B, H, S, D]
+          views.push_back(
+              MakeView({B, S, H, D}, {B, H, S, D}, {S * HD, D, HD, 1}, 0));
+          // K^T: [B, H, S, D] -> [B, H, D, S]
+          views.push_back(MakeView(
+              {B, H, S, D}, {B, H, D, S}, {H * S * D, S * D, 1, D}, 0));
+          // single token hidden states
+          for (int64_t s : {int64_t(0), S / 2, S - 1}) {
+            views.push_back(MakeView({B, S, HD}, {B, HD}, {S * HD, 1}, s * HD));
+          }
+          // trailing windows of the sequence
+          for (int64_t s : {S / 4, S / 2}) {
+            views.push_back(MakeView(
+                {B, S, HD}, {B, s, HD}, {S * HD, HD, 1}, (S - s) * HD));
+          }
+        }
+      }
+    }
+  }
+  return views;
+}
+
+std::vector<int64_t> FlatKey(const ContiguousTensorDesc& desc) {
+  std::vector<int64_t> key;
+  for (const Dims* dims :
+       {&desc.sizes_, &desc.strides_, &desc.base_sizes_, &desc.base_strides_}) {
+    key.push_back(static_cast<int64_t>(dims->size()));
+    key.insert(key.end(), dims->begin(), dims->end());
+  }
+  key.push_back(desc.offset_);
+  key.push_back(desc.npu_format_);
+  return key;
+}
+
+size_t LegacyDimsHash(const Dims& dims) {
+  size_t seed = 0;
+  for (auto dim : dims) {
+    seed ^= static_cast<size_t>(dim) + (seed << 6) + (seed >> 2);
+  }
+  return seed;
+}
+
+size_t LegacyHash(const ContiguousTensorDesc& desc) {
+  return (LegacyDimsHash(desc.sizes_) << 52) +
+      (LegacyDimsHash(desc.base_sizes_) << 40) +
+      (LegacyDimsHash(desc.strides_) << 28) +
+      (LegacyDimsHash(desc.base_strides_) << 16) +
+      (static_cast<size_t>(desc.offset_) << 4) + desc.npu_format_;
+}
+
+template <typename HashFunc>
+size_t CountCollisions(
+    const std::vector<ContiguousTensorDesc>& descs,
+    HashFunc hash) {
+  std::unordered_map<size_t, size_t> buckets;
+  for (const auto& desc : descs) {
+    buckets[hash(desc)]++;
+  }
+  // Layouts that share their hash with an earlier one.
+  return descs.size() - buckets.size();
+}
+
+} // namespace
+
+TEST(ContiguousHashBenchmark, TransformerViewPatterns) {
+  std::vector<ContiguousTensorDesc> descs;
+  std::set<std::vector<int64_t>> seen;
+  for (auto& desc : TransformerViews()) {
+    if (seen.insert(FlatKey(desc)).second) {
+      descs.push_back(std::move(desc));
+    }
+  }
+
+  size_t legacy = CountCollisions(descs, LegacyHash);
+  size_t current = CountCollisions(descs, ContiguousOptCache::Hash);
+  printf(
+      "[ContiguousHashBenchmark] %zu layouts, colliding: legacy=%zu (%.2f%%) "
+      "current=%zu (%.2f%%)\n",
+      descs.size(),
+      legacy,
+      100.0 * legacy / descs.size(),
+      current,
+      100.0 * current / descs.size());
+  EXPECT_EQ(current, 0);
+
+  ContiguousOptCache cache(size_t(1) << 30);
+  for (auto& desc : descs) {
+    desc.hash_src_desc = ContiguousOptCache::Hash(desc);
+    CachedContiguousOpt opt{OptimizationCase::SLICE};
+    opt.contiguous_tensor_desc = desc;
+    cache.Insert(desc, std::move(opt));
+  }
+
+  size_t hits = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int round = 0; round < kLookupRounds; round++) {
+    for (auto& desc : descs) {
+      desc.hash_src_desc = ContiguousOptCache::Hash(desc);
+      hits += cache.Find(desc) != nullptr;
+    }
+  }
+  double elapsed = std::chrono::duration<double, std::nano>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+  size_t lookups = kLookupRounds * descs.size();
+  printf(
+      "[ContiguousHashBenchmark] hash + lookup: %.1f ns\n", elapsed / lookups);
+  EXPECT_EQ(hits, lookups);
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include "framework/contiguous/ContiguousOpt.h"
+
+using at_npu::native::CachedContiguousOpt;
+using at_npu::native::ContiguousOptCache;
+using at_npu::native::ContiguousTensorDesc;
+using at_npu::native::OptimizationCase;
+
+namespace {
+
+ContiguousTensorDesc MakeDesc(int64_t dim, size_t hash) {
+  ContiguousTensorDesc desc = {};
+  desc.sizes_ = {dim, 4};
+  desc.strides_ = {1, dim};
+  desc.base_sizes_ = {4, dim};
+  desc.base_strides_ = {dim, 1};
+  desc.npu_format_ = ACL_FORMAT_ND;
+  desc.hash_src_desc = hash;
+  return desc;
+}
+
+CachedContiguousOpt MakeOpt(const ContiguousTensorDesc& desc) {
+  CachedContiguousOpt opt{OptimizationCase::PERMUTE};
+  opt.cached_opt_parameters.push_back({1, 0});
+  opt.cached_opt_parameters.push_back(desc.sizes_);
+  opt.contiguous_tensor_desc = desc;
+  return opt;
+}
+
+} // namespace
+
+TEST(ContiguousOptCacheTest, TestFindMatchesWholeDesc) {
+  ContiguousOptCache cache(1 << 20);
+  auto desc = MakeDesc(3, 42);
+  EXPECT_EQ(cache.Find(desc), nullptr);
+  cache.Insert(desc, MakeOpt(desc));
+
+  auto opt = cache.Find(desc);
+  ASSERT_NE(opt, nullptr);
+  EXPECT_EQ(opt->cached_opt_case, OptimizationCase::PERMUTE);
+  EXPECT_EQ(opt->cached_opt_parameters[1][0], 3);
+
+  // Same hash but another layout must not hit.
+  auto collision = MakeDesc(5, 42);
+  EXPECT_EQ(cache.Find(collision), nullptr);
+  cache.Insert(collision, MakeOpt(collision));
+  EXPECT_EQ(cache.Find(collision)->cached_opt_parameters[1][0], 5);
+  EXPECT_EQ(cache.Find(desc)->cached_opt_parameters[1][0], 3);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, 3);
+  EXPECT_EQ(stats.misses, 2);
+  EXPECT_EQ(stats.entries, 2);
+}
+
+TEST(ContiguousOptCacheTest, TestEvictLeastRecentlyUsed) {
+  constexpr size_t kMaxBytes = 256 * 1024;
+  ContiguousOptCache cache(kMaxBytes);
+  // All descs share one hash, so they land in the same shard.
+  auto hot = MakeDesc(1, 7);
+  cache.Insert(hot, MakeOpt(hot));
+  for (int64_t dim = 2; dim < 1000; dim++) {
+    auto desc = MakeDesc(dim, 7);
+    cache.Insert(desc, MakeOpt(desc));
+    ASSERT_NE(cache.Find(hot), nullptr);
+  }
+
+  auto stats = cache.GetStats();
+  EXPECT_GT(stats.evictions, 0);
+  EXPECT_LE(stats.bytes, kMaxBytes);
+  EXPECT_EQ(cache.Find(MakeDesc(2, 7)), nullptr);
+  EXPECT_NE(cache.Find(MakeDesc(999, 7)), nullptr);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Find(hot), nullptr);
+  EXPECT_EQ(cache.GetStats().entries, 0);
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "aten/utils/OpApiCacheCounters.h"
+#include "aten/utils/op_api_common.h"
+
+using at_npu::native::OpApiCacheCounters;
+
+namespace {
+
+uint64_t HashIntArray(const std::vector<int64_t>& values) {
+  init_hash_buf(false);
+  add_param_to_buf(std::string("aclnnCat"));
+  add_param_to_buf(at::IntArrayRef(values));
+  return calc_hash_id();
+}
+
+} // namespace
+
+TEST(OpApiCacheCountersTest, TestCounters) {
+  using Outcome = OpApiCacheCounters::Outcome;
+  OpApiCacheCounters cache;
+  cache.Count("aclnnAdd", Outcome::MISS);
+  cache.Count("aclnnAdd", Outcome::HIT);
+  cache.Count("aclnnAdd", Outcome::HIT);
+  cache.Count("aclnnAdd", Outcome::BYPASS);
+  cache.Count("aclnnMul", Outcome::MISS);
+
+  auto stats = cache.GetStats("aclnnAdd");
+  EXPECT_EQ(stats.hits, 2);
+  EXPECT_EQ(stats.misses, 1);
+  EXPECT_EQ(stats.bypasses, 1);
+  EXPECT_EQ(cache.GetStats("aclnnMul").misses, 1);
+  EXPECT_EQ(cache.GetAllStats().size(), 2);
+
+  cache.Clear();
+  EXPECT_EQ(cache.GetStats("aclnnAdd").hits, 0);
+  EXPECT_TRUE(cache.GetAllStats().empty());
+  // Counting still works after a clear.
+  cache.Count("aclnnAdd", Outcome::HIT);
+  EXPECT_EQ(cache.GetStats("aclnnAdd").hits, 1);
+}
+
+TEST(OpApiCacheCountersTest, TestCountsFromThreads) {
+  OpApiCacheCounters cache;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&cache]() {
+      for (int j = 0; j < 1000; j++) {
+        cache.Count("aclnnAdd", OpApiCacheCounters::Outcome::HIT);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(cache.GetStats("aclnnAdd").hits, 4000);
+}
+
+TEST(OpApiCacheCountersTest, TestLargeParamsAreKeyed) {
+  // 24 KB of params, as with the shapes of a long tensor list.
+  std::vector<int64_t> values(3072, 1);
+  uint64_t hash = HashIntArray(values);
+  EXPECT_NE(hash, 0);
+  EXPECT_EQ(hash, HashIntArray(values));
+
+  values.back() = 2;
+  EXPECT_NE(hash, HashIntArray(values));
+  values.back() = 1;
+  values.front() = 2;
+  EXPECT_NE(hash, HashIntArray(values));
+}
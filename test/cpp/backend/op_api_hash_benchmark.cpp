@@ -0,0 +1,212 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "aten/utils/OpApiHasher.h"
+
+// Keys the params of a _foreach_ op the way add_param_to_buf does for every
+// tensor of its lists: view shape, dtype, strides, offset and storage shape.
+// Compares the streaming hasher with the previous approach of copying them
+// into an 8 KB thread-local buffer and hashing that, which gave up on lists
+// that did not fit.
+
+namespace {
+
+using at_npu::native::OpApiHasher;
+
+constexpr int kRounds = 2000;
+constexpr int kLegacyBufSize = 8192;
+
+struct FakeTensor {
+  std::vector<int64_t> sizes;
+  std::vector<int64_t> strides;
+  int64_t dtype;
+  int64_t offset;
+  int64_t storage;
+};
+
+std::vector<FakeTensor> MakeTensorList(int num) {
+  std::vector<FakeTensor> tensors;
+  for (int i = 0; i < num; i++) {
+    int64_t rows = 64 + i;
+    tensors.push_back({{rows, 1024}, {1024, 1}, 6, 0, rows * 1024});
+  }
+  return tensors;
+}
+
+uint64_t RotateLeft(uint64_t x, int n) {
+  return (x << n) | (x >> (64 - n));
+}
+
+uint64_t Mix(uint64_t x) {
+  x ^= x >> 33;
+  x *= 18397679294719823053LLU;
+  x ^= x >> 33;
+  x *= 14181476777654086739LLU;
+  x ^= x >> 33;
+  return x;
+}
+
+// The MurmurHash3 variant the params were keyed with before OpApiHasher.
+// MurmurHash3 was written by Austin Appleby, and is placed in the public
+// domain. The author hereby disclaims copyright to this source code.
+uint64_t LegacyHash(const void* key, int len, uint64_t seed = 0xdeadb0d7) {
+  const auto* data = static_cast<const uint8_t*>(key);
+  const int block_num = len / 16;
+  uint64_t h1 = seed;
+  uint64_t h2 = seed;
+  const uint64_t c1 = 9782798678568883157LLU;
+  const uint64_t c2 = 5545529020109919103LLU;
+
+  for (int i = 0; i < block_num; i++) {
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+    memcpy(&k1, data + i * 16, sizeof(k1));
+    memcpy(&k2, data + i * 16 + 8, sizeof(k2));
+
+    k1 *= c1;
+    k1 = RotateLeft(k1, 31);
+    k1 *= c2;
+    h1 ^= k1;
+    h1 = RotateLeft(h1, 27);
+    h1 += h2;
+    h1 = h1 * 5 + 1390208809;
+
+    k2 *= c2;
+    k2 = RotateLeft(k2, 33);
+    k2 *= c1;
+    h2 ^= k2;
+    h2 = RotateLeft(h2, 31);
+    h2 += h1;
+    h2 = h2 * 5 + 944331445;
+  }
+
+  const uint8_t* tail = data + block_num * 16;
+  const int tail_len = len & 15;
+  uint64_t k1 = 0;
+  uint64_t k2 = 0;
+  for (int i = tail_len - 1; i >= 8; i--) {
+    k2 ^= static_cast<uint64_t>(tail[i]) << ((i - 8) * 8);
+  }
+  if (tail_len > 8) {
+    k2 *= c2;
+    k2 = RotateLeft(k2, 33);
+    k2 *= c1;
+    h2 ^= k2;
+  }
+  for (int i = std::min(tail_len, 8) - 1; i >= 0; i--) {
+    k1 ^= static_cast<uint64_t>(tail[i]) << (i * 8);
+  }
+  if (tail_len > 0) {
+    k1 *= c1;
+    k1 = RotateLeft(k1, 31);
+    k1 *= c2;
+    h1 ^= k1;
+  }
+
+  h1 ^= static_cast<uint64_t>(len);
+  h2 ^= static_cast<uint64_t>(len);
+  h1 += h2;
+  h2 += h1;
+  h1 = Mix(h1);
+  h2 = Mix(h2);
+  h1 += h2;
+  h2 += h1;
+  return h2;
+}
+
+class LegacyBuf {
+ public:
+  void Add(const void* data, size_t size) {
+    if (offset_ + size > sizeof(buf_)) {
+      overflow_ = true;
+      return;
+    }
+    memcpy(buf_ + offset_, data, size);
+    offset_ += size;
+  }
+
+  uint64_t Hash(const std::vector<FakeTensor>& tensors) {
+    offset_ = 0;
+    overflow_ = false;
+    for (const auto& t : tensors) {
+      Add(t.sizes.data(), t.sizes.size() * sizeof(int64_t));
+      Add(&t.dtype, sizeof(t.dtype));
+      Add(",", 1);
+      Add(t.strides.data(), t.strides.size() * sizeof(int64_t));
+      Add(&t.offset, sizeof(t.offset));
+      Add(&t.storage, sizeof(t.storage));
+    }
+    size_t counter = tensors.size();
+    Add(&counter, sizeof(counter));
+    return overflow_ ? 0 : LegacyHash(buf_, static_cast<int>(offset_));
+  }
+
+ private:
+  char buf_[kLegacyBufSize];
+  size_t offset_ = 0;
+  bool overflow_ = false;
+};
+
+uint64_t StreamHash(OpApiHasher& hasher, const std::vector<FakeTensor>& list) {
+  hasher.Reset();
+  for (const auto& t : list) {
+    hasher.AddRun(t.sizes.data(), t.sizes.size());
+    hasher.AddWord(t.dtype);
+    hasher.AddRun(t.strides.data(), t.strides.size());
+    hasher.AddWord(t.offset);
+    hasher.AddRun(&t.storage, 1);
+  }
+  hasher.AddWord(list.size());
+  return hasher.Digest();
+}
+
+template <typename HashFunc>
+double NsPerTensor(const std::vector<FakeTensor>& tensors, HashFunc hash) {
+  volatile uint64_t sink = 0;
+  auto begin = std::chrono::steady_clock::now();
+  for (int round = 0; round < kRounds; round++) {
+    sink = sink + hash(tensors);
+  }
+  double elapsed = std::chrono::duration<double, std::nano>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+  return elapsed / (static_cast<double>(kRounds) * tensors.size());
+}
+
+} // namespace
+
+TEST(OpApiHashBenchmark, ForeachTensorLists) {
+  LegacyBuf legacy;
+  OpApiHasher hasher;
+  auto legacyHash = [&](const std::vector<FakeTensor>& t) {
+    return legacy.Hash(t);
+  };
+  auto streamHash = [&](const std::vector<FakeTensor>& t) {
+    return StreamHash(hasher, t);
+  };
+
+  for (int num : {1, 8, 64, 128, 512, 2048}) {
+    auto tensors = MakeTensorList(num);
+    bool legacyKeyed = legacy.Hash(tensors) != 0;
+    uint64_t key = StreamHash(hasher, tensors);
+    double legacyNs = NsPerTensor(tensors, legacyHash);
+    double streamNs = NsPerTensor(tensors, streamHash);
+    printf(
+        "[OpApiHashBenchmark] %4d tensors: buffer %.1f ns/tensor%s, "
+        "streaming %.1f ns/tensor\n",
+        num,
+        legacyNs,
+        legacyKeyed ? "" : " (no key)",
+        streamNs);
+
+    ASSERT_NE(key, 0);
+    EXPECT_EQ(key, StreamHash(hasher, tensors));
+    tensors.back().sizes[0]++;
+    EXPECT_NE(key, StreamHash(hasher, tensors));
+  }
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <memory>
+
+#include "framework/OpParamMaker.h"
+
+// Measures exporting an op's params and releasing their pointer arrays the
+// way a queued op does: ExportParams on the launching thread, a copy into the
+// task ring, a copy into the release ring and the final release. Descriptors
+// are fake pointers that are never dereferenced, only the bookkeeping around
+// them is timed.
+
+namespace {
+
+using at_npu::native::ExecuteParas;
+using at_npu::native::OpCommandImpl;
+
+constexpr int kIterations = 200 * 1000;
+
+const aclTensorDesc* FakeDesc(int i) {
+  return reinterpret_cast<const aclTensorDesc*>(
+      static_cast<uintptr_t>(0x1000 + i * 16));
+}
+
+aclDataBuffer* FakeBuffer(int i) {
+  return reinterpret_cast<aclDataBuffer*>(
+      static_cast<uintptr_t>(0x2000 + i * 16));
+}
+
+} // namespace
+
+TEST(OpParamMakerBenchmark, ExportAndReleaseParams) {
+  auto taskSlot = std::make_unique<ExecuteParas>();
+  auto releaseSlot = std::make_unique<ExecuteParas>();
+  OpCommandImpl cmd;
+
+  for (int inputNum : {1, 2, 4, 8, 16, 31}) {
+    bool inlined = false;
+    auto begin = std::chrono::steady_clock::now();
+    for (int iter = 0; iter < kIterations; iter++) {
+      cmd.SetName("Add");
+      for (int i = 0; i < inputNum; i++) {
+        cmd.AddInput(FakeDesc(i), FakeBuffer(i));
+      }
+      cmd.AddOutput(FakeDesc(inputNum), FakeBuffer(inputNum));
+
+      ExecuteParas params;
+      cmd.ExportParams(params);
+      cmd.releaseSource(false);
+      taskSlot->Copy(params);
+      releaseSlot->CopyEx(*taskSlot);
+
+      ASSERT_EQ(releaseSlot->paras.input_num, inputNum);
+      ASSERT_EQ(
+          releaseSlot->paras.input_desc[inputNum - 1], FakeDesc(inputNum - 1));
+      ASSERT_EQ(releaseSlot->paras.output_data_buf[0], FakeBuffer(inputNum));
+      inlined = releaseSlot->IsInlineParams();
+
+      // Descriptors are fake, only release the pointer arrays.
+      releaseSlot->paras.input_num = 0;
+      releaseSlot->paras.output_num = 0;
+      at_npu::native::DestroyAclParams(
+          releaseSlot->paras, !releaseSlot->IsInlineParams());
+    }
+    auto elapsed = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+    printf(
+        "[OpParamMakerBenchmark] inputs=%d inline=%d: %.2f Mops/s\n",
+        inputNum,
+        inlined,
+        kIterations / elapsed / 1e6);
+    EXPECT_TRUE(inlined);
+  }
+}
@@ -0,0 +1,59 @@
+#include <gtest/gtest.h>
+
+#include "csrc/backend/NPUContext.h"
+#include "framework/utils/ScalarConstantCache.h"
+
+using at_npu::native::ScalarConstantCache;
+using at_npu::native::ScalarConstantKey;
+using at_npu::native::ScalarConstantKeyHash;
+
+namespace {
+
+ScalarConstantKey MakeKey(const c10::Scalar& scalar, at::ScalarType type) {
+  ScalarConstantKey key;
+  EXPECT_TRUE(ScalarConstantCache::MakeKey(scalar, type, 0, &key));
+  return key;
+}
+
+} // namespace
+
+TEST(ScalarConstantCacheTest, TestKey) {
+  EXPECT_EQ(MakeKey(1.0, at::kFloat), MakeKey(1.0, at::kFloat));
+  EXPECT_EQ(
+      ScalarConstantKeyHash()(MakeKey(0.9, at::kFloat)),
+      ScalarConstantKeyHash()(MakeKey(0.9, at::kFloat)));
+  EXPECT_FALSE(MakeKey(1.0, at::kFloat) == MakeKey(1.0, at::kHalf));
+  EXPECT_FALSE(MakeKey(1.0, at::kFloat) == MakeKey(int64_t(1), at::kFloat));
+  EXPECT_FALSE(MakeKey(true, at::kFloat) == MakeKey(int64_t(1), at::kFloat));
+  // Values are compared bit for bit.
+  EXPECT_FALSE(MakeKey(0.0, at::kFloat) == MakeKey(-0.0, at::kFloat));
+
+  ScalarConstantKey key;
+  EXPECT_FALSE(ScalarConstantCache::MakeKey(
+      c10::complex<double>(1.0, 1.0), at::kComplexFloat, 0, &key));
+}
+
+TEST(ScalarConstantCacheTest, TestReuseAndInvalidation) {
+  if (!c10::backend::is_available()) {
+    GTEST_SKIP() << "NPU is not available";
+  }
+
+  ScalarConstantCache cache(2);
+  at::Tensor one = cache.Get(1.0, at::kFloat);
+  EXPECT_TRUE(cache.Get(1.0, at::kFloat).is_same(one));
+  EXPECT_EQ(cache.GetStats().hits, 1u);
+
+  // A tensor written to in place is not handed out again.
+  one.add_(1);
+  at::Tensor fresh = cache.Get(1.0, at::kFloat);
+  EXPECT_FALSE(fresh.is_same(one));
+  EXPECT_EQ(fresh.item<float>(), 1.0f);
+  EXPECT_EQ(cache.GetStats().invalidations, 1u);
+
+  // The least recently used entry is evicted.
+  cache.Get(0.9, at::kFloat);
+  EXPECT_EQ(cache.Get(0.999, at::kFloat).item<float>(), 0.999f);
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.entries, 2u);
+  EXPECT_EQ(stats.evictions, 1u);
+}
@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "acl/include/acl/acl_rt.h"
+#include "aten/common/ScalarReadback.h"
+#include "core/NPUException.h"
+#include "csrc/backend/NPUContext.h"
+#include "csrc/backend/NPUFunctions.h"
+#include "csrc/backend/NPUStream.h"
+#include "framework/utils/CalcuOpUtil.h"
+
+// Runs training-like steps that read back N scalars each, e.g. a loss, a
+// gradient norm and early exit flags, and reports the step time when each
+// scalar synchronizes the stream and copies synchronously (the previous
+// _local_scalar_dense), when each goes through .item(), and when all of them
+// are read back by one ScalarReadback.
+
+namespace {
+
+using at_npu::native::ScalarReadback;
+
+constexpr int kSteps = 50;
+constexpr int64_t kWorkSize = int64_t(1) << 22;
+
+float LegacyItem(const at::Tensor& tensor) {
+  float value = 0;
+  c10::backend::NPUStream stream = c10::backend::getCurrentNPUStream();
+  c10::npu::DrainTaskQueue(stream.device_index());
+  NPU_CHECK_ERROR(aclrtSynchronizeStreamWithTimeout(stream, -1));
+  NPU_CHECK_ERROR(at_npu::native::CalcuOpUtil::AclrtMemcpyWithModeSwitch(
+      &value,
+      sizeof(float),
+      std::make_pair(
+          tensor.storage().unsafeGetStorageImpl(),
+          tensor.storage_offset() * tensor.itemsize()),
+      sizeof(float),
+      ACL_MEMCPY_DEVICE_TO_HOST));
+  return value;
+}
+
+// Returns the average step time in microseconds.
+template <typename ReadFunc>
+double TimeSteps(int scalars, ReadFunc read) {
+  auto options = at::TensorOptions()
+                     .device(c10::DeviceType::PrivateUse1)
+                     .dtype(at::kFloat);
+  at::Tensor work = at::ones({kWorkSize}, options);
+  std::vector<at::Tensor> values;
+  auto run_step = [&]() {
+    values.clear();
+    for (int i = 0; i < scalars; i++) {
+      work = work * 1.0001;
+      values.push_back(work.sum());
+    }
+    read(values);
+  };
+  run_step();
+  c10::backend::device_synchronize();
+
+  auto begin = std::chrono::steady_clock::now();
+  for (int step = 0; step < kSteps; step++) {
+    run_step();
+  }
+  c10::backend::device_synchronize();
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - begin)
+             .count() /
+      kSteps;
+}
+
+} // namespace
+
+TEST(ScalarReadbackBenchmark, ScalarsPerStep) {
+  if (!c10::backend::is_available()) {
+    GTEST_SKIP() << "NPU is not available";
+  }
+
+  for (int scalars : {1, 4, 16}) {
+    double legacy = TimeSteps(scalars, [](const std::vector<at::Tensor>& ts) {
+      for (const auto& t : ts) {
+        LegacyItem(t);
+      }
+    });
+    double item = TimeSteps(scalars, [](const std::vector<at::Tensor>& ts) {
+      for (const auto& t : ts) {
+        t.item<float>();
+      }
+    });
+    double batched = TimeSteps(scalars, [](const std::vector<at::Tensor>& ts) {
+      ScalarReadback readback;
+      for (const auto& t : ts) {
+        readback.add(t);
+      }
+      auto results = readback.wait();
+      EXPECT_EQ(results.size(), ts.size());
+    });
+    printf(
+        "[ScalarReadbackBenchmark] %d scalars per step: legacy=%.1f us "
+        "item=%.1f us batched=%.1f us\n",
+        scalars,
+        legacy,
+        item,
+        batched);
+  }
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "csrc/backend/NPUFunctions.h"
+#include "csrc/backend/NPUStream.h"
+
+// Checks that streams reserved for a workload are returned round-robin by
+// getStreamForWorkload and never by getStreamFromPool, and that pooled
+// streams run with the priority of the default stream.
+
+TEST(StreamAffinityTest, TestReservedStreams) {
+  if (!c10::backend::is_available()) {
+    GTEST_SKIP() << "NPU is not available";
+  }
+
+  c10::backend::reserveWorkloadStreams("stream_affinity_test.h2d", 4);
+  std::set<c10::StreamId> reserved;
+  for (int i = 0; i < 8; i++) {
+    auto stream =
+        c10::backend::getStreamForWorkload("stream_affinity_test.h2d");
+    EXPECT_EQ(stream.priority(), 0);
+    reserved.insert(stream.id());
+  }
+  EXPECT_EQ(reserved.size(), size_t(4));
+
+  for (int i = 0; i < 64; i++) {
+    auto stream = c10::backend::getStreamFromPool(false);
+    EXPECT_EQ(reserved.count(stream.id()), size_t(0));
+  }
+
+  // Reserving again with the same arguments does nothing, but the pool
+  // handed out streams so no other reservation can be taken from it.
+  c10::backend::reserveWorkloadStreams("stream_affinity_test.h2d", 4);
+  EXPECT_THROW(
+      c10::backend::reserveWorkloadStreams("stream_affinity_test.h2d", 2),
+      c10::Error);
+  EXPECT_THROW(
+      c10::backend::reserveWorkloadStreams("stream_affinity_test.d2h", 1),
+      c10::Error);
+}
+
+TEST(StreamAffinityTest, TestHighPriorityReservation) {
+  if (!c10::backend::is_available()) {
+    GTEST_SKIP() << "NPU is not available";
+  }
+
+  c10::backend::reserveWorkloadStreams(
+      "stream_affinity_test.allreduce", 2, /*isHighPriority=*/true);
+  auto stream =
+      c10::backend::getStreamForWorkload("stream_affinity_test.allreduce");
+  EXPECT_EQ(stream.priority(), 0);
+  EXPECT_NE(stream.stream(), nullptr);
+}
+
+TEST(StreamAffinityTest, TestInvalidReservations) {
+  if (!c10::backend::is_available()) {
+    GTEST_SKIP() << "NPU is not available";
+  }
+
+  EXPECT_THROW(
+      c10::backend::reserveWorkloadStreams("stream_affinity_test.all", 4096),
+      c10::Error);
+  EXPECT_THROW(
+      c10::backend::getStreamForWorkload("stream_affinity_test.unknown"),
+      c10::Error);
+}
+
+TEST(StreamAffinityTest, TestPriorities) {
+  if (!c10::backend::is_available()) {
+    GTEST_SKIP() << "NPU is not available";
+  }
+
+  auto [least, greatest] = c10::backend::NPUStream::priority_range();
+  EXPECT_EQ(least, 0);
+  EXPECT_EQ(greatest, 0);
+  c10::backend::NPUStream low = c10::backend::getStreamFromPool(false);
+  c10::backend::NPUStream high = c10::backend::getStreamFromPool(true);
+  EXPECT_EQ(low.priority(), least);
+  EXPECT_EQ(high.priority(), greatest);
+  EXPECT_NE(high.stream(), low.stream());
+  EXPECT_EQ(c10::backend::getDefaultNPUStream().priority(), 0);
+}
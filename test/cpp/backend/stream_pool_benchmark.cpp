@@ -0,0 +1,73 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "acl/include/acl/acl_rt.h"
+#include "core/NPUException.h"
+#include "csrc/backend/NPUFunctions.h"
+#include "csrc/backend/NPUStream.h"
+
+// Reports the time the first pooled stream takes to be ready on a device,
+// against creating both pools up front as the pool used to.
+
+namespace {
+
+// Default size of the pools, see NPU_STREAMS_PER_POOL.
+constexpr int kStreamsPerPool = 32;
+
+double ElapsedUs(std::chrono::steady_clock::time_point begin) {
+  return std::chrono::duration<double, std::micro>(
+             std::chrono::steady_clock::now() - begin)
+      .count();
+}
+
+// Creates and destroys every stream of the low and high priority pools.
+double TimeEagerPools() {
+  std::vector<aclrtStream> streams;
+  auto begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < kStreamsPerPool; i++) {
+    for (int p = 0; p < c10::backend::max_compile_time_stream_priorities;
+         p++) {
+      aclrtStream stream = nullptr;
+      NPU_CHECK_ERROR(aclrtCreateStreamWithConfig(
+          &stream, 0, (ACL_STREAM_FAST_LAUNCH | ACL_STREAM_FAST_SYNC)));
+      streams.push_back(stream);
+    }
+  }
+  double elapsed = ElapsedUs(begin);
+  for (aclrtStream stream : streams) {
+    NPU_CHECK_ERROR(aclrtDestroyStreamForce(stream));
+  }
+  return elapsed;
+}
+
+} // namespace
+
+TEST(StreamPoolBenchmark, FirstStreamLatency) {
+  if (!c10::backend::is_available()) {
+    GTEST_SKIP() << "NPU is not available";
+  }
+
+  // Only the stream returned is created, not the rest of its pool.
+  auto begin = std::chrono::steady_clock::now();
+  c10::backend::NPUStream first = c10::backend::getStreamFromPool(false);
+  EXPECT_NE(first.stream(), nullptr);
+  double lazy = ElapsedUs(begin);
+
+  // Streams already created only cost the lookup.
+  begin = std::chrono::steady_clock::now();
+  for (int i = 0; i < 1000; i++) {
+    first.stream();
+  }
+  double hit = ElapsedUs(begin) / 1000;
+
+  double eager = TimeEagerPools();
+  printf(
+      "[StreamPoolBenchmark] first pooled stream: lazy=%.1f us eager=%.1f us, "
+      "created stream lookup=%.3f us\n",
+      lazy,
+      eager,
+      hit);
+}
@@ -0,0 +1,219 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "backends/fake/AllocatorTraceReplay.h"
+#include "csrc/core/allocator/AllocatorTrace.h"
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Round trips allocator traces through the binary format and replays them
+// under different allocator settings. Set ALLOCATOR_TRACE_FILE to a trace
+// dumped by torch_backend.backend.memory._dump_allocator_trace to tune the
+// settings for it. ALLOCATOR_TRACE_SETTINGS overrides the ';' separated list
+// of settings tried and ALLOCATOR_TRACE_DEVICE_GB the simulated device memory,
+// 32 GB by default. The trace may use at most kTestDevices devices.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+using c10::backend::CachingAllocator::TraceEntry;
+using c10::backend::CachingAllocator::TraceRecord;
+using c10::backend::fake::HostCachingAllocatorHelper;
+using c10::backend::fake::ReplayOptions;
+using c10::backend::fake::ReplayResult;
+using c10::backend::test::kTestDevices;
+using c10::backend::test::kTestDeviceTotal;
+
+const char* const kSettings[] = {
+    "",
+    "expandable_segments:False",
+    "max_split_size_mb:200",
+    "expandable_segments:False,roundup_power2_divisions:4",
+    "expandable_segments:False,roundup_power2_divisions:[64:8,512:4,>:2]",
+    "garbage_collection_threshold:0.6",
+};
+
+TraceRecord MakeRecord(TraceEntry::Action action, int64_t addr, int64_t size) {
+  TraceRecord record{};
+  record.action = static_cast<uint8_t>(action);
+  record.addr = addr;
+  record.size = size;
+  return record;
+}
+
+// Requests of random batch size and prompt length, whose KV cache is kept
+// until the request finishes. Addresses only need to be unique while alive.
+std::vector<TraceRecord> VariableBatchTrace(int requests) {
+  constexpr int64_t H = 1024, L = 12, E = 2;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<int64_t> batchDist(1, 16);
+  std::uniform_int_distribution<int64_t> seqDist(16, 512);
+
+  std::vector<TraceRecord> trace;
+  int64_t next_addr = 0;
+  auto alloc = [&](int64_t size) {
+    trace.push_back(MakeRecord(TraceEntry::ALLOC, ++next_addr, size));
+    return next_addr;
+  };
+  auto release = [&](int64_t addr) {
+    trace.push_back(MakeRecord(TraceEntry::FREE_REQUESTED, addr, 0));
+  };
+  for (int r = 0; r < requests; r++) {
+    int64_t tokens = batchDist(gen) * seqDist(gen);
+    std::vector<int64_t> kv;
+    int64_t hidden = alloc(tokens * H * E);
+    for (int64_t l = 0; l < L; l++) {
+      kv.push_back(alloc(2 * tokens * H * E));
+      int64_t ffn = alloc(4 * tokens * H * E);
+      int64_t out = alloc(tokens * H * E);
+      release(ffn);
+      release(hidden);
+      hidden = out;
+    }
+    release(hidden);
+    for (int64_t addr : kv) {
+      release(addr);
+    }
+  }
+  return trace;
+}
+
+class AllocatorTraceReplayTest
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  static ReplayResult replay(
+      HostCachingAllocatorHelper& helper,
+      const std::vector<TraceRecord>& trace,
+      const std::string& settings) {
+    ReplayOptions options;
+    options.settings = settings;
+    if (settings.find("garbage_collection_threshold") != std::string::npos) {
+      options.memory_fraction = 1.0;
+    }
+    auto result = c10::backend::fake::replayTrace(helper, trace, options);
+    printf(
+        "[AllocatorTraceReplay] \"%s\": %ld allocs, %ld segments, "
+        "peak allocated %.1f MiB, peak reserved %.1f MiB, %zu OOMs, "
+        "alloc %.1f ns, free %.1f ns, total %.1f ms\n",
+        settings.c_str(),
+        static_cast<long>(result.allocs),
+        static_cast<long>(result.segment_allocs),
+        result.peak_allocated_bytes / 1048576.0,
+        result.peak_reserved_bytes / 1048576.0,
+        result.ooms.size(),
+        result.allocs ? result.alloc_ns / result.allocs : 0.0,
+        result.frees ? result.free_ns / result.frees : 0.0,
+        result.elapsed_ms);
+    for (const auto& oom : result.ooms) {
+      printf(
+          "[AllocatorTraceReplay]   OOM at record %zu: %ld bytes on device "
+          "%d, %.1f MiB allocated, %.1f MiB reserved\n",
+          oom.record,
+          static_cast<long>(oom.size),
+          static_cast<int>(oom.device),
+          oom.allocated_bytes / 1048576.0,
+          oom.reserved_bytes / 1048576.0);
+    }
+    EXPECT_EQ(helper.getStats().used_bytes, 0);
+    return result;
+  }
+};
+
+} // namespace
+
+TEST_F(AllocatorTraceReplayTest, TestDumpAndLoad) {
+  int streams[2];
+  CachingAllocator::SnapshotInfo snapshot;
+  snapshot.device_traces.resize(2);
+  snapshot.device_traces[0].emplace_back(
+      TraceEntry::ALLOC, 0, 0x1000, 512, &streams[0]);
+  snapshot.device_traces[0].emplace_back(
+      TraceEntry::SNAPSHOT, 0, 512, 0, nullptr);
+  snapshot.device_traces[0].emplace_back(
+      TraceEntry::FREE_REQUESTED, 0, 0x1000, 512, &streams[0]);
+  snapshot.device_traces[1].emplace_back(
+      TraceEntry::OOM, 1, 4096, int64_t(1) << 40, &streams[1]);
+
+  std::string path = ::testing::TempDir() + "allocator_trace.bin";
+  CachingAllocator::dumpTrace(path, snapshot);
+  auto trace = CachingAllocator::loadTrace(path);
+  std::remove(path.c_str());
+
+  ASSERT_EQ(trace.size(), 3);
+  EXPECT_EQ(trace[0].action, TraceEntry::ALLOC);
+  EXPECT_EQ(trace[0].addr, 0x1000);
+  EXPECT_EQ(trace[0].size, 512);
+  EXPECT_EQ(trace[1].action, TraceEntry::FREE_REQUESTED);
+  EXPECT_EQ(trace[1].stream, trace[0].stream);
+  EXPECT_EQ(trace[2].action, TraceEntry::OOM);
+  EXPECT_EQ(trace[2].device, 1);
+  EXPECT_EQ(trace[2].addr, 4096);
+  EXPECT_EQ(trace[2].size, int64_t(1) << 40);
+  EXPECT_NE(trace[2].stream, trace[0].stream);
+}
+
+TEST_F(AllocatorTraceReplayTest, TestReplayUnderSettings) {
+  auto trace = VariableBatchTrace(100);
+  int64_t allocs = 0;
+  for (const auto& record : trace) {
+    allocs += record.action == TraceEntry::ALLOC;
+  }
+  for (const char* settings : kSettings) {
+    auto result = replay(*helper_, trace, settings);
+    EXPECT_EQ(result.allocs, allocs);
+    EXPECT_EQ(result.frees, allocs);
+    EXPECT_TRUE(result.ooms.empty());
+    EXPECT_LE(result.peak_allocated_bytes, result.peak_reserved_bytes);
+  }
+}
+
+TEST_F(AllocatorTraceReplayTest, TestOutOfMemory) {
+  const int64_t size = int64_t(kTestDeviceTotal / 2) + 1;
+  std::vector<TraceRecord> trace = {
+      MakeRecord(TraceEntry::ALLOC, 1, size),
+      MakeRecord(TraceEntry::ALLOC, 2, size),
+      MakeRecord(TraceEntry::FREE_REQUESTED, 2, 0),
+      MakeRecord(TraceEntry::ALLOC, 3, 1024),
+  };
+  auto result = replay(*helper_, trace, "expandable_segments:False");
+  EXPECT_EQ(result.allocs, 2);
+  EXPECT_EQ(result.frees, 0);
+  ASSERT_EQ(result.ooms.size(), 1);
+  EXPECT_EQ(result.ooms[0].record, 1);
+  EXPECT_EQ(result.ooms[0].size, size);
+  EXPECT_GE(result.ooms[0].allocated_bytes, size);
+}
+
+TEST_F(AllocatorTraceReplayTest, TestReplayFile) {
+  const char* path = getenv("ALLOCATOR_TRACE_FILE");
+  if (path == nullptr) {
+    GTEST_SKIP() << "ALLOCATOR_TRACE_FILE is not set";
+  }
+  auto trace = CachingAllocator::loadTrace(path);
+  for (const auto& record : trace) {
+    ASSERT_LT(record.device, kTestDevices);
+  }
+  if (const char* env = getenv("ALLOCATOR_TRACE_DEVICE_GB")) {
+    helper_->setDeviceTotal(std::stoull(env) << 30);
+  }
+
+  std::vector<std::string> settings(std::begin(kSettings), std::end(kSettings));
+  if (const char* env = getenv("ALLOCATOR_TRACE_SETTINGS")) {
+    settings.clear();
+    std::stringstream list(env);
+    std::string item;
+    while (std::getline(list, item, ';')) {
+      settings.push_back(item);
+    }
+  }
+  for (const auto& item : settings) {
+    replay(*helper_, trace, item);
+  }
+  helper_->setDeviceTotal(kTestDeviceTotal);
+}
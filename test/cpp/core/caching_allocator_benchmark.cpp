@@ -0,0 +1,255 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Replays allocation traces of typical workloads through the caching
+// allocator on top of the host helper, so its policies can be measured
+// without a device. Reports alloc and free latency, peak reserved against
+// peak allocated bytes, the fragmentation that gap amounts to and how many
+// allocations were served from cached memory. The small allocation benchmark
+// compares the per-thread block cache with the device allocator path.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+constexpr size_t kAggregate =
+    static_cast<size_t>(CachingAllocator::StatType::AGGREGATE);
+
+struct TraceOp {
+  bool alloc;
+  size_t id;
+  size_t size;
+};
+
+class Trace {
+ public:
+  size_t alloc(size_t size) {
+    ops_.push_back({true, num_ids_, size});
+    return num_ids_++;
+  }
+
+  void free(size_t id) {
+    ops_.push_back({false, id, 0});
+  }
+
+  const std::vector<TraceOp>& ops() const {
+    return ops_;
+  }
+
+  size_t numIds() const {
+    return num_ids_;
+  }
+
+ private:
+  std::vector<TraceOp> ops_;
+  size_t num_ids_ = 0;
+};
+
+// fp16 GPT-style model: 12 layers, hidden 1024, 16 heads, batch 4 x 512
+// tokens. Activations are kept for backward, weight gradients live until the
+// optimizer step, which needs a temporary per gradient.
+Trace TrainingSteps(int steps) {
+  constexpr size_t B = 4, S = 512, H = 1024, N = 16, L = 12, V = 32000;
+  constexpr size_t E = 2;
+  constexpr size_t act = B * S * H * E;
+  constexpr size_t scores = B * N * S * S * E;
+  constexpr size_t layerWeights = 12 * H * H * E;
+
+  Trace trace;
+  for (int step = 0; step < steps; step++) {
+    std::vector<size_t> saved;
+    for (size_t l = 0; l < L; l++) {
+      saved.push_back(trace.alloc(3 * act));
+      size_t raw = trace.alloc(scores);
+      saved.push_back(trace.alloc(scores));
+      trace.free(raw);
+      saved.push_back(trace.alloc(act));
+      saved.push_back(trace.alloc(4 * act));
+      saved.push_back(trace.alloc(B * S));
+      saved.push_back(trace.alloc(act));
+    }
+    size_t logits = trace.alloc(B * S * V * E);
+    size_t loss = trace.alloc(E);
+    trace.free(logits);
+
+    std::vector<size_t> grads;
+    size_t grad = trace.alloc(act);
+    for (size_t l = 0; l < L; l++) {
+      grads.push_back(trace.alloc(layerWeights));
+      grads.push_back(trace.alloc(H * E));
+      for (int i = 0; i < 6; i++) {
+        trace.free(saved.back());
+        saved.pop_back();
+      }
+      size_t next = trace.alloc(act);
+      trace.free(grad);
+      grad = next;
+    }
+    trace.free(grad);
+    trace.free(loss);
+
+    for (size_t id : grads) {
+      size_t tmp = trace.alloc(layerWeights);
+      trace.free(tmp);
+      trace.free(id);
+    }
+  }
+  return trace;
+}
+
+// Requests of random batch size and prompt length against the same model,
+// the KV cache of a request is kept until it finishes.
+Trace VariableBatchInference(int requests) {
+  constexpr size_t H = 1024, N = 16, L = 12, E = 2;
+  std::mt19937 gen(0);
+  std::uniform_int_distribution<size_t> batchDist(1, 16);
+  std::uniform_int_distribution<size_t> seqDist(16, 512);
+
+  Trace trace;
+  for (int r = 0; r < requests; r++) {
+    size_t b = batchDist(gen);
+    size_t s = seqDist(gen);
+    std::vector<size_t> kv;
+    size_t hidden = trace.alloc(b * s * H * E);
+    for (size_t l = 0; l < L; l++) {
+      kv.push_back(trace.alloc(2 * b * s * H * E));
+      size_t scores = trace.alloc(b * N * s * s * E);
+      size_t ctx = trace.alloc(b * s * H * E);
+      trace.free(scores);
+      size_t ffn = trace.alloc(4 * b * s * H * E);
+      trace.free(ctx);
+      size_t out = trace.alloc(b * s * H * E);
+      trace.free(ffn);
+      trace.free(hidden);
+      hidden = out;
+    }
+    trace.free(hidden);
+    for (size_t id : kv) {
+      trace.free(id);
+    }
+  }
+  return trace;
+}
+
+class CachingAllocatorBenchmark
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  // Runs the traces under the settings of the environment.
+  std::string settings() const override {
+    const char* env = getenv("PYTORCH_ALLOC_CONF");
+    return env != nullptr ? env : "";
+  }
+
+  void replay(const char* name, const Trace& trace) {
+    void* stream = helper_->getCurrentStream(0);
+    std::vector<void*> ptrs(trace.numIds(), nullptr);
+    double allocNs = 0;
+    double freeNs = 0;
+    size_t allocs = 0;
+    size_t hits = 0;
+    for (const auto& op : trace.ops()) {
+      if (op.alloc) {
+        int64_t before = helper_->deviceAllocations();
+        auto begin = std::chrono::steady_clock::now();
+        ptrs[op.id] = CachingAllocator::raw_alloc_with_stream(op.size, stream);
+        allocNs += std::chrono::duration<double, std::nano>(
+                       std::chrono::steady_clock::now() - begin)
+                       .count();
+        allocs++;
+        hits += helper_->deviceAllocations() == before;
+      } else {
+        auto begin = std::chrono::steady_clock::now();
+        CachingAllocator::raw_delete(ptrs[op.id]);
+        freeNs += std::chrono::duration<double, std::nano>(
+                      std::chrono::steady_clock::now() - begin)
+                      .count();
+      }
+    }
+
+    auto stats = CachingAllocator::getDeviceStats(0);
+    double peakAllocated = stats.allocated_bytes[kAggregate].peak;
+    double peakReserved = stats.reserved_bytes[kAggregate].peak;
+    printf(
+        "[CachingAllocatorBenchmark] %s: %zu allocs, alloc %.1f ns, "
+        "free %.1f ns, peak allocated %.1f MiB, peak reserved %.1f MiB, "
+        "fragmentation %.1f%%, cache hits %.1f%%\n",
+        name,
+        allocs,
+        allocNs / allocs,
+        freeNs / allocs,
+        peakAllocated / (1 << 20),
+        peakReserved / (1 << 20),
+        100.0 * (1.0 - peakAllocated / peakReserved),
+        100.0 * hits / allocs);
+
+    EXPECT_EQ(stats.allocated_bytes[kAggregate].current, 0);
+    EXPECT_LE(peakAllocated, peakReserved);
+    CachingAllocator::emptyCache();
+    EXPECT_EQ(helper_->getStats().used_bytes, 0);
+  }
+
+  // Scalars and shape tensors of 4 bytes to 4 KB, up to 32 alive at once.
+  void smallAllocs(const char* settings) {
+    constexpr int kIters = 1000000;
+    constexpr int kLive = 32;
+    CachingAllocator::setAllocatorSettings(settings);
+    CachingAllocator::resetAccumulatedStats(0);
+    void* stream = helper_->getCurrentStream(0);
+    std::mt19937 gen(0);
+    std::uniform_int_distribution<size_t> sizeDist(4, 4096);
+    std::vector<size_t> sizes(kIters);
+    for (auto& size : sizes) {
+      size = sizeDist(gen);
+    }
+
+    std::vector<void*> live(kLive, nullptr);
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIters; i++) {
+      void*& slot = live[i % kLive];
+      CachingAllocator::raw_delete(slot);
+      slot = CachingAllocator::raw_alloc_with_stream(sizes[i], stream);
+    }
+    for (void* ptr : live) {
+      CachingAllocator::raw_delete(ptr);
+    }
+    double ns = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - begin)
+                    .count();
+
+    auto stats = CachingAllocator::getDeviceStats(0);
+    int64_t lookups = stats.thread_cache_hits + stats.thread_cache_misses;
+    printf(
+        "[CachingAllocatorBenchmark] small allocs \"%s\": %.1f ns per "
+        "alloc+free, thread cache hits %.1f%%\n",
+        settings,
+        ns / kIters,
+        lookups ? 100.0 * stats.thread_cache_hits / lookups : 0.0);
+
+    EXPECT_EQ(stats.allocated_bytes[kAggregate].current, 0);
+    EXPECT_EQ(stats.requested_bytes[kAggregate].current, 0);
+    CachingAllocator::emptyCache();
+    EXPECT_EQ(helper_->getStats().used_bytes, 0);
+    CachingAllocator::setAllocatorSettings(settings());
+  }
+};
+
+} // namespace
+
+TEST_F(CachingAllocatorBenchmark, TransformerTraining) {
+  replay("training", TrainingSteps(20));
+}
+
+TEST_F(CachingAllocatorBenchmark, VariableBatchInference) {
+  replay("inference", VariableBatchInference(200));
+}
+
+TEST_F(CachingAllocatorBenchmark, SmallAllocations) {
+  smallAllocs("");
+  smallAllocs("thread_cache_size_kb:1024");
+}
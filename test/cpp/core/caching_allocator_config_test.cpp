@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Checks the parsing of the size class and rounding settings, their effect on
+// allocations, and that rejected settings leave the ones in use unchanged.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+
+constexpr size_t kAggregate =
+    static_cast<size_t>(CachingAllocator::StatType::AGGREGATE);
+constexpr size_t kLarge =
+    static_cast<size_t>(CachingAllocator::StatType::LARGE_POOL);
+
+class CachingAllocatorConfigTest
+    : public c10::backend::test::CachingAllocatorTest {};
+
+} // namespace
+
+TEST_F(CachingAllocatorConfigTest, TestSizeClassSettings) {
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:False,roundup_power2_divisions:[64:8,512:4,>:2],"
+      "small_size_kb:512,large_buffer_mb:32,round_large_mb:4");
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.small_size, 512 << 10);
+  EXPECT_EQ(stats.large_buffer, 32 << 20);
+  EXPECT_EQ(stats.round_large, 4 << 20);
+  ASSERT_EQ(stats.roundup_power2_divisions.size(), 16u);
+  EXPECT_EQ(stats.roundup_power2_divisions[0], 8);
+  EXPECT_EQ(stats.roundup_power2_divisions[6], 8);
+  EXPECT_EQ(stats.roundup_power2_divisions[7], 0);
+  EXPECT_EQ(stats.roundup_power2_divisions[9], 4);
+  EXPECT_EQ(stats.roundup_power2_divisions[10], 2);
+  EXPECT_EQ(stats.roundup_power2_divisions[15], 2);
+
+  // 5 MB is in the [4, 8) MB interval, which is rounded to eighths.
+  void* ptr = CachingAllocator::raw_alloc(5000000);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.allocated_bytes[kAggregate].current, (4 << 20) + (1 << 20));
+  EXPECT_EQ(stats.reserved_bytes[kAggregate].current, 32 << 20);
+  CachingAllocator::raw_delete(ptr);
+
+  // Above small_size_kb, allocations go to the large pool.
+  ptr = CachingAllocator::raw_alloc(600 << 10);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.allocation[kLarge].current, 1);
+  CachingAllocator::raw_delete(ptr);
+
+  CachingAllocator::emptyCache();
+  CachingAllocator::setAllocatorSettings("");
+  EXPECT_EQ(CachingAllocator::getDeviceStats(0).small_size, 1 << 20);
+}
+
+TEST_F(CachingAllocatorConfigTest, TestRejectedSettingsKeepConfig) {
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:False,roundup_power2_divisions:4,"
+      "small_size_kb:512,large_buffer_mb:32,round_large_mb:4");
+
+  // Rejected while parsing, after valid options.
+  EXPECT_THROW(
+      CachingAllocator::setAllocatorSettings(
+          "small_size_kb:256,roundup_power2_divisions:3"),
+      c10::Error);
+  EXPECT_THROW(
+      CachingAllocator::setAllocatorSettings(
+          "large_buffer_mb:64,roundup_power2_divisions:[64:8,128:3]"),
+      c10::Error);
+  EXPECT_THROW(
+      CachingAllocator::setAllocatorSettings("round_large_mb:8,unknown:1"),
+      c10::Error);
+  // Rejected by the checks across options, once all of them are parsed.
+  EXPECT_THROW(
+      CachingAllocator::setAllocatorSettings("small_size_kb:4096"),
+      c10::Error);
+  EXPECT_THROW(
+      CachingAllocator::setAllocatorSettings(
+          "large_buffer_mb:64,max_split_size_mb:32"),
+      c10::Error);
+
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.small_size, 512 << 10);
+  EXPECT_EQ(stats.large_buffer, 32 << 20);
+  EXPECT_EQ(stats.round_large, 4 << 20);
+  ASSERT_EQ(stats.roundup_power2_divisions.size(), 16u);
+  for (int64_t divisions : stats.roundup_power2_divisions) {
+    EXPECT_EQ(divisions, 4);
+  }
+
+  // Allocations still follow the settings in use: 5 MB is rounded to a
+  // quarter of the [4, 8) MB interval and packed in a 32 MB buffer.
+  void* ptr = CachingAllocator::raw_alloc(5000000);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.allocated_bytes[kAggregate].current, 6 << 20);
+  EXPECT_EQ(stats.reserved_bytes[kAggregate].current, 32 << 20);
+  CachingAllocator::raw_delete(ptr);
+}
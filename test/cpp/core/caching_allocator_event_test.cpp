@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Checks that blocks freed while used by another stream wait for one event
+// per batch of frees, that the newest event of a stream is queried first and
+// the completed ones are otherwise found by bisection, and that blocks are
+// reused once their event completes.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+using c10::backend::fake::HostStream;
+
+constexpr size_t kAggregate =
+    static_cast<size_t>(CachingAllocator::StatType::AGGREGATE);
+constexpr size_t kSize = 4096;
+// Blocks of a stream that share an event, see kMaxEventBatch.
+constexpr size_t kMaxEventBatch = 32;
+
+class CachingAllocatorEventTest
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  std::string settings() const override {
+    return "expandable_segments:False";
+  }
+
+  void SetUp() override {
+    CachingAllocatorTest::SetUp();
+    side_ = helper_->createStream(0);
+  }
+
+  // Allocates count blocks used by the side stream.
+  std::vector<c10::DataPtr> allocateUsedOnSide(size_t count) {
+    std::vector<c10::DataPtr> ptrs;
+    for (size_t i = 0; i < count; i++) {
+      ptrs.push_back(CachingAllocator::get()->allocate(kSize));
+      CachingAllocator::recordStream(ptrs.back(), side_->stream());
+    }
+    return ptrs;
+  }
+
+  // Allocates and frees a block, which processes the outstanding events.
+  static void processEvents() {
+    CachingAllocator::raw_delete(CachingAllocator::raw_alloc(kSize));
+  }
+
+  HostStream* side_ = nullptr;
+};
+
+} // namespace
+
+TEST_F(CachingAllocatorEventTest, TestNewestBatchFastPath) {
+  auto ptrs = allocateUsedOnSide(3);
+  ptrs.clear();
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.allocation[kAggregate].current, 0);
+  EXPECT_EQ(stats.active[kAggregate].current, 3);
+  EXPECT_EQ(stats.outstanding_events.current, 0);
+
+  // The next malloc records one event for the three frees, which has not
+  // completed yet.
+  processEvents();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.outstanding_events.current, 1);
+  EXPECT_EQ(stats.num_event_queries, 1);
+  EXPECT_EQ(stats.active[kAggregate].current, 3);
+
+  // Once it completes, a single query of the newest event retires all.
+  side_->synchronize();
+  processEvents();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.outstanding_events.current, 0);
+  EXPECT_EQ(stats.num_event_queries, 2);
+  EXPECT_EQ(stats.active[kAggregate].current, 0);
+}
+
+TEST_F(CachingAllocatorEventTest, TestBisection) {
+  // One event per free, since every free is followed by a malloc.
+  auto ptrs = allocateUsedOnSide(4);
+  for (auto& ptr : ptrs) {
+    ptr.clear();
+    processEvents();
+  }
+  CachingAllocator::resetAccumulatedStats(0);
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.outstanding_events.current, 4);
+
+  // The first two events complete: the newest one is queried, then the
+  // events at index 1 and 2 by bisection.
+  side_->complete(2);
+  processEvents();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.num_event_queries, 3);
+  EXPECT_EQ(stats.outstanding_events.current, 2);
+  EXPECT_EQ(stats.active[kAggregate].current, 2);
+
+  side_->synchronize();
+  processEvents();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.num_event_queries, 4);
+  EXPECT_EQ(stats.outstanding_events.current, 0);
+  EXPECT_EQ(stats.active[kAggregate].current, 0);
+}
+
+TEST_F(CachingAllocatorEventTest, TestFullBatchRecordedAtFree) {
+  auto ptrs = allocateUsedOnSide(kMaxEventBatch + 1);
+  ptrs.clear();
+  // The full batch got its event when its last block was freed, without
+  // waiting for the next malloc.
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.outstanding_events.current, 1);
+
+  // So it completes with the work queued before the frees, while the event
+  // of the last block is only recorded by the next malloc.
+  side_->synchronize();
+  processEvents();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.outstanding_events.current, 1);
+  EXPECT_EQ(stats.active[kAggregate].current, 1);
+
+  side_->synchronize();
+  processEvents();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.outstanding_events.current, 0);
+  EXPECT_EQ(stats.active[kAggregate].current, 0);
+}
+
+TEST_F(CachingAllocatorEventTest, TestBlocksReusedAfterEvent) {
+  auto ptrs = allocateUsedOnSide(1);
+  void* ptr = ptrs[0].get();
+  ptrs.clear();
+
+  // Not reused while the side stream may still use it.
+  void* other = CachingAllocator::raw_alloc(kSize);
+  EXPECT_NE(other, ptr);
+
+  side_->synchronize();
+  void* again = CachingAllocator::raw_alloc(kSize);
+  EXPECT_EQ(again, ptr);
+  CachingAllocator::raw_delete(again);
+  CachingAllocator::raw_delete(other);
+}
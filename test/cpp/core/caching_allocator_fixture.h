@@ -0,0 +1,65 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "backends/fake/HostCachingAllocatorHelper.h"
+#include "csrc/core/allocator/CachingAllocator.h"
+
+// Fixture shared by the caching allocator tests and benchmarks. The allocator
+// only ever has one helper and init only adds device allocators, so every
+// suite of a binary runs on the same host helper, registered once.
+
+namespace c10::backend::test {
+
+// Simulated devices and the memory they share.
+constexpr int kTestDevices = 8;
+constexpr size_t kTestDeviceTotal = size_t(32) << 30;
+
+// Never destroyed, the allocator keeps using it until the process exits.
+inline c10::backend::fake::HostCachingAllocatorHelper& allocatorTestHelper() {
+  static c10::backend::fake::HostCachingAllocatorHelper* helper = [] {
+    auto* helper = new c10::backend::fake::HostCachingAllocatorHelper(
+        kTestDeviceTotal, kTestDevices);
+    c10::backend::CachingAllocator::registerHelper(helper);
+    c10::backend::CachingAllocator::init(kTestDevices);
+    return helper;
+  }();
+  return *helper;
+}
+
+// Runs every test from an empty cache with the settings returned by
+// settings(), and restores the default settings and memory fraction after.
+class CachingAllocatorTest : public ::testing::Test {
+ protected:
+  static void SetUpTestSuite() {
+    helper_ = &allocatorTestHelper();
+  }
+
+  static void TearDownTestSuite() {
+    c10::backend::CachingAllocator::emptyCache();
+  }
+
+  virtual std::string settings() const {
+    return "";
+  }
+
+  void SetUp() override {
+    c10::backend::CachingAllocator::setAllocatorSettings(settings());
+    c10::backend::CachingAllocator::emptyCache();
+    c10::backend::CachingAllocator::resetAccumulatedStats(0);
+    c10::backend::CachingAllocator::resetPeakStats(0);
+  }
+
+  void TearDown() override {
+    c10::backend::CachingAllocator::setAllocatorSettings("");
+    c10::backend::CachingAllocator::setMemoryFraction(1.0, 0);
+    c10::backend::CachingAllocator::emptyCache();
+  }
+
+  static inline c10::backend::fake::HostCachingAllocatorHelper* helper_ =
+      nullptr;
+};
+
+} // namespace c10::backend::test
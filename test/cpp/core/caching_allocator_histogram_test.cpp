@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+
+#include <numeric>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Checks the allocation, lifetime and split remainder histograms, and the
+// free block histograms and fragmentation computed by getDeviceStats.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+constexpr size_t kSmallPool =
+    static_cast<size_t>(CachingAllocator::StatType::SMALL_POOL);
+constexpr size_t kSmallBuffer = size_t(2) << 20;
+
+int64_t total(const CachingAllocator::Histogram& histogram) {
+  return std::accumulate(histogram.begin(), histogram.end(), int64_t(0));
+}
+
+class CachingAllocatorHistogramTest
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  std::string settings() const override {
+    return "expandable_segments:False";
+  }
+};
+
+} // namespace
+
+TEST_F(CachingAllocatorHistogramTest, TestAllocationHistograms) {
+  void* first = CachingAllocator::raw_alloc(4096);
+  void* second = CachingAllocator::raw_alloc(3000);
+  auto stats = CachingAllocator::getDeviceStats(0);
+  const auto& sizes = stats.allocation_size_histogram[kSmallPool];
+  EXPECT_EQ(sizes[12], 1);
+  EXPECT_EQ(sizes[11], 1);
+  EXPECT_EQ(total(sizes), 2);
+  // The first allocation split the small buffer, and the second one split
+  // what was left of it.
+  const auto& remainders = stats.split_remainder_histogram[kSmallPool];
+  EXPECT_EQ(total(remainders), 2);
+  EXPECT_EQ(remainders[20], 2);
+  EXPECT_EQ(total(stats.block_lifetime_histogram[kSmallPool]), 0);
+
+  CachingAllocator::raw_delete(first);
+  CachingAllocator::raw_delete(second);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(total(stats.block_lifetime_histogram[kSmallPool]), 2);
+
+  CachingAllocator::resetAccumulatedStats(0);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(total(stats.allocation_size_histogram[kSmallPool]), 0);
+  EXPECT_EQ(total(stats.block_lifetime_histogram[kSmallPool]), 0);
+}
+
+TEST_F(CachingAllocatorHistogramTest, TestFragmentation) {
+  void* first = CachingAllocator::raw_alloc(4096);
+  void* second = CachingAllocator::raw_alloc(4096);
+  void* third = CachingAllocator::raw_alloc(4096);
+
+  // One free block left over at the end of the small buffer.
+  auto stats = CachingAllocator::getDeviceStats(0);
+  ASSERT_EQ(stats.free_block_histograms.size(), 1u);
+  EXPECT_EQ(total(stats.free_block_histograms[0].sizes), 1);
+  EXPECT_EQ(stats.fragmentation[kSmallPool], 0.0);
+
+  // A hole in the middle of the buffer fragments the free memory.
+  CachingAllocator::raw_delete(second);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(total(stats.free_block_histograms[0].sizes), 2);
+  EXPECT_EQ(stats.free_block_histograms[0].sizes[12], 1);
+  EXPECT_DOUBLE_EQ(
+      stats.fragmentation[kSmallPool],
+      4096.0 / static_cast<double>(kSmallBuffer - 2 * 4096));
+
+  // Freeing the others merges everything back into one block.
+  CachingAllocator::raw_delete(first);
+  CachingAllocator::raw_delete(third);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(total(stats.free_block_histograms[0].sizes), 1);
+  EXPECT_EQ(stats.free_block_histograms[0].sizes[21], 1);
+  EXPECT_EQ(stats.fragmentation[kSmallPool], 0.0);
+}
@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Checks that private pools keep their blocks away from the global pools and
+// from each other, report their stats, and give their memory back once
+// released.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+using c10::backend::fake::HostStream;
+
+constexpr size_t kLargeSize = size_t(4) << 20;
+constexpr size_t kSmallSize = 4096;
+
+class CachingAllocatorMempoolTest
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  void SetUp() override {
+    CachingAllocatorTest::SetUp();
+    stream_ = helper_->getDefaultStream(0);
+    pool_stream_ = helper_->createStream(0);
+  }
+
+  void beginPool(CachingAllocator::MempoolId_t id) {
+    void* target = pool_stream_;
+    CachingAllocator::beginAllocateToPool(
+        0, id, [target](void* stream) { return stream == target; });
+  }
+
+  static const CachingAllocator::PoolStats* findPool(
+      const CachingAllocator::DeviceStats& stats,
+      CachingAllocator::MempoolId_t id) {
+    for (const auto& pool : stats.private_pools) {
+      if (pool.id == id) {
+        return &pool;
+      }
+    }
+    return nullptr;
+  }
+
+  HostStream* stream_ = nullptr;
+  HostStream* pool_stream_ = nullptr;
+};
+
+} // namespace
+
+TEST_F(CachingAllocatorMempoolTest, TestBlocksStayInPool) {
+  auto id = CachingAllocator::createPoolId();
+  beginPool(id);
+  void* large =
+      CachingAllocator::raw_alloc_with_stream(kLargeSize, pool_stream_);
+  void* small =
+      CachingAllocator::raw_alloc_with_stream(kSmallSize, pool_stream_);
+  CachingAllocator::endAllocateToPool(0, id);
+
+  auto stats = CachingAllocator::getDeviceStats(0);
+  const auto* pool = findPool(stats, id);
+  ASSERT_NE(pool, nullptr);
+  EXPECT_EQ(pool->use_count, 1);
+  EXPECT_EQ(pool->segment, 2);
+  EXPECT_GE(pool->allocated_bytes, int64_t(kLargeSize + kSmallSize));
+  EXPECT_GE(pool->reserved_bytes, pool->allocated_bytes);
+
+  CachingAllocator::raw_delete(large);
+  CachingAllocator::raw_delete(small);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(findPool(stats, id)->allocated_bytes, 0);
+
+  // The cached blocks of the pool are not handed out to other allocations,
+  // not even on the stream the pool was routed from.
+  int64_t before = helper_->deviceAllocations();
+  void* outside =
+      CachingAllocator::raw_alloc_with_stream(kLargeSize, pool_stream_);
+  EXPECT_NE(outside, large);
+  EXPECT_GT(helper_->deviceAllocations(), before);
+  CachingAllocator::raw_delete(outside);
+
+  // But they are reused once allocations are routed to the pool again.
+  beginPool(id);
+  before = helper_->deviceAllocations();
+  void* again =
+      CachingAllocator::raw_alloc_with_stream(kLargeSize, pool_stream_);
+  EXPECT_EQ(again, large);
+  EXPECT_EQ(helper_->deviceAllocations(), before);
+  CachingAllocator::endAllocateToPool(0, id);
+  CachingAllocator::raw_delete(again);
+
+  // Pools in use keep their memory through emptyCache.
+  CachingAllocator::emptyCache();
+  stats = CachingAllocator::getDeviceStats(0);
+  ASSERT_NE(findPool(stats, id), nullptr);
+  EXPECT_EQ(findPool(stats, id)->use_count, 2);
+  EXPECT_EQ(findPool(stats, id)->segment, 2);
+
+  CachingAllocator::releasePool(0, id);
+  CachingAllocator::releasePool(0, id);
+  CachingAllocator::emptyCache();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(findPool(stats, id), nullptr);
+  EXPECT_EQ(helper_->getStats().used_bytes, 0);
+}
+
+TEST_F(CachingAllocatorMempoolTest, TestOnlyFilteredStreamsUsePool) {
+  auto id = CachingAllocator::createPoolId();
+  beginPool(id);
+  void* global = CachingAllocator::raw_alloc_with_stream(kLargeSize, stream_);
+  void* pooled =
+      CachingAllocator::raw_alloc_with_stream(kLargeSize, pool_stream_);
+  CachingAllocator::endAllocateToPool(0, id);
+
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(findPool(stats, id)->segment, 1);
+
+  auto snapshot = CachingAllocator::snapshot();
+  for (const auto& segment : snapshot.segments) {
+    bool is_pooled = segment.address == reinterpret_cast<int64_t>(pooled);
+    bool is_global = segment.address == reinterpret_cast<int64_t>(global);
+    if (is_pooled) {
+      EXPECT_EQ(segment.owner_private_pool_id, id);
+    } else if (is_global) {
+      EXPECT_EQ(
+          segment.owner_private_pool_id, CachingAllocator::MempoolId_t(0, 0));
+    }
+  }
+
+  CachingAllocator::raw_delete(global);
+  CachingAllocator::raw_delete(pooled);
+
+  // A block freed after its pool was released goes away on the next
+  // emptyCache along with the pool.
+  beginPool(id);
+  pooled = CachingAllocator::raw_alloc_with_stream(kLargeSize, pool_stream_);
+  CachingAllocator::endAllocateToPool(0, id);
+  CachingAllocator::releasePool(0, id);
+  CachingAllocator::releasePool(0, id);
+  CachingAllocator::emptyCache();
+  stats = CachingAllocator::getDeviceStats(0);
+  ASSERT_NE(findPool(stats, id), nullptr);
+  EXPECT_EQ(findPool(stats, id)->segment, 1);
+
+  CachingAllocator::raw_delete(pooled);
+  CachingAllocator::emptyCache();
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(findPool(stats, id), nullptr);
+}
+
+TEST_F(CachingAllocatorMempoolTest, TestPoolsAreIsolated) {
+  auto first = CachingAllocator::createPoolId();
+  auto second = CachingAllocator::createPoolId();
+  EXPECT_NE(first, second);
+
+  beginPool(first);
+  void* ptr = CachingAllocator::raw_alloc_with_stream(kLargeSize, pool_stream_);
+  CachingAllocator::endAllocateToPool(0, first);
+  CachingAllocator::raw_delete(ptr);
+
+  beginPool(second);
+  int64_t before = helper_->deviceAllocations();
+  void* other =
+      CachingAllocator::raw_alloc_with_stream(kLargeSize, pool_stream_);
+  EXPECT_NE(other, ptr);
+  EXPECT_GT(helper_->deviceAllocations(), before);
+  CachingAllocator::endAllocateToPool(0, second);
+  CachingAllocator::raw_delete(other);
+
+  EXPECT_THROW(CachingAllocator::endAllocateToPool(0, first), c10::Error);
+
+  CachingAllocator::releasePool(0, first);
+  CachingAllocator::releasePool(0, second);
+  CachingAllocator::emptyCache();
+  EXPECT_TRUE(CachingAllocator::getDeviceStats(0).private_pools.empty());
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Checks that the background reclaim thread releases cached segments that
+// stay unused, and the oldest ones over the garbage collection threshold,
+// without emptyCache.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+constexpr size_t kAggregate =
+    static_cast<size_t>(CachingAllocator::StatType::AGGREGATE);
+
+class CachingAllocatorReclaimTest
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  // Waits for the reserved bytes of the device to drop to at most bytes.
+  static bool waitForReserved(int64_t bytes) {
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (std::chrono::steady_clock::now() < deadline) {
+      auto stats = CachingAllocator::getDeviceStats(0);
+      if (stats.reserved_bytes[kAggregate].current <= bytes) {
+        return true;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return false;
+  }
+};
+
+} // namespace
+
+TEST_F(CachingAllocatorReclaimTest, TestReleasesColdSegments) {
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:False,background_reclaim_ms:1");
+  void* ptr = CachingAllocator::raw_alloc(size_t(30) << 20);
+  CachingAllocator::raw_delete(ptr);
+
+  ASSERT_TRUE(waitForReserved(0));
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.num_background_reclaims, 1);
+  EXPECT_EQ(stats.background_reclaimed_bytes, int64_t(30) << 20);
+  EXPECT_EQ(helper_->getStats().used_bytes, 0);
+}
+
+TEST_F(CachingAllocatorReclaimTest, TestUnmapsIdleExpandablePages) {
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:True,background_reclaim_ms:1");
+  void* ptr = CachingAllocator::raw_alloc(size_t(30) << 20);
+  CachingAllocator::raw_delete(ptr);
+
+  ASSERT_TRUE(waitForReserved(0));
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_GE(stats.num_background_reclaims, 1);
+  EXPECT_GE(stats.background_reclaimed_bytes, int64_t(30) << 20);
+}
+
+TEST_F(CachingAllocatorReclaimTest, TestKeepsSegmentsInUse) {
+  // A period long enough for blocks to never get cold during the test.
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:False,background_reclaim_ms:60000");
+  void* ptr = CachingAllocator::raw_alloc(size_t(30) << 20);
+  CachingAllocator::raw_delete(ptr);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.reserved_bytes[kAggregate].current, int64_t(30) << 20);
+  EXPECT_EQ(stats.num_background_reclaims, 0);
+
+  // Reused blocks stay cached.
+  void* again = CachingAllocator::raw_alloc(size_t(30) << 20);
+  EXPECT_EQ(again, ptr);
+  CachingAllocator::raw_delete(again);
+}
+
+TEST_F(CachingAllocatorReclaimTest, TestReclaimsOverThreshold) {
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:False,garbage_collection_threshold:0.5,"
+      "background_reclaim_ms:60000");
+  CachingAllocator::setMemoryFraction(
+      double(size_t(512) << 20) / c10::backend::test::kTestDeviceTotal, 0);
+  // 300 MB cached, over half of the 512 MB allowed.
+  void* first = CachingAllocator::raw_alloc(size_t(150) << 20);
+  void* second = CachingAllocator::raw_alloc(size_t(150) << 20);
+  CachingAllocator::raw_delete(first);
+  CachingAllocator::raw_delete(second);
+
+  // A size that misses the cache wakes up the reclaim thread, which brings
+  // the reserved bytes back under the threshold.
+  void* other = CachingAllocator::raw_alloc(size_t(160) << 20);
+  ASSERT_TRUE(waitForReserved(int64_t(256) << 20));
+  EXPECT_GE(CachingAllocator::getDeviceStats(0).num_background_reclaims, 1);
+  CachingAllocator::raw_delete(other);
+}
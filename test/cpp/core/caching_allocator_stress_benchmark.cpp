@@ -0,0 +1,107 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Allocates and frees small blocks from 1 to 16 threads spread over 8
+// devices, each thread on its own stream, the way per-device training
+// threads and pin-memory workers hit the allocator. Every alloc and free
+// looks up the pointer to block map, so its locking shows up as throughput
+// that stops scaling with the number of threads.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+using c10::backend::fake::HostStream;
+
+constexpr int kDevices = c10::backend::test::kTestDevices;
+constexpr int kMaxThreads = 16;
+constexpr int kIters = 50000;
+constexpr int kLive = 16;
+constexpr size_t kAggregate =
+    static_cast<size_t>(CachingAllocator::StatType::AGGREGATE);
+
+class CachingAllocatorStressBenchmark
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  static void SetUpTestSuite() {
+    CachingAllocatorTest::SetUpTestSuite();
+    for (int t = 0; t < kMaxThreads; t++) {
+      streams_.push_back(helper_->createStream(t % kDevices));
+    }
+  }
+
+  static void Worker(
+      int id,
+      HostStream* stream,
+      const std::atomic<bool>& go) {
+    helper_->setDevice(stream->device());
+    std::mt19937 gen(id);
+    std::uniform_int_distribution<size_t> sizeDist(512, 1 << 20);
+    std::vector<void*> live(kLive, nullptr);
+    while (!go.load(std::memory_order_acquire)) {
+    }
+    for (int i = 0; i < kIters; i++) {
+      void*& slot = live[i % kLive];
+      CachingAllocator::raw_delete(slot);
+      slot = CachingAllocator::raw_alloc_with_stream(sizeDist(gen), stream);
+    }
+    for (void* ptr : live) {
+      CachingAllocator::raw_delete(ptr);
+    }
+  }
+
+  static double Run(int threads) {
+    std::atomic<bool> go{false};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back(Worker, t, streams_[t], std::cref(go));
+    }
+    auto begin = std::chrono::steady_clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now() - begin)
+        .count();
+  }
+
+  static std::vector<HostStream*> streams_;
+};
+
+std::vector<HostStream*> CachingAllocatorStressBenchmark::streams_;
+
+} // namespace
+
+TEST_F(CachingAllocatorStressBenchmark, AllocFreeScaling) {
+  // Warm the cache of every stream so that the runs measure cache hits.
+  Run(kMaxThreads);
+  double base = 0;
+  for (int threads : {1, 2, 4, 8, 16}) {
+    double seconds = Run(threads);
+    double opsPerSec = 2.0 * kIters * threads / seconds;
+    if (threads == 1) {
+      base = opsPerSec;
+    }
+    printf(
+        "[CachingAllocatorStressBenchmark] %2d threads: %.2f Mops/s, "
+        "%.2fx of 1 thread\n",
+        threads,
+        opsPerSec / 1e6,
+        opsPerSec / base);
+  }
+
+  for (int device = 0; device < kDevices; device++) {
+    auto stats = CachingAllocator::getDeviceStats(device);
+    EXPECT_EQ(stats.allocated_bytes[kAggregate].current, 0);
+  }
+  CachingAllocator::emptyCache();
+  EXPECT_EQ(helper_->getStats().used_bytes, 0);
+}
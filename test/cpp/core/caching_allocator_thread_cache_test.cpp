@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+
+#include <future>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "test/cpp/core/caching_allocator_fixture.h"
+
+// Checks that allocations served from and frees kept by the per-thread block
+// cache update the device stats the same way as the device allocator path,
+// including the ones of other threads that have not entered the device
+// allocator since.
+
+namespace {
+
+namespace CachingAllocator = c10::backend::CachingAllocator;
+
+constexpr size_t kAggregate =
+    static_cast<size_t>(CachingAllocator::StatType::AGGREGATE);
+constexpr size_t kSmallPool =
+    static_cast<size_t>(CachingAllocator::StatType::SMALL_POOL);
+
+int64_t total(const CachingAllocator::Histogram& histogram) {
+  return std::accumulate(histogram.begin(), histogram.end(), int64_t(0));
+}
+
+void expectSameStat(
+    const CachingAllocator::Stat& cached,
+    const CachingAllocator::Stat& uncached) {
+  EXPECT_EQ(cached.current, uncached.current);
+  EXPECT_EQ(cached.peak, uncached.peak);
+  EXPECT_EQ(cached.allocated, uncached.allocated);
+  EXPECT_EQ(cached.freed, uncached.freed);
+}
+
+class CachingAllocatorThreadCacheTest
+    : public c10::backend::test::CachingAllocatorTest {
+ protected:
+  // Allocates and frees small blocks of a few sizes under settings, keeping
+  // some of them alive at the end, and returns the stats of device 0.
+  static CachingAllocator::DeviceStats run(
+      const char* settings,
+      std::vector<void*>& live) {
+    CachingAllocator::setAllocatorSettings(settings);
+    CachingAllocator::emptyCache();
+    CachingAllocator::resetAccumulatedStats(0);
+    CachingAllocator::resetPeakStats(0);
+    const size_t sizes[] = {512, 3000, 4096, 20000, 65536};
+    std::vector<void*> ptrs;
+    for (int round = 0; round < 4; round++) {
+      for (size_t i = 0; i < 16; i++) {
+        ptrs.push_back(CachingAllocator::raw_alloc(sizes[i % 5] - round));
+      }
+      for (size_t i = 0; i < ptrs.size(); i += 2) {
+        CachingAllocator::raw_delete(ptrs[i]);
+      }
+      for (size_t i = 1; i < ptrs.size(); i += 2) {
+        live.push_back(ptrs[i]);
+      }
+      ptrs.clear();
+      // Frees half of what is alive, the rest is freed by the caller.
+      for (size_t i = 0; i < live.size() / 2; i++) {
+        CachingAllocator::raw_delete(live.back());
+        live.pop_back();
+      }
+    }
+    return CachingAllocator::getDeviceStats(0);
+  }
+};
+
+} // namespace
+
+TEST_F(CachingAllocatorThreadCacheTest, TestStatsMatchUncached) {
+  std::vector<void*> live;
+  auto uncached = run("expandable_segments:False", live);
+  for (void* ptr : live) {
+    CachingAllocator::raw_delete(ptr);
+  }
+  live.clear();
+  EXPECT_EQ(uncached.thread_cache_hits, 0);
+
+  auto cached =
+      run("expandable_segments:False,thread_cache_size_kb:1024", live);
+  EXPECT_GT(cached.thread_cache_hits, 0);
+  for (size_t i : {kAggregate, kSmallPool}) {
+    expectSameStat(cached.allocation[i], uncached.allocation[i]);
+    expectSameStat(cached.allocated_bytes[i], uncached.allocated_bytes[i]);
+    expectSameStat(cached.active[i], uncached.active[i]);
+    expectSameStat(cached.active_bytes[i], uncached.active_bytes[i]);
+    expectSameStat(cached.requested_bytes[i], uncached.requested_bytes[i]);
+    EXPECT_EQ(
+        cached.allocation_size_histogram[i],
+        uncached.allocation_size_histogram[i]);
+    EXPECT_EQ(
+        total(cached.block_lifetime_histogram[i]),
+        total(uncached.block_lifetime_histogram[i]));
+  }
+  for (void* ptr : live) {
+    CachingAllocator::raw_delete(ptr);
+  }
+}
+
+TEST_F(CachingAllocatorThreadCacheTest, TestReuseKeepsRequestedSize) {
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:False,thread_cache_size_kb:1024");
+  void* first = CachingAllocator::raw_alloc(4000);
+  CachingAllocator::raw_delete(first);
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.requested_bytes[kAggregate].current, 0);
+  EXPECT_EQ(stats.allocated_bytes[kAggregate].current, 0);
+
+  // Same rounded size, so the block comes back from the thread cache.
+  void* second = CachingAllocator::raw_alloc(3900);
+  EXPECT_EQ(second, first);
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.thread_cache_hits, 1);
+  EXPECT_EQ(stats.requested_bytes[kAggregate].current, 3900);
+  EXPECT_EQ(stats.allocated_bytes[kAggregate].current, 4096);
+  EXPECT_EQ(stats.allocation[kAggregate].allocated, 2);
+  EXPECT_EQ(stats.allocation[kAggregate].freed, 1);
+  CachingAllocator::raw_delete(second);
+
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.requested_bytes[kAggregate].current, 0);
+  EXPECT_EQ(stats.requested_bytes[kAggregate].freed, 7900);
+}
+
+TEST_F(CachingAllocatorThreadCacheTest, TestStatsOfOtherThreads) {
+  CachingAllocator::setAllocatorSettings(
+      "expandable_segments:False,thread_cache_size_kb:1024");
+  std::promise<void> served;
+  std::promise<void> checked;
+  std::thread worker([&] {
+    CachingAllocator::raw_delete(CachingAllocator::raw_alloc(4096));
+    void* ptr = CachingAllocator::raw_alloc(4096);
+    served.set_value();
+    checked.get_future().wait();
+    CachingAllocator::raw_delete(ptr);
+  });
+  served.get_future().wait();
+
+  // The hit is only kept with the worker's cache until the stats are read.
+  auto stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.thread_cache_hits, 1);
+  EXPECT_EQ(stats.allocation[kAggregate].current, 1);
+  EXPECT_EQ(stats.allocation[kAggregate].allocated, 2);
+  EXPECT_EQ(stats.requested_bytes[kAggregate].current, 4096);
+  checked.set_value();
+  worker.join();
+
+  stats = CachingAllocator::getDeviceStats(0);
+  EXPECT_EQ(stats.allocation[kAggregate].current, 0);
+  EXPECT_EQ(stats.active[kAggregate].current, 0);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <vector>
+
+#include "csrc/core/allocator/PinnedMemoryPool.h"
+
+// Checks that the pinned memory pool serves size classes out of slabs that
+// grow from a small first one, reuses freed chunks without calling the
+// driver, recognizes pointers inside pinned memory, and gives back the slabs
+// left unused.
+
+namespace {
+
+using c10::backend::HostAllocator::PinnedMemoryPool;
+
+constexpr size_t kSlabSize = size_t(1) << 20;
+
+class PinnedMemoryPoolTest : public ::testing::Test {
+ protected:
+  PinnedMemoryPool makePool(
+      size_t initial_slab_size = PinnedMemoryPool::kInitialSlabSize) {
+    return PinnedMemoryPool(
+        [this](size_t size) {
+          allocs_++;
+          return std::malloc(size);
+        },
+        [this](void* ptr) {
+          frees_++;
+          std::free(ptr);
+        },
+        kSlabSize,
+        initial_slab_size);
+  }
+
+  int allocs_ = 0;
+  int frees_ = 0;
+};
+
+} // namespace
+
+TEST_F(PinnedMemoryPoolTest, TestChunkSizes) {
+  auto pool = makePool();
+  EXPECT_EQ(pool.chunkSize(1), PinnedMemoryPool::kMinChunkSize);
+  EXPECT_EQ(pool.chunkSize(513), size_t(1024));
+  EXPECT_EQ(pool.chunkSize(kSlabSize / 4), kSlabSize / 4);
+  EXPECT_EQ(pool.chunkSize(kSlabSize / 4 + 1), size_t(0));
+}
+
+TEST_F(PinnedMemoryPoolTest, TestSlabsGrow) {
+  constexpr size_t kInitialSize = size_t(64) << 10;
+  auto pool = makePool(kInitialSize);
+  EXPECT_EQ(allocs_, 0);
+  EXPECT_EQ(pool.getStats().pinned_bytes, 0);
+
+  // The first slab only holds 16 chunks of 4 KiB.
+  for (int i = 0; i < 16; i++) {
+    pool.malloc(4096);
+  }
+  EXPECT_EQ(allocs_, 1);
+  EXPECT_EQ(pool.getStats().pinned_bytes, int64_t(kInitialSize));
+
+  // The next slab is twice as large.
+  pool.malloc(4096);
+  EXPECT_EQ(pool.getStats().pinned_bytes, int64_t(3 * kInitialSize));
+
+  // Then 4 times, which leaves the 2nd one partly carved.
+  pool.malloc(kSlabSize / 4);
+  auto stats = pool.getStats();
+  EXPECT_EQ(stats.slabs, 3);
+  EXPECT_EQ(stats.pinned_bytes, int64_t(7 * kInitialSize));
+
+  // 8 times, holding two of the largest chunks.
+  pool.malloc(kSlabSize / 4);
+  pool.malloc(kSlabSize / 4);
+  EXPECT_EQ(pool.getStats().pinned_bytes, int64_t(15 * kInitialSize));
+
+  // Slabs stop growing at the slab size.
+  for (int i = 0; i < 5; i++) {
+    pool.malloc(kSlabSize / 4);
+  }
+  stats = pool.getStats();
+  EXPECT_EQ(stats.slabs, 6);
+  EXPECT_EQ(stats.pinned_bytes, int64_t(15 * kInitialSize + 2 * kSlabSize));
+}
+
+TEST_F(PinnedMemoryPoolTest, TestReusesChunks) {
+  auto pool = makePool();
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 16; i++) {
+    ptrs.push_back(pool.malloc(4096));
+  }
+  // All of them fit in one slab.
+  EXPECT_EQ(allocs_, 1);
+  EXPECT_EQ(pool.getStats().slabs, 1);
+
+  for (void* ptr : ptrs) {
+    pool.free(ptr, 4096);
+  }
+  for (int i = 0; i < 16; i++) {
+    pool.malloc(4096);
+  }
+  EXPECT_EQ(allocs_, 1);
+  EXPECT_EQ(pool.getStats().class_hits, 16);
+}
+
+TEST_F(PinnedMemoryPoolTest, TestContains) {
+  auto pool = makePool();
+  auto* chunk = static_cast<char*>(pool.malloc(8192));
+  auto* large = static_cast<char*>(pool.malloc(kSlabSize));
+  EXPECT_TRUE(pool.contains(chunk));
+  EXPECT_TRUE(pool.contains(chunk + 100));
+  EXPECT_TRUE(pool.contains(large + kSlabSize - 1));
+  int local = 0;
+  EXPECT_FALSE(pool.contains(&local));
+
+  pool.free(large, kSlabSize);
+  EXPECT_EQ(frees_, 1);
+  EXPECT_FALSE(pool.contains(large));
+  pool.free(chunk, 8192);
+  // Chunks freed stay pinned until their slab is released.
+  EXPECT_TRUE(pool.contains(chunk));
+}
+
+TEST_F(PinnedMemoryPoolTest, TestReleasesFreeSlabs) {
+  auto pool = makePool();
+  pool.reserve(kSlabSize);
+  EXPECT_EQ(pool.getStats().reserved_slabs, 1);
+
+  // Fill the reserved slab, so the next chunk takes a slab of its own.
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 5; i++) {
+    ptrs.push_back(pool.malloc(kSlabSize / 4));
+  }
+  EXPECT_EQ(pool.getStats().slabs, 2);
+
+  pool.releaseFreeSlabs();
+  EXPECT_EQ(frees_, 0);
+
+  for (void* ptr : ptrs) {
+    pool.free(ptr, kSlabSize / 4);
+  }
+  pool.releaseFreeSlabs();
+  auto stats = pool.getStats();
+  EXPECT_EQ(frees_, 1);
+  EXPECT_EQ(stats.slabs, 1);
+  EXPECT_EQ(stats.pinned_bytes, int64_t(kSlabSize));
+
+  // The reserved slab still serves allocations.
+  pool.malloc(kSlabSize / 4);
+  EXPECT_EQ(allocs_, 2);
+}
@@ -1,3 +1,5 @@
+import unittest
+
 import torch
 from torch.testing._internal.common_utils import (
     get_cycles_per_ms,
@@ -20,6 +22,79 @@ class TestNPU(TestCase):
         self.assertTrue(event.query())
         self.assertGreater(start_event.elapsed_time(event), 0)
 
+    def test_workload_streams(self):
+        torch.npu.utils._reserve_workload_streams("test_npu.h2d", 2)
+        streams = {torch.npu.utils._stream_for_workload("test_npu.h2d") for _ in range(4)}
+        self.assertEqual(len(streams), 2)
+        for _ in range(16):
+            self.assertNotIn(torch.npu.Stream(), streams)
+        # Pooled streams were handed out, the pool cannot be reserved any more.
+        with self.assertRaises(RuntimeError):
+            torch.npu.utils._reserve_workload_streams("test_npu.d2h", 1)
+
+    def test_reserve_pinned_memory(self):
+        torch.npu.memory._reserve_pinned_memory(1)
+        stats = torch.npu.memory._pinned_memory_stats()
+        self.assertGreater(stats["reserved_slabs"], 0)
+        # Reserved slabs survive empty_cache and serve later pinned tensors.
+        torch.npu.empty_cache()
+        before = torch.npu.memory._pinned_memory_stats()
+        self.assertEqual(before["reserved_slabs"], stats["reserved_slabs"])
+        t = torch.empty(1024).pin_memory()
+        self.assertTrue(t.is_pinned())
+        after = torch.npu.memory._pinned_memory_stats()
+        self.assertEqual(after["driver_allocs"], before["driver_allocs"])
+
+    def test_foreach_scalar_list(self):
+        # The scalars go to the device in one copy, e.g. the step sizes of
+        # foreach Adam.
+        inputs = [torch.randn(16) for _ in range(3)]
+        tensors1 = [torch.randn(16) for _ in range(3)]
+        tensors2 = [torch.rand(16) + 1 for _ in range(3)]
+        scalars = [0.5, -1.0, 2.0]
+        for op in (torch._foreach_addcmul, torch._foreach_addcdiv):
+            expected = op(inputs, tensors1, tensors2, scalars)
+            npu_inputs = [t.npu() for t in inputs]
+            result = op(npu_inputs, [t.npu() for t in tensors1], [t.npu() for t in tensors2], scalars)
+            for r, e in zip(result, expected):
+                self.assertEqual(r.cpu(), e)
+
+    @unittest.skipIf(torch.npu.device_count() < 2, "requires two NPUs")
+    def test_copy_between_devices_is_stream_ordered(self):
+        src = torch.arange(1 << 20, device="npu:0", dtype=torch.float)
+        with torch.npu.device(1):
+            dst = torch.zeros(1 << 20, device="npu:1")
+            # The copy has to wait for the pending work of the destination
+            # stream, without blocking the host.
+            torch.npu._sleep(int(50 * get_cycles_per_ms()))
+            dst.fill_(-1)
+        dst.copy_(src, non_blocking=True)
+        with torch.npu.device(1):
+            done = torch.npu.Event()
+            torch.npu.current_stream().record_event(done)
+            self.assertFalse(done.query())
+            # Work queued on the destination stream sees the copied values.
+            doubled = dst * 2
+        torch.npu.synchronize(1)
+        self.assertEqual(dst.cpu(), src.cpu())
+        self.assertEqual(doubled.cpu(), src.cpu() * 2)
+
+    @unittest.skipIf(torch.npu.device_count() < 2, "requires two NPUs")
+    def test_copy_between_devices_with_dtype_cast(self):
+        # Integers below 2048 are exact in half precision.
+        src = torch.arange(1 << 20, dtype=torch.float).remainder(2048).to("npu:0")
+        with torch.npu.device(1):
+            dst = torch.zeros(1 << 20, device="npu:1", dtype=torch.half)
+            torch.npu._sleep(int(50 * get_cycles_per_ms()))
+            dst.fill_(-1)
+        dst.copy_(src, non_blocking=True)
+        with torch.npu.device(1):
+            # The cast is ordered on the destination stream like a plain copy.
+            doubled = dst * 2
+        torch.npu.synchronize(1)
+        self.assertEqual(dst.cpu(), src.cpu().half())
+        self.assertEqual(doubled.cpu(), src.cpu().half() * 2)
+
 
 if __name__ == "__main__":
     run_tests()
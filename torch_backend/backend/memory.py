@@ -170,6 +170,16 @@ def memory_stats(device=None):
     - ``"num_alloc_retries"``: number of failed ``npuMalloc`` calls that
       result in a cache flush and retry.
     - ``"num_ooms"``: number of out-of-memory errors thrown.
+    - ``"num_background_reclaims"``: number of cached segments, or ranges of
+      expandable segments, released by the background reclaim thread. It is
+      started with ``background_reclaim_ms:<n>``, wakes up every n ms and
+      releases the cached memory unused for 20 wake ups, and the oldest
+      cached memory while over ``garbage_collection_threshold``.
+    - ``"background_reclaimed_bytes"``: bytes released by it.
+    - ``"outstanding_events.{current,peak,allocated,freed}"``: events that
+      blocks freed while in use by other streams (see ``record_stream``)
+      wait for. Blocks freed on a stream between two allocations share one.
+    - ``"num_event_queries"``: number of queries of these events.
     The caching allocator can be configured via ENV to not split blocks larger than a
     defined size (see Memory Management section of the Cuda Semantics documentation).
     This helps avoid memory framentation but may have a performance
@@ -179,6 +189,40 @@ def memory_stats(device=None):
       number of over-size allocation requests received by the memory allocator.
     - ``"oversize_segments.{current,peak,allocated,freed}"``:
       number of over-size reserved segments from ``cudaMalloc()``.
+    The size classes can be tuned via ENV as well, with ``small_size_kb``,
+    ``large_buffer_mb``, ``round_large_mb`` and ``roundup_power2_divisions``
+    (either ``<n>`` or ``[<interval start in MB>:<n>,...,>:<n>]``), which
+    rounds sizes up to one of n divisions of their power of two interval so
+    that variable shape allocations can reuse each other's blocks:
+    - ``"small_size"``: allocations up to this size use the small pool.
+    - ``"large_buffer"``: size of the segments that larger allocations below
+      half of it are packed in.
+    - ``"round_large"``: other large allocations are rounded up to it.
+    - ``"roundup_power2_divisions"``: divisions per power of two interval,
+      starting at 1 MB. 0 only rounds to 512 bytes.
+    With ``thread_cache_size_kb`` set, small blocks freed by a thread are kept
+    for its next allocations of the same size and stream. They do not count
+    as allocated, and the cache is tracked by:
+    - ``"thread_cache_hits"``: small allocations served from the thread caches.
+    - ``"thread_cache_misses"``: small allocations that missed them.
+    To find out where reserved memory that is not allocated goes, the
+    allocator keeps power of two histograms, lists whose entry i counts the
+    values in ``[2**i, 2**(i+1))``:
+    - ``"allocation_size_histogram.{all,large_pool,small_pool}"``: requested
+      sizes of allocations, in bytes.
+    - ``"block_lifetime_histogram.{all,large_pool,small_pool}"``: time from
+      allocation to free of blocks, in microseconds.
+    - ``"split_remainder_histogram.{all,large_pool,small_pool}"``: sizes of
+      the free blocks left over by splitting a block.
+    - ``"free_block_histograms"``: for each stream with cached blocks, a
+      dict with the ``"stream"`` and the ``"sizes"`` of its free blocks.
+    - ``"fragmentation.{all,large_pool,small_pool}"``: 1 minus the largest
+      free block over the free bytes of the pool, near 1 when free memory is
+      spread over many small blocks.
+    Blocks of private pools, see :func:`_use_mem_pool`, count in the stats
+    above as well. ``"private_pools"`` lists each pool of the device as a
+    dict with its ``"id"``, ``"use_count"``, number of ``"segment"``,
+    ``"reserved_bytes"`` and ``"allocated_bytes"``.
     Arguments:
         device (torch.device or int, optional): selected device. Returns
             statistics for the current device, given by :func:`~torch_backend.npu.current_device`,
@@ -638,3 +682,87 @@ def _dump_snapshot(filename="dump_snapshot.pickle"):
     s = _snapshot()
     with os.fdopen(os.open(filename, os.O_WRONLY | os.O_CREAT, stat.S_IWUSR), "wb") as f:
         pickle.dump(s, f)
+
+
+def _dump_allocator_trace(filename="allocator_trace.bin"):
+    """
+    Save the allocation history, recorded while `torch.npu.memory._record_memory_history()`
+    is enabled, in the compact binary format read by the allocator trace replay tool.
+
+    Stack frames are not kept. The trace can be replayed against different
+    `PYTORCH_ALLOC_CONF` settings without a device, see the allocator trace
+    replay test in `test/cpp/core`.
+
+    Args:
+        filename (str, optional): Name of the file to create. Defaults to "allocator_trace.bin".
+    """
+    torch_backend._C._dumpAllocatorTrace(filename)
+
+
+def _reserve_pinned_memory(size):
+    """
+    Pin at least `size` bytes of host memory up front.
+
+    The memory is not released by :func:`empty_cache` and serves the pinned
+    allocations made later, such as by ``tensor.pin_memory()``, without calling
+    the driver.
+
+    Args:
+        size (int): number of bytes to pin.
+    """
+    torch_backend._C._reservePinnedMemory(size)
+
+
+def _pinned_memory_stats():
+    """
+    Return a dictionary of statistics of the pinned host memory pool.
+
+    - ``"driver_allocs"``, ``"driver_frees"``: calls into the driver that
+      allocate or free pinned memory.
+    - ``"slabs"``, ``"reserved_slabs"``: slabs currently held, and the ones of
+      them reserved by :func:`_reserve_pinned_memory`.
+    - ``"pinned_bytes"``: pinned bytes currently held.
+    - ``"class_hits"``: allocations served from a freed chunk of their size class.
+    """
+    return torch_backend._C._pinnedMemoryStats()
+
+
+def _create_mem_pool_id():
+    """
+    Return the id of a new private memory pool, to be passed to :func:`_use_mem_pool`.
+    """
+    return torch_backend._C._createPoolId()
+
+
+@contextlib.contextmanager
+def _use_mem_pool(pool, device=None):
+    """
+    Serve the allocations made on the current stream of `device` from the private pool `pool`.
+
+    Blocks of a private pool are cached separately and only reused by allocations
+    routed to the same pool, which isolates graph captures or tenants sharing a
+    device. Every use of the pool must be matched by a :func:`_release_mem_pool`;
+    once all of them are, its memory is freed by :func:`empty_cache` after its
+    last block is freed.
+
+    Args:
+        pool (tuple[int, int]): id returned by :func:`_create_mem_pool_id`.
+        device (torch.device or int, optional): selected device. Uses the current
+            device, given by :func:`~torch_backend.npu.current_device`, if
+            :attr:`device` is ``None`` (default).
+    """
+    _lazy_init()
+    device = _get_device_index(device, optional=True)
+    torch_backend._C._beginAllocateCurrentStreamToPool(device, pool)
+    try:
+        yield
+    finally:
+        torch_backend._C._endAllocateToPool(device, pool)
+
+
+def _release_mem_pool(pool, device=None):
+    """
+    Drop a use of the private pool `pool` on `device`, see :func:`_use_mem_pool`.
+    """
+    device = _get_device_index(device, optional=True)
+    torch_backend._C._releasePool(device, pool)
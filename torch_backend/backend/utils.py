@@ -106,6 +106,42 @@ def default_stream(device=None):
     return torch_backend.backend.Stream(stream_id=streamdata[0], device_index=streamdata[1], device_type=streamdata[2])
 
 
+def _reserve_workload_streams(workload, count, high_priority=False):
+    r"""Reserves ``count`` streams of the pool for the workload named ``workload``.
+
+    Reserved streams are only returned by :func:`_stream_for_workload`, so
+    unrelated work never lands on them. Reserve them before other work takes
+    pooled streams, reserving from a pool that already handed out streams
+    raises. Reserving again with the same arguments does nothing.
+
+    Arguments:
+        workload (str): name of the workload, e.g. ``"h2d"``.
+        count (int): number of streams to reserve, at least one stream of the
+            pool stays shared.
+        high_priority (bool, optional): reserve streams of the high priority
+            pool. Default: ``False``.
+    """
+    torch_backend.backend._lazy_init()
+    torch_backend._C._reserveWorkloadStreams(workload, count, high_priority)
+
+
+def _stream_for_workload(workload, device=None):
+    r"""Returns a :class:`Stream` reserved for ``workload`` by
+    :func:`_reserve_workload_streams`. The reserved streams are returned
+    round-robin.
+
+    Arguments:
+        workload (str): name the streams were reserved for.
+        device (torch.device or int, optional): selected device. Uses the
+            current device, given by :func:`~torch_backend.backend.current_device`,
+            if :attr:`device` is ``None`` (default).
+    """
+    torch_backend.backend._lazy_init()
+    streamdata = torch_backend._C._getStreamForWorkload(
+        workload, _get_device_index(device, optional=True))
+    return torch_backend.backend.Stream(stream_id=streamdata[0], device_index=streamdata[1], device_type=streamdata[2])
+
+
 def set_sync_debug_mode(debug_mode):
     r"""Sets the debug mode for npu synchronizing operations.
 
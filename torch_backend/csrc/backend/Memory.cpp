@@ -6,6 +6,9 @@
 #include <torch/csrc/utils/python_arg_parser.h>
 #include <torch/csrc/utils/python_numbers.h>
 #include "csrc/backend/NPUCachingAllocator.h"
+#include "csrc/backend/NPUCachingHostAllocator.h"
+#include "csrc/backend/NPUStream.h"
+#include "csrc/core/allocator/AllocatorTrace.h"
 
 namespace torch::backend::memory {
 
@@ -91,6 +94,7 @@ PyObject* THPModule_memorySnapshot(PyObject* _unused, PyObject* noargs) {
   py::str cpp_frames_s = "cpp_frames";
   py::str blocks_s = "blocks";
   py::str is_expandable_s = "is_expandable";
+  py::str segment_pool_id_s = "segment_pool_id";
   py::str frames_s = "frames";
 
   py::list empty_frames;
@@ -121,6 +125,9 @@ PyObject* THPModule_memorySnapshot(PyObject* _unused, PyObject* noargs) {
     segmentDict[stream_s] = int64_t(segmentInfo.stream);
     segmentDict[segment_type_s] = (segmentInfo.is_large ? large_s : small_s);
     segmentDict[is_expandable_s] = segmentInfo.is_expandable;
+    segmentDict[segment_pool_id_s] = std::make_tuple(
+        segmentInfo.owner_private_pool_id.first,
+        segmentInfo.owner_private_pool_id.second);
     add_frame_key(segmentDict, segmentInfo.context_when_allocated);
 
     auto address = segmentInfo.address;
@@ -293,6 +300,8 @@ PyObject* THPModule_memoryStats(PyObject* _unused, PyObject* arg) {
   const int device = (int)THPUtils_unpackLong(arg);
 
   using c10::backend::CachingAllocator::DeviceStats;
+  using c10::backend::CachingAllocator::Histogram;
+  using c10::backend::CachingAllocator::HistogramArray;
   using c10::backend::CachingAllocator::Stat;
   using c10::backend::CachingAllocator::StatArray;
   using c10::backend::CachingAllocator::StatType;
@@ -317,13 +326,43 @@ PyObject* THPModule_memoryStats(PyObject* _unused, PyObject* arg) {
     return dict;
   };
 
+  const auto histogramToList = [](const Histogram& histogram) {
+    py::list list;
+    for (int64_t count : histogram) {
+      list.append(count);
+    }
+    return list;
+  };
+
+  const auto histogramArrayToDict = [=](const HistogramArray& histograms) {
+    const std::array<const char*, static_cast<size_t>(StatType::NUM_TYPES)>
+        statTypeNames = {"all", "small_pool", "large_pool"};
+    py::dict dict;
+    for (size_t i = 0; i < statTypeNames.size(); ++i) {
+      dict[statTypeNames[i]] = histogramToList(histograms[i]);
+    }
+    return dict;
+  };
+
   const DeviceStats stats =
       c10::backend::Allocator::getDeviceStats(device);
 
   py::dict result;
   result["num_alloc_retries"] = stats.num_alloc_retries;
   result["num_ooms"] = stats.num_ooms;
+  result["num_background_reclaims"] = stats.num_background_reclaims;
+  result["background_reclaimed_bytes"] = stats.background_reclaimed_bytes;
   result["max_split_size"] = stats.max_split_size;
+  result["small_size"] = stats.small_size;
+  result["large_buffer"] = stats.large_buffer;
+  result["round_large"] = stats.round_large;
+  py::list roundup_power2_divisions;
+  for (int64_t divisions : stats.roundup_power2_divisions) {
+    roundup_power2_divisions.append(divisions);
+  }
+  result["roundup_power2_divisions"] = roundup_power2_divisions;
+  result["thread_cache_hits"] = stats.thread_cache_hits;
+  result["thread_cache_misses"] = stats.thread_cache_misses;
   result["allocation"] = statArrayToDict(stats.allocation);
   result["segment"] = statArrayToDict(stats.segment);
   result["active"] = statArrayToDict(stats.active);
@@ -334,6 +373,40 @@ PyObject* THPModule_memoryStats(PyObject* _unused, PyObject* arg) {
   result["inactive_split_bytes"] = statArrayToDict(stats.inactive_split_bytes);
   result["oversize_allocations"] = statToDict(stats.oversize_allocations);
   result["oversize_segments"] = statToDict(stats.oversize_segments);
+  result["outstanding_events"] = statToDict(stats.outstanding_events);
+  result["num_event_queries"] = stats.num_event_queries;
+  result["allocation_size_histogram"] =
+      histogramArrayToDict(stats.allocation_size_histogram);
+  result["block_lifetime_histogram"] =
+      histogramArrayToDict(stats.block_lifetime_histogram);
+  result["split_remainder_histogram"] =
+      histogramArrayToDict(stats.split_remainder_histogram);
+
+  py::list free_block_histograms;
+  for (const auto& free_blocks : stats.free_block_histograms) {
+    py::dict dict;
+    dict["stream"] = reinterpret_cast<int64_t>(free_blocks.stream);
+    dict["sizes"] = histogramToList(free_blocks.sizes);
+    free_block_histograms.append(dict);
+  }
+  result["free_block_histograms"] = free_block_histograms;
+  py::dict fragmentation;
+  fragmentation["all"] = stats.fragmentation[0];
+  fragmentation["small_pool"] = stats.fragmentation[1];
+  fragmentation["large_pool"] = stats.fragmentation[2];
+  result["fragmentation"] = fragmentation;
+
+  py::list private_pools;
+  for (const auto& pool : stats.private_pools) {
+    py::dict dict;
+    dict["id"] = std::make_tuple(pool.id.first, pool.id.second);
+    dict["use_count"] = pool.use_count;
+    dict["segment"] = pool.segment;
+    dict["reserved_bytes"] = pool.reserved_bytes;
+    dict["allocated_bytes"] = pool.allocated_bytes;
+    private_pools.append(dict);
+  }
+  result["private_pools"] = private_pools;
 
   return result.release().ptr();
   END_HANDLE_TH_ERRORS
@@ -346,6 +419,110 @@ PyObject* THPModule_emptyCache(PyObject* _unused, PyObject* noargs) {
   Py_RETURN_NONE;
 }
 
+PyObject* THPModule_dumpAllocatorTrace(PyObject* _unused, PyObject* arg) {
+  HANDLE_TH_ERRORS
+  TORCH_CHECK(
+      THPUtils_checkString(arg), "invalid argument to dump_allocator_trace");
+  c10::backend::CachingAllocator::dumpTrace(
+      THPUtils_unpackString(arg), c10::backend::Allocator::snapshot());
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject* THPModule_reservePinnedMemory(PyObject* _unused, PyObject* arg) {
+  HANDLE_TH_ERRORS
+  TORCH_CHECK(
+      THPUtils_checkLong(arg), "invalid argument to reserve_pinned_memory");
+  const int64_t bytes = THPUtils_unpackLong(arg);
+  TORCH_CHECK(bytes >= 0, "reserve_pinned_memory expects a size >= 0");
+  c10::backend::HostAllocator::reservePinnedMemory(static_cast<size_t>(bytes));
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject* THPModule_pinnedMemoryStats(PyObject* _unused, PyObject* noargs) {
+  HANDLE_TH_ERRORS
+  const auto stats = c10::backend::HostAllocator::getPinnedMemoryStats();
+  py::dict result;
+  result["driver_allocs"] = stats.driver_allocs;
+  result["driver_frees"] = stats.driver_frees;
+  result["slabs"] = stats.slabs;
+  result["reserved_slabs"] = stats.reserved_slabs;
+  result["pinned_bytes"] = stats.pinned_bytes;
+  result["class_hits"] = stats.class_hits;
+  return result.release().ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPModule_createPoolId(PyObject* _unused, PyObject* noargs) {
+  HANDLE_TH_ERRORS
+  auto mempool_id = c10::backend::CachingAllocator::createPoolId();
+  return py::cast(std::make_tuple(mempool_id.first, mempool_id.second))
+      .release()
+      .ptr();
+  END_HANDLE_TH_ERRORS
+}
+
+static bool parsePoolArgs(
+    PyObject* args,
+    const char* name,
+    int* device,
+    c10::backend::CachingAllocator::MempoolId_t* mempool_id) {
+  unsigned long long first = 0;
+  unsigned long long second = 0;
+  if (!PyArg_ParseTuple(args, "i(KK)", device, &first, &second)) {
+    THPUtils_invalidArguments(
+        args, nullptr, name, 1, "(int device, tuple[int, int] pool);");
+    return false;
+  }
+  *mempool_id = {first, second};
+  return true;
+}
+
+PyObject* THPModule_beginAllocateCurrentStreamToPool(
+    PyObject* _unused,
+    PyObject* args) {
+  HANDLE_TH_ERRORS
+  int device = 0;
+  c10::backend::CachingAllocator::MempoolId_t mempool_id;
+  if (!parsePoolArgs(
+          args,
+          "_begin_allocate_current_stream_to_pool",
+          &device,
+          &mempool_id)) {
+    return nullptr;
+  }
+  void* stream = c10::backend::getCurrentNPUStream(device);
+  c10::backend::Allocator::beginAllocateToPool(
+      device, mempool_id, [stream](void* target) { return target == stream; });
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject* THPModule_endAllocateToPool(PyObject* _unused, PyObject* args) {
+  HANDLE_TH_ERRORS
+  int device = 0;
+  c10::backend::CachingAllocator::MempoolId_t mempool_id;
+  if (!parsePoolArgs(args, "_end_allocate_to_pool", &device, &mempool_id)) {
+    return nullptr;
+  }
+  c10::backend::Allocator::endAllocateToPool(device, mempool_id);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
+PyObject* THPModule_releasePool(PyObject* _unused, PyObject* args) {
+  HANDLE_TH_ERRORS
+  int device = 0;
+  c10::backend::CachingAllocator::MempoolId_t mempool_id;
+  if (!parsePoolArgs(args, "_release_pool", &device, &mempool_id)) {
+    return nullptr;
+  }
+  c10::backend::Allocator::releasePool(device, mempool_id);
+  END_HANDLE_TH_ERRORS
+  Py_RETURN_NONE;
+}
+
 static struct PyMethodDef THPModule_methods[] = {
     {"_setMemoryFraction",
      (PyCFunction)THPModule_setMemoryFraction,
@@ -365,6 +542,10 @@ static struct PyMethodDef THPModule_methods[] = {
      (PyCFunction)THPModule_memorySnapshot,
      METH_NOARGS,
      nullptr},
+    {"_dumpAllocatorTrace",
+     (PyCFunction)THPModule_dumpAllocatorTrace,
+     METH_O,
+     nullptr},
     {"attach_out_of_memory_observer",
      THPModule_attachOutOfMemoryObserver,
      METH_O,
@@ -381,6 +562,30 @@ static struct PyMethodDef THPModule_methods[] = {
      (PyCFunction)THPModule_getAllocatorBackend,
      METH_NOARGS,
      nullptr},
+    {"_reservePinnedMemory",
+     (PyCFunction)THPModule_reservePinnedMemory,
+     METH_O,
+     nullptr},
+    {"_pinnedMemoryStats",
+     (PyCFunction)THPModule_pinnedMemoryStats,
+     METH_NOARGS,
+     nullptr},
+    {"_createPoolId",
+     (PyCFunction)THPModule_createPoolId,
+     METH_NOARGS,
+     nullptr},
+    {"_beginAllocateCurrentStreamToPool",
+     (PyCFunction)THPModule_beginAllocateCurrentStreamToPool,
+     METH_VARARGS,
+     nullptr},
+    {"_endAllocateToPool",
+     (PyCFunction)THPModule_endAllocateToPool,
+     METH_VARARGS,
+     nullptr},
+    {"_releasePool",
+     (PyCFunction)THPModule_releasePool,
+     METH_VARARGS,
+     nullptr},
     {nullptr}};
 
 PyMethodDef* python_functions() {
@@ -53,7 +53,7 @@ static PyObject* THNPStream_pynew(
   c10::backend::NPUStream stream = (stream_id || device_index || device_type)
       ? c10::backend::NPUStream::unpack3(
             stream_id, device_index, static_cast<c10::DeviceType>(device_type))
-      : c10::backend::getStreamFromPool(false);
+      : c10::backend::getStreamFromPool(priority);
 
   THNPStream* self = (THNPStream*)ptr.get();
   self->stream_id = static_cast<int64_t>(stream.id());
@@ -84,13 +84,15 @@ static PyObject* THNPStream_get_npu_stream(THNPStream* self, void* unused) {
 
 static PyObject* THNPStream_get_priority(THNPStream* self, void* unused) {
   HANDLE_TH_ERRORS
-  TORCH_CHECK(false, "NPU dose not support Stream.get_priority() currently.");
+  return THPUtils_packInt64(self->npu_stream.priority());
   END_HANDLE_TH_ERRORS
 }
 
 static PyObject* THNPStream_priority_range() {
   HANDLE_TH_ERRORS
-  TORCH_CHECK(false, "NPU does not support Stream.priority_range() currently.");
+  auto [least_priority, greatest_priority] =
+      c10::backend::NPUStream::priority_range();
+  return Py_BuildValue("(ii)", least_priority, greatest_priority);
   END_HANDLE_TH_ERRORS
 }
 
@@ -293,6 +295,60 @@ PyObject* THPModule_getDefaultStream_wrap(
   END_HANDLE_TH_ERRORS
 }
 
+PyObject* THPModule_reserveWorkloadStreams_wrap(
+    PyObject* /* unused */,
+    PyObject* args) {
+  HANDLE_TH_ERRORS
+  const char* workload = nullptr;
+  int count = 0;
+  int is_high_priority = 0;
+  if (!PyArg_ParseTuple(args, "sip", &workload, &count, &is_high_priority)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "_reserve_workload_streams",
+        1,
+        "(str workload, int count, bool is_high_priority);");
+    return nullptr;
+  }
+  c10::backend::reserveWorkloadStreams(
+      workload, count, static_cast<bool>(is_high_priority));
+  Py_RETURN_NONE;
+  END_HANDLE_TH_ERRORS
+}
+
+PyObject* THPModule_getStreamForWorkload_wrap(
+    PyObject* /* unused */,
+    PyObject* args) {
+  HANDLE_TH_ERRORS
+  const char* workload = nullptr;
+  int device = -1;
+  if (!PyArg_ParseTuple(args, "si", &workload, &device)) {
+    THPUtils_invalidArguments(
+        args,
+        nullptr,
+        "_get_stream_for_workload",
+        1,
+        "(str workload, int device);");
+    return nullptr;
+  }
+  auto stream = c10::backend::getStreamForWorkload(
+      workload, static_cast<c10::DeviceIndex>(device));
+  PyObject* output_tuple = PyTuple_New(3);
+  PyTuple_SetItem(
+      output_tuple, 0, THPUtils_packInt64(static_cast<int64_t>(stream.id())));
+  PyTuple_SetItem(
+      output_tuple,
+      1,
+      THPUtils_packInt64(static_cast<int64_t>(stream.device_index())));
+  PyTuple_SetItem(
+      output_tuple,
+      2,
+      THPUtils_packInt64(static_cast<int64_t>(stream.device_type())));
+  return output_tuple;
+  END_HANDLE_TH_ERRORS
+}
+
 PyObject* THPModule_setStream_wrap(
     PyObject* self,
     PyObject* args,
@@ -342,6 +398,14 @@ static struct PyMethodDef THPModule_methods[] = {
      (PyCFunction)THPModule_setStream_wrap,
      METH_VARARGS | METH_KEYWORDS,
      nullptr},
+    {"_reserveWorkloadStreams",
+     (PyCFunction)THPModule_reserveWorkloadStreams_wrap,
+     METH_VARARGS,
+     nullptr},
+    {"_getStreamForWorkload",
+     (PyCFunction)THPModule_getStreamForWorkload_wrap,
+     METH_VARARGS,
+     nullptr},
     {nullptr}};
 
 PyMethodDef* python_functions() {